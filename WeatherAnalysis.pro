@@ -1,4 +1,4 @@
-QT       += core gui network sql charts
+QT       += core gui network sql charts concurrent svg
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -11,13 +11,27 @@ SOURCES += \
     src/main.cpp \
     src/mainwindow.cpp \
     src/database/databasemanager.cpp \
+    src/database/databasewriter.cpp \
+    src/database/retentionmanager.cpp \
     src/network/networkmanager.cpp \
     src/config/configmanager.cpp \
     src/models/citymodel.cpp \
     src/models/cityfiltermodel.cpp \
+    src/models/citypagemodel.cpp \
     src/services/cityservice.cpp \
     src/services/weatherservice.cpp \
+    src/services/weatherstore.cpp \
+    src/services/weatherrollup.cpp \
+    src/services/asyncdataservice.cpp \
+    src/services/citydirectory.cpp \
+    src/services/historytileloader.cpp \
     src/workers/weatherworker.cpp \
+    src/workers/refreshscheduler.cpp \
+    src/workers/cityprefetcher.cpp \
+    src/workers/cityimporter.cpp \
+    src/workers/reportrenderer.cpp \
+    src/workers/eventloopmonitor.cpp \
+    src/workers/benchmarkrunner.cpp \
     src/views/citywidget.cpp \
     src/views/currentweatherwidget.cpp \
     src/views/forecastwidget.cpp \
@@ -27,19 +41,36 @@ SOURCES += \
     src/views/alertwidget.cpp \
     src/views/aboutwidget.cpp \
     src/views/historywidget.cpp \
-    src/utils/dataexporter.cpp
+    src/utils/dataexporter.cpp \
+    src/utils/pinyinutil.cpp \
+    src/utils/fuzzymatcher.cpp \
+    src/utils/downsampler.cpp
 
 HEADERS += \
     src/mainwindow.h \
     src/database/databasemanager.h \
+    src/database/databasewriter.h \
+    src/database/retentionmanager.h \
     src/network/networkmanager.h \
     src/config/configmanager.h \
     src/models/citymodel.h \
     src/models/cityfiltermodel.h \
+    src/models/citypagemodel.h \
     src/models/weatherdata.h \
     src/services/cityservice.h \
     src/services/weatherservice.h \
+    src/services/weatherstore.h \
+    src/services/weatherrollup.h \
+    src/services/asyncdataservice.h \
+    src/services/citydirectory.h \
+    src/services/historytileloader.h \
     src/workers/weatherworker.h \
+    src/workers/refreshscheduler.h \
+    src/workers/cityprefetcher.h \
+    src/workers/cityimporter.h \
+    src/workers/reportrenderer.h \
+    src/workers/eventloopmonitor.h \
+    src/workers/benchmarkrunner.h \
     src/views/citywidget.h \
     src/views/currentweatherwidget.h \
     src/views/forecastwidget.h \
@@ -49,7 +80,10 @@ HEADERS += \
     src/views/alertwidget.h \
     src/views/aboutwidget.h \
     src/views/historywidget.h \
-    src/utils/dataexporter.h
+    src/utils/dataexporter.h \
+    src/utils/pinyinutil.h \
+    src/utils/fuzzymatcher.h \
+    src/utils/downsampler.h
 
 FORMS += \
     src/mainwindow.ui \
@@ -14,6 +14,12 @@ const QString ConfigManager::KEY_THEME_MODE = "appearance/theme";
 const QString ConfigManager::KEY_ICON_STYLE = "appearance/iconStyle";
 const QString ConfigManager::KEY_AUTO_REFRESH = "general/autoRefreshInterval";
 const QString ConfigManager::KEY_CURRENT_CITY = "general/currentCityId";
+const QString ConfigManager::KEY_DB_JOURNAL_MODE = "database/journalMode";
+const QString ConfigManager::KEY_DB_SYNCHRONOUS = "database/synchronous";
+const QString ConfigManager::KEY_DB_MMAP_SIZE = "database/mmapSizeMB";
+const QString ConfigManager::KEY_DB_CACHE_SIZE = "database/cacheSizeMB";
+const QString ConfigManager::KEY_DB_TEMP_STORE_MEMORY = "database/tempStoreMemory";
+const QString ConfigManager::KEY_DB_MAINTENANCE_INTERVAL = "database/maintenanceInterval";
 
 ConfigManager::ConfigManager(QObject *parent)
     : QObject(parent)
@@ -155,6 +161,31 @@ void ConfigManager::setCurrentCityId(const QString &cityId)
     emit configChanged(KEY_CURRENT_CITY);
 }
 
+// 数据库性能参数
+DatabaseProfile ConfigManager::databaseProfile() const
+{
+    DatabaseProfile defaults;
+    DatabaseProfile profile;
+    profile.journalMode = m_settings->value(KEY_DB_JOURNAL_MODE, defaults.journalMode).toString();
+    profile.synchronous = m_settings->value(KEY_DB_SYNCHRONOUS, defaults.synchronous).toString();
+    profile.mmapSizeMB = m_settings->value(KEY_DB_MMAP_SIZE, defaults.mmapSizeMB).toInt();
+    profile.cacheSizeMB = m_settings->value(KEY_DB_CACHE_SIZE, defaults.cacheSizeMB).toInt();
+    profile.tempStoreMemory = m_settings->value(KEY_DB_TEMP_STORE_MEMORY, defaults.tempStoreMemory).toBool();
+    profile.maintenanceInterval = m_settings->value(KEY_DB_MAINTENANCE_INTERVAL, defaults.maintenanceInterval).toInt();
+    return profile;
+}
+
+void ConfigManager::setDatabaseProfile(const DatabaseProfile &profile)
+{
+    m_settings->setValue(KEY_DB_JOURNAL_MODE, profile.journalMode);
+    m_settings->setValue(KEY_DB_SYNCHRONOUS, profile.synchronous);
+    m_settings->setValue(KEY_DB_MMAP_SIZE, profile.mmapSizeMB);
+    m_settings->setValue(KEY_DB_CACHE_SIZE, profile.cacheSizeMB);
+    m_settings->setValue(KEY_DB_TEMP_STORE_MEMORY, profile.tempStoreMemory);
+    m_settings->setValue(KEY_DB_MAINTENANCE_INTERVAL, profile.maintenanceInterval);
+    emit configChanged("database/profile");
+}
+
 // 通用读写
 QVariant ConfigManager::value(const QString &key, const QVariant &defaultValue) const
 {
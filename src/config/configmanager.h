@@ -48,6 +48,19 @@ enum class ThemeMode {
     Dark
 };
 
+/**
+ * @struct DatabaseProfile
+ * @brief SQLite 性能参数
+ */
+struct DatabaseProfile {
+    QString journalMode = "WAL";        // 日志模式: WAL/DELETE/TRUNCATE
+    QString synchronous = "NORMAL";     // 同步级别: OFF/NORMAL/FULL
+    int mmapSizeMB = 256;               // 内存映射大小(MB)，0 表示关闭
+    int cacheSizeMB = 16;               // 每个连接的页缓存大小(MB)
+    bool tempStoreMemory = true;        // 临时表和索引放在内存中
+    int maintenanceInterval = 300;      // 检查点与 optimize 的间隔(秒)
+};
+
 /**
  * @class ConfigManager
  * @brief 配置管理单例类
@@ -92,6 +105,10 @@ public:
     QString currentCityId() const;
     void setCurrentCityId(const QString &cityId);
     
+    // 数据库性能参数
+    DatabaseProfile databaseProfile() const;
+    void setDatabaseProfile(const DatabaseProfile &profile);
+    
     // 通用读写
     QVariant value(const QString &key, const QVariant &defaultValue = QVariant()) const;
     void setValue(const QString &key, const QVariant &value);
@@ -133,6 +150,12 @@ private:
     static const QString KEY_ICON_STYLE;
     static const QString KEY_AUTO_REFRESH;
     static const QString KEY_CURRENT_CITY;
+    static const QString KEY_DB_JOURNAL_MODE;
+    static const QString KEY_DB_SYNCHRONOUS;
+    static const QString KEY_DB_MMAP_SIZE;
+    static const QString KEY_DB_CACHE_SIZE;
+    static const QString KEY_DB_TEMP_STORE_MEMORY;
+    static const QString KEY_DB_MAINTENANCE_INTERVAL;
 };
 
 #endif // CONFIGMANAGER_H
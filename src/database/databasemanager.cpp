@@ -4,18 +4,26 @@
  */
 
 #include "databasemanager.h"
+#include "../utils/pinyinutil.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QStandardPaths>
 #include <QDir>
+#include <QThread>
 #include <QDebug>
 
 const QString DatabaseManager::CONNECTION_NAME = "WeatherAnalysisDB";
+const QString DatabaseManager::PINYIN_VERSION_KEY = "pinyin_table_version";
 
 DatabaseManager::DatabaseManager(QObject *parent)
     : QObject(parent)
     , m_isConnected(false)
+    , m_hasFullTextSearch(false)
+    , m_hasSubstringSearch(false)
+    , m_hasSpatialIndex(false)
+    , m_maintenanceTimer(new QTimer(this))
 {
+    connect(m_maintenanceTimer, &QTimer::timeout, this, &DatabaseManager::runMaintenance);
 }
 
 DatabaseManager::~DatabaseManager()
@@ -47,10 +55,13 @@ bool DatabaseManager::initialize(const QString &dbPath)
     }
     
     qDebug() << "Database path:" << path;
+    m_databasePath = path;
     
     // 创建数据库连接
     m_database = QSqlDatabase::addDatabase("QSQLITE", CONNECTION_NAME);
     m_database.setDatabaseName(path);
+    // 写入线程持有另一个连接，遇到锁时等待而不是立即失败
+    m_database.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
     
     if (!m_database.open()) {
         m_lastError = m_database.lastError().text();
@@ -60,9 +71,20 @@ bool DatabaseManager::initialize(const QString &dbPath)
         return false;
     }
     
-    // 启用外键约束
-    QSqlQuery query(m_database);
-    query.exec("PRAGMA foreign_keys = ON");
+    // 增量回收须在建表前设置，只对新建的数据库文件生效；
+    // 旧文件需执行一次完整 VACUUM 才能切换，这里不自动执行
+    QSqlQuery vacuumQuery(m_database);
+    vacuumQuery.exec("PRAGMA auto_vacuum = INCREMENTAL");
+    if (vacuumQuery.exec("PRAGMA auto_vacuum") && vacuumQuery.next() && vacuumQuery.value(0).toInt() != 2) {
+        qWarning() << "Database was created without incremental auto_vacuum; freed pages will be reused but not returned";
+    }
+    vacuumQuery.finish();
+    
+    // 启用外键约束并应用性能配置
+    m_profile = ConfigManager::instance().databaseProfile();
+    configureConnection(m_database);
+    applyPerformanceProfile();
+    m_mainConnections.readWrite = m_database;
     
     // 创建表
     if (!createTables()) {
@@ -78,16 +100,209 @@ bool DatabaseManager::initialize(const QString &dbPath)
 
 void DatabaseManager::close()
 {
+    m_maintenanceTimer->stop();
     if (m_isConnected) {
-        m_database.close();
+        // 关闭前让 SQLite 根据本次会话的查询更新统计信息
+        QSqlQuery query(m_database);
+        query.exec("PRAGMA optimize");
+        query.finish();
         m_isConnected = false;
     }
-    QSqlDatabase::removeDatabase(CONNECTION_NAME);
+    m_database = QSqlDatabase();
+    m_mainConnections.close();
 }
 
 QSqlDatabase& DatabaseManager::database()
 {
-    return m_database;
+    ConnectionSet *set = connectionSet();
+    if (!set->readWrite.isValid()) {
+        set->readWrite = openThreadConnection(false);
+    }
+    return set->readWrite;
+}
+
+QSqlDatabase& DatabaseManager::readOnlyDatabase()
+{
+    ConnectionSet *set = connectionSet();
+    if (!set->readOnly.isValid()) {
+        set->readOnly = openThreadConnection(true);
+    }
+    return set->readOnly;
+}
+
+DatabaseManager::ConnectionSet *DatabaseManager::connectionSet()
+{
+    if (QThread::currentThread() == thread()) {
+        return &m_mainConnections;
+    }
+    
+    if (!m_threadConnections.hasLocalData()) {
+        // QThreadStorage 在线程退出时删除，连接随之关闭
+        m_threadConnections.setLocalData(new ConnectionSet);
+    }
+    return m_threadConnections.localData();
+}
+
+QSqlDatabase DatabaseManager::openThreadConnection(bool readOnly)
+{
+    QString name = QString("%1_%2_%3")
+                   .arg(CONNECTION_NAME, readOnly ? "ro" : "rw")
+                   .arg(quintptr(QThread::currentThreadId()), 0, 16);
+    
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", name);
+    db.setDatabaseName(m_databasePath);
+    db.setConnectOptions(readOnly ? "QSQLITE_BUSY_TIMEOUT=5000;QSQLITE_OPEN_READONLY"
+                                  : "QSQLITE_BUSY_TIMEOUT=5000");
+    
+    if (!db.open()) {
+        qWarning() << "Failed to open connection" << name << ":" << db.lastError().text();
+        return db;
+    }
+    
+    configureConnection(db);
+    qDebug() << "Opened database connection" << name;
+    return db;
+}
+
+void DatabaseManager::ConnectionSet::close()
+{
+    for (auto *statements : {&readWriteStatements, &readOnlyStatements}) {
+        for (const CachedStatement &statement : std::as_const(*statements)) {
+            delete statement.query;
+        }
+        statements->clear();
+    }
+    
+    // 先释放所有句柄，再移除连接
+    QStringList names;
+    for (QSqlDatabase *db : {&readWrite, &readOnly}) {
+        if (db->isValid()) {
+            names.append(db->connectionName());
+            db->close();
+        }
+        *db = QSqlDatabase();
+    }
+    for (const QString &name : std::as_const(names)) {
+        QSqlDatabase::removeDatabase(name);
+    }
+}
+
+QString DatabaseManager::databasePath() const
+{
+    return m_databasePath;
+}
+
+QSqlQuery *DatabaseManager::cachedQuery(const QString &sql)
+{
+    ConnectionSet *set = connectionSet();
+    return cachedQuery(set, set->readWriteStatements, database(), sql);
+}
+
+QSqlQuery *DatabaseManager::cachedReadQuery(const QString &sql)
+{
+    ConnectionSet *set = connectionSet();
+    return cachedQuery(set, set->readOnlyStatements, readOnlyDatabase(), sql);
+}
+
+QSqlQuery *DatabaseManager::cachedQuery(ConnectionSet *set, QHash<QString, CachedStatement> &cache,
+                                        QSqlDatabase &db, const QString &sql)
+{
+    auto it = cache.find(sql);
+    if (it != cache.end()) {
+        it->lastUsed = ++set->useCounter;
+        return it->query;
+    }
+    
+    // SQL基本都是固定文本，超出上限说明有拼接的动态SQL；只淘汰一条最久未用的语句，
+    // 结果集尚未读完的语句可能仍被调用方持有，跳过。全部活跃时暂时超出上限
+    if (cache.size() >= MAX_CACHED_STATEMENTS) {
+        auto oldest = cache.end();
+        for (auto candidate = cache.begin(); candidate != cache.end(); ++candidate) {
+            if (!candidate->query->isActive()
+                && (oldest == cache.end() || candidate->lastUsed < oldest->lastUsed)) {
+                oldest = candidate;
+            }
+        }
+        if (oldest != cache.end()) {
+            delete oldest->query;
+            cache.erase(oldest);
+        }
+    }
+    
+    QSqlQuery *query = new QSqlQuery(db);
+    if (!query->prepare(sql)) {
+        qWarning() << "Failed to prepare statement:" << query->lastError().text();
+        delete query;
+        return nullptr;
+    }
+    
+    cache.insert(sql, {query, ++set->useCounter});
+    return query;
+}
+
+void DatabaseManager::configureConnection(QSqlDatabase &db) const
+{
+    static const QStringList syncModes = {"OFF", "NORMAL", "FULL", "EXTRA"};
+    QString synchronous = m_profile.synchronous.toUpper();
+    if (!syncModes.contains(synchronous)) {
+        synchronous = "NORMAL";
+    }
+    
+    QSqlQuery query(db);
+    query.exec("PRAGMA foreign_keys = ON");
+    query.exec(QString("PRAGMA synchronous = %1").arg(synchronous));
+    // 负数表示以 KiB 为单位
+    query.exec(QString("PRAGMA cache_size = %1").arg(-qint64(qMax(1, m_profile.cacheSizeMB)) * 1024));
+    query.exec(QString("PRAGMA mmap_size = %1").arg(qint64(qMax(0, m_profile.mmapSizeMB)) * 1024 * 1024));
+    query.exec(QString("PRAGMA temp_store = %1").arg(m_profile.tempStoreMemory ? "MEMORY" : "DEFAULT"));
+}
+
+DatabaseProfile DatabaseManager::performanceProfile() const
+{
+    return m_profile;
+}
+
+void DatabaseManager::runMaintenance()
+{
+    if (!m_isConnected) {
+        return;
+    }
+    
+    QSqlQuery query(m_database);
+    
+    // 被动检查点不阻塞读写，避免 WAL 文件无限增长
+    if (m_profile.journalMode.compare("WAL", Qt::CaseInsensitive) == 0) {
+        if (query.exec("PRAGMA wal_checkpoint(PASSIVE)") && query.next()) {
+            qDebug() << "WAL checkpoint: busy" << query.value(0).toInt()
+                     << "log pages" << query.value(1).toInt()
+                     << "checkpointed" << query.value(2).toInt();
+        }
+        query.finish();
+    }
+    
+    query.exec("PRAGMA optimize");
+}
+
+void DatabaseManager::applyPerformanceProfile()
+{
+    static const QStringList journalModes = {"WAL", "DELETE", "TRUNCATE", "PERSIST"};
+    QString journalMode = m_profile.journalMode.toUpper();
+    if (!journalModes.contains(journalMode)) {
+        journalMode = "WAL";
+    }
+    
+    // 日志模式是数据库级设置，WAL 下读写互不阻塞
+    QSqlQuery query(m_database);
+    if (query.exec(QString("PRAGMA journal_mode = %1").arg(journalMode)) && query.next()) {
+        qDebug() << "Database journal mode:" << query.value(0).toString();
+    } else {
+        qWarning() << "Failed to set journal mode:" << query.lastError().text();
+    }
+    query.finish();
+    
+    if (m_profile.maintenanceInterval > 0) {
+        m_maintenanceTimer->start(m_profile.maintenanceInterval * 1000);
+    }
 }
 
 bool DatabaseManager::isConnected() const
@@ -95,6 +310,21 @@ bool DatabaseManager::isConnected() const
     return m_isConnected;
 }
 
+bool DatabaseManager::hasFullTextSearch() const
+{
+    return m_hasFullTextSearch;
+}
+
+bool DatabaseManager::hasSubstringSearch() const
+{
+    return m_hasSubstringSearch;
+}
+
+bool DatabaseManager::hasSpatialIndex() const
+{
+    return m_hasSpatialIndex;
+}
+
 QString DatabaseManager::lastError() const
 {
     return m_lastError;
@@ -104,11 +334,16 @@ bool DatabaseManager::createTables()
 {
     bool success = true;
     
+    // 城市表的拼音迁移要读写设置表中的读音表版本，设置表先创建
+    success &= createUserSettingsTable();
     success &= createCityTable();
+    success &= createCityFtsTable();
+    success &= createCityTrigramTable();
+    success &= createCitySpatialIndex();
     success &= createWeatherCurrentTable();
     success &= createWeatherForecastTable();
     success &= createWeatherHistoryTable();
-    success &= createUserSettingsTable();
+    success &= createWeatherRollupTable();
     
     return success;
 }
@@ -128,6 +363,8 @@ bool DatabaseManager::createCityTable()
             longitude REAL,
             is_favorite INTEGER DEFAULT 0,
             favorite_order INTEGER DEFAULT 0,
+            pinyin VARCHAR(128),
+            pinyin_initials VARCHAR(32),
             create_time DATETIME DEFAULT CURRENT_TIMESTAMP,
             update_time DATETIME DEFAULT CURRENT_TIMESTAMP
         )
@@ -143,11 +380,270 @@ bool DatabaseManager::createCityTable()
     // 创建索引
     query.exec("CREATE INDEX IF NOT EXISTS idx_city_name ON city(name)");
     query.exec("CREATE INDEX IF NOT EXISTS idx_city_favorite ON city(is_favorite)");
+    // 城市列表按名称键集分页
+    query.exec("CREATE INDEX IF NOT EXISTS idx_city_page ON city(is_favorite, name, id)");
+    
+    migrateCityPinyin();
     
     qDebug() << "City table created successfully";
     return true;
 }
 
+void DatabaseManager::migrateCityPinyin()
+{
+    QSqlQuery query(m_database);
+    
+    // 旧版本创建的城市表没有拼音列
+    bool hasPinyin = false;
+    if (query.exec("PRAGMA table_info(city)")) {
+        while (query.next()) {
+            if (query.value(1).toString() == "pinyin") {
+                hasPinyin = true;
+            }
+        }
+    }
+    if (!hasPinyin) {
+        query.exec("ALTER TABLE city ADD COLUMN pinyin VARCHAR(128)");
+        query.exec("ALTER TABLE city ADD COLUMN pinyin_initials VARCHAR(32)");
+    }
+    
+    // 拼音由程序计算，补齐缺失的行；包含多音字地名的行按当前读音表重算。
+    // 读音表版本变化（如扩充字表）时所有行都重算一次，只更新结果有变化的行
+    const int tableVersion = PinyinUtil::tableVersion();
+    int storedVersion = 0;
+    query.prepare("SELECT setting_value FROM user_settings WHERE setting_key = ?");
+    query.addBindValue(PINYIN_VERSION_KEY);
+    if (query.exec() && query.next()) {
+        storedVersion = query.value(0).toInt();
+    }
+    const bool recomputeAll = storedVersion != tableVersion;
+    
+    QStringList conditions = {"pinyin IS NULL"};
+    const QStringList placeNames = PinyinUtil::placeNames();
+    for (int i = 0; i < placeNames.size(); ++i) {
+        conditions.append("name LIKE ?");
+    }
+    
+    QList<QPair<int, QString>> missing;
+    if (recomputeAll) {
+        query.prepare("SELECT id, name, pinyin FROM city");
+    } else {
+        query.prepare("SELECT id, name, pinyin FROM city WHERE " + conditions.join(" OR "));
+        for (const QString &placeName : placeNames) {
+            query.addBindValue("%" + placeName + "%");
+        }
+    }
+    if (query.exec()) {
+        while (query.next()) {
+            QString name = query.value(1).toString();
+            if (query.value(2).isNull() || query.value(2).toString() != PinyinUtil::fullPinyin(name)) {
+                missing.append({query.value(0).toInt(), name});
+            }
+        }
+    }
+    if (missing.isEmpty() && !recomputeAll) {
+        return;
+    }
+    
+    // 重算结果和新的版本号在同一个事务中提交，中途退出时下次启动会重新计算
+    m_database.transaction();
+    query.prepare("UPDATE city SET pinyin = ?, pinyin_initials = ? WHERE id = ?");
+    for (const auto &row : missing) {
+        query.addBindValue(PinyinUtil::fullPinyin(row.second));
+        query.addBindValue(PinyinUtil::initials(row.second));
+        query.addBindValue(row.first);
+        query.exec();
+    }
+    if (recomputeAll) {
+        query.prepare("INSERT INTO user_settings (setting_key, setting_value, setting_type, description) "
+                      "VALUES (?, ?, 'int', '城市拼音使用的读音表版本') "
+                      "ON CONFLICT(setting_key) DO UPDATE SET setting_value = excluded.setting_value, "
+                      "update_time = CURRENT_TIMESTAMP");
+        query.addBindValue(PINYIN_VERSION_KEY);
+        query.addBindValue(QString::number(tableVersion));
+        query.exec();
+    }
+    m_database.commit();
+    qDebug() << "Filled pinyin for" << missing.size() << "cities, pinyin table version" << tableVersion;
+}
+
+bool DatabaseManager::createCityFtsTable()
+{
+    QSqlQuery query(m_database);
+    
+    bool existed = query.exec("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'city_fts'")
+                   && query.next();
+    
+    // 外部内容表：只存索引，内容取自 city 表，rowid 对应 city.id
+    QString sql = R"(
+        CREATE VIRTUAL TABLE IF NOT EXISTS city_fts USING fts5(
+            name, province, pinyin, pinyin_initials,
+            content = 'city', content_rowid = 'id',
+            prefix = '2 3'
+        )
+    )";
+    
+    if (!query.exec(sql)) {
+        // SQLite 未编译 FTS5，搜索退回 LIKE 查询
+        qWarning() << "FTS5 unavailable, city search falls back to LIKE:" << query.lastError().text();
+        m_hasFullTextSearch = false;
+        return true;
+    }
+    
+    // 触发器保持索引与城市表同步，收藏等其他列的更新不触发
+    QStringList triggers = {
+        R"(CREATE TRIGGER IF NOT EXISTS city_fts_insert AFTER INSERT ON city BEGIN
+            INSERT INTO city_fts (rowid, name, province, pinyin, pinyin_initials)
+            VALUES (new.id, new.name, new.province, new.pinyin, new.pinyin_initials);
+        END)",
+        
+        R"(CREATE TRIGGER IF NOT EXISTS city_fts_delete AFTER DELETE ON city BEGIN
+            INSERT INTO city_fts (city_fts, rowid, name, province, pinyin, pinyin_initials)
+            VALUES ('delete', old.id, old.name, old.province, old.pinyin, old.pinyin_initials);
+        END)",
+        
+        R"(CREATE TRIGGER IF NOT EXISTS city_fts_update
+            AFTER UPDATE OF name, province, pinyin, pinyin_initials ON city BEGIN
+            INSERT INTO city_fts (city_fts, rowid, name, province, pinyin, pinyin_initials)
+            VALUES ('delete', old.id, old.name, old.province, old.pinyin, old.pinyin_initials);
+            INSERT INTO city_fts (rowid, name, province, pinyin, pinyin_initials)
+            VALUES (new.id, new.name, new.province, new.pinyin, new.pinyin_initials);
+        END)"
+    };
+    
+    for (const QString &trigger : triggers) {
+        if (!query.exec(trigger)) {
+            m_lastError = query.lastError().text();
+            qCritical() << "Failed to create city_fts trigger:" << m_lastError;
+            emit errorOccurred(m_lastError);
+            return false;
+        }
+    }
+    
+    // 首次创建时为已有城市建立索引
+    if (!existed) {
+        query.exec("INSERT INTO city_fts (city_fts) VALUES ('rebuild')");
+    }
+    
+    m_hasFullTextSearch = true;
+    qDebug() << "City full-text index created successfully";
+    return true;
+}
+
+bool DatabaseManager::createCityTrigramTable()
+{
+    QSqlQuery query(m_database);
+    
+    bool existed = query.exec("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'city_trigram'")
+                   && query.next();
+    
+    // 按三字组索引，城市名、省份、全拼中间的片段也能走索引匹配
+    QString sql = R"(
+        CREATE VIRTUAL TABLE IF NOT EXISTS city_trigram USING fts5(
+            name, province, pinyin,
+            content = 'city', content_rowid = 'id',
+            tokenize = 'trigram'
+        )
+    )";
+    
+    if (!query.exec(sql)) {
+        qWarning() << "FTS5 trigram unavailable, infix city search disabled:" << query.lastError().text();
+        m_hasSubstringSearch = false;
+        return true;
+    }
+    
+    QStringList triggers = {
+        R"(CREATE TRIGGER IF NOT EXISTS city_trigram_insert AFTER INSERT ON city BEGIN
+            INSERT INTO city_trigram (rowid, name, province, pinyin)
+            VALUES (new.id, new.name, new.province, new.pinyin);
+        END)",
+        
+        R"(CREATE TRIGGER IF NOT EXISTS city_trigram_delete AFTER DELETE ON city BEGIN
+            INSERT INTO city_trigram (city_trigram, rowid, name, province, pinyin)
+            VALUES ('delete', old.id, old.name, old.province, old.pinyin);
+        END)",
+        
+        R"(CREATE TRIGGER IF NOT EXISTS city_trigram_update
+            AFTER UPDATE OF name, province, pinyin ON city BEGIN
+            INSERT INTO city_trigram (city_trigram, rowid, name, province, pinyin)
+            VALUES ('delete', old.id, old.name, old.province, old.pinyin);
+            INSERT INTO city_trigram (rowid, name, province, pinyin)
+            VALUES (new.id, new.name, new.province, new.pinyin);
+        END)"
+    };
+    
+    for (const QString &trigger : triggers) {
+        if (!query.exec(trigger)) {
+            m_lastError = query.lastError().text();
+            qCritical() << "Failed to create city_trigram trigger:" << m_lastError;
+            emit errorOccurred(m_lastError);
+            return false;
+        }
+    }
+    
+    if (!existed) {
+        query.exec("INSERT INTO city_trigram (city_trigram) VALUES ('rebuild')");
+    }
+    
+    m_hasSubstringSearch = true;
+    qDebug() << "City trigram index created successfully";
+    return true;
+}
+
+bool DatabaseManager::createCitySpatialIndex()
+{
+    QSqlQuery query(m_database);
+    
+    bool existed = query.exec("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'city_rtree'")
+                   && query.next();
+    
+    // 每个城市是一个退化为点的矩形，id 对应 city.id
+    if (!query.exec("CREATE VIRTUAL TABLE IF NOT EXISTS city_rtree "
+                    "USING rtree(id, min_lat, max_lat, min_lon, max_lon)")) {
+        qWarning() << "R*Tree unavailable, spatial city queries fall back to range scans:"
+                   << query.lastError().text();
+        m_hasSpatialIndex = false;
+        return true;
+    }
+    
+    // 触发器保持索引与城市表同步，没有坐标的城市不进入索引
+    QStringList triggers = {
+        R"(CREATE TRIGGER IF NOT EXISTS city_rtree_insert AFTER INSERT ON city
+            WHEN new.latitude IS NOT NULL AND new.longitude IS NOT NULL BEGIN
+            INSERT INTO city_rtree VALUES (new.id, new.latitude, new.latitude, new.longitude, new.longitude);
+        END)",
+        
+        R"(CREATE TRIGGER IF NOT EXISTS city_rtree_delete AFTER DELETE ON city BEGIN
+            DELETE FROM city_rtree WHERE id = old.id;
+        END)",
+        
+        R"(CREATE TRIGGER IF NOT EXISTS city_rtree_update AFTER UPDATE OF latitude, longitude ON city BEGIN
+            DELETE FROM city_rtree WHERE id = old.id;
+            INSERT INTO city_rtree SELECT new.id, new.latitude, new.latitude, new.longitude, new.longitude
+            WHERE new.latitude IS NOT NULL AND new.longitude IS NOT NULL;
+        END)"
+    };
+    
+    for (const QString &trigger : triggers) {
+        if (!query.exec(trigger)) {
+            m_lastError = query.lastError().text();
+            qCritical() << "Failed to create city_rtree trigger:" << m_lastError;
+            emit errorOccurred(m_lastError);
+            return false;
+        }
+    }
+    
+    // 首次创建时为已有城市建立索引
+    if (!existed) {
+        query.exec("INSERT INTO city_rtree SELECT id, latitude, latitude, longitude, longitude FROM city "
+                   "WHERE latitude IS NOT NULL AND longitude IS NOT NULL");
+    }
+    
+    m_hasSpatialIndex = true;
+    qDebug() << "City spatial index created successfully";
+    return true;
+}
+
 bool DatabaseManager::createWeatherCurrentTable()
 {
     QSqlQuery query(m_database);
@@ -190,6 +686,11 @@ bool DatabaseManager::createWeatherCurrentTable()
     }
     
     query.exec("CREATE INDEX IF NOT EXISTS idx_weather_current_city ON weather_current(city_id)");
+    // 同一城市同一观测时间只保留一条，供写入时 upsert 使用
+    query.exec("CREATE UNIQUE INDEX IF NOT EXISTS idx_weather_current_city_time "
+               "ON weather_current(city_id, observation_time)");
+    // 保留策略按观测时间查找过期行
+    query.exec("CREATE INDEX IF NOT EXISTS idx_weather_current_time ON weather_current(observation_time)");
     
     qDebug() << "Weather current table created successfully";
     return true;
@@ -236,6 +737,7 @@ bool DatabaseManager::createWeatherForecastTable()
     }
     
     query.exec("CREATE INDEX IF NOT EXISTS idx_forecast_city_date ON weather_forecast(city_id, forecast_date)");
+    query.exec("CREATE INDEX IF NOT EXISTS idx_forecast_date ON weather_forecast(forecast_date)");
     
     qDebug() << "Weather forecast table created successfully";
     return true;
@@ -278,6 +780,53 @@ bool DatabaseManager::createWeatherHistoryTable()
     return true;
 }
 
+bool DatabaseManager::createWeatherRollupTable()
+{
+    QSqlQuery query(m_database);
+    
+    // resolution: 0=小时 1=日 2=周 3=月，主键即按城市/分辨率/指标的时间序列索引
+    QString sql = R"(
+        CREATE TABLE IF NOT EXISTS weather_rollup (
+            city_id VARCHAR(32) NOT NULL,
+            resolution INTEGER NOT NULL,
+            metric VARCHAR(16) NOT NULL,
+            bucket_start DATETIME NOT NULL,
+            min_value REAL,
+            max_value REAL,
+            sum_value REAL,
+            sample_count INTEGER DEFAULT 0,
+            PRIMARY KEY (city_id, resolution, metric, bucket_start)
+        ) WITHOUT ROWID
+    )";
+    
+    if (!query.exec(sql)) {
+        m_lastError = query.lastError().text();
+        qCritical() << "Failed to create weather_rollup table:" << m_lastError;
+        emit errorOccurred(m_lastError);
+        return false;
+    }
+    
+    // 汇总表没有外键（已有数据库无法补加），删除城市时由触发器清理其汇总数据
+    bool triggerExisted = query.exec("SELECT 1 FROM sqlite_master WHERE type = 'trigger' "
+                                     "AND name = 'city_rollup_delete'") && query.next();
+    if (!query.exec(R"(CREATE TRIGGER IF NOT EXISTS city_rollup_delete AFTER DELETE ON city BEGIN
+            DELETE FROM weather_rollup WHERE city_id = old.city_id;
+        END)")) {
+        m_lastError = query.lastError().text();
+        qCritical() << "Failed to create weather_rollup trigger:" << m_lastError;
+        emit errorOccurred(m_lastError);
+        return false;
+    }
+    
+    // 首次创建触发器时清理此前已删除城市遗留的汇总数据
+    if (!triggerExisted) {
+        query.exec("DELETE FROM weather_rollup WHERE city_id NOT IN (SELECT city_id FROM city)");
+    }
+    
+    qDebug() << "Weather rollup table created successfully";
+    return true;
+}
+
 bool DatabaseManager::createUserSettingsTable()
 {
     QSqlQuery query(m_database);
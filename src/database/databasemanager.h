@@ -9,6 +9,11 @@
 #include <QObject>
 #include <QSqlDatabase>
 #include <QString>
+#include <QTimer>
+#include <QHash>
+#include <QSqlQuery>
+#include <QThreadStorage>
+#include "../config/configmanager.h"
 
 /**
  * @class DatabaseManager
@@ -40,11 +45,80 @@ public:
     void close();
     
     /**
-     * @brief 获取数据库连接
+     * @brief 获取当前线程的读写连接
+     * 
+     * Qt SQL 连接不能跨线程使用，每个线程首次调用时打开自己的连接，
+     * 线程退出时自动关闭。主线程使用初始化时打开的主连接。
      * @return QSqlDatabase引用
      */
     QSqlDatabase& database();
     
+    /**
+     * @brief 获取当前线程的只读连接
+     * 
+     * 只读查询使用独立的只读连接，在 WAL 模式下可与写入并行
+     * @return QSqlDatabase引用
+     */
+    QSqlDatabase& readOnlyDatabase();
+    
+    /**
+     * @brief 获取数据库文件路径
+     * @return 初始化时使用的数据库文件路径
+     */
+    QString databasePath() const;
+    
+    /**
+     * @brief 获取当前线程读写连接上缓存的预编译语句
+     * 
+     * 相同SQL只编译一次，之后直接重新绑定参数执行。
+     * 调用方读完结果后应调用 finish() 释放结果集，不要删除返回的对象。
+     * @param sql SQL语句
+     * @return 预编译的查询，编译失败时返回nullptr
+     */
+    QSqlQuery *cachedQuery(const QString &sql);
+    
+    /**
+     * @brief 获取当前线程只读连接上缓存的预编译语句
+     * @param sql 只读SQL语句
+     * @return 预编译的查询，编译失败时返回nullptr
+     */
+    QSqlQuery *cachedReadQuery(const QString &sql);
+    
+    /**
+     * @brief 按性能配置设置连接级参数
+     * 
+     * synchronous、cache_size、mmap_size、temp_store 只对当前连接生效，
+     * 每个新打开的连接（如写入线程）都需要调用
+     * @param db 数据库连接
+     */
+    void configureConnection(QSqlDatabase &db) const;
+    
+    /**
+     * @brief 获取当前使用的性能配置
+     */
+    DatabaseProfile performanceProfile() const;
+    
+    /**
+     * @brief 城市全文索引(FTS5)是否可用
+     * 
+     * SQLite 未编译 FTS5 时为 false，城市搜索退回 LIKE 查询
+     */
+    bool hasFullTextSearch() const;
+    
+    /**
+     * @brief 城市子串索引(FTS5 trigram)是否可用
+     * 
+     * SQLite 低于 3.34 时没有 trigram 分词器，为 false
+     */
+    bool hasSubstringSearch() const;
+    
+    /**
+     * @brief 城市坐标空间索引(R*Tree)是否可用
+     * 
+     * SQLite 未编译 R*Tree 时为 false，空间查询退回城市表的坐标范围扫描
+     */
+    bool hasSpatialIndex() const;
+    
     /**
      * @brief 检查数据库是否已连接
      * @return 连接状态
@@ -70,6 +144,12 @@ signals:
      */
     void errorOccurred(const QString &error);
 
+public slots:
+    /**
+     * @brief 执行定期维护：被动检查点和 PRAGMA optimize
+     */
+    void runMaintenance();
+
 private:
     explicit DatabaseManager(QObject *parent = nullptr);
     ~DatabaseManager();
@@ -78,6 +158,55 @@ private:
     DatabaseManager(const DatabaseManager&) = delete;
     DatabaseManager& operator=(const DatabaseManager&) = delete;
     
+    /**
+     * @struct CachedStatement
+     * @brief 缓存的预编译语句及其最近使用序号
+     */
+    struct CachedStatement {
+        QSqlQuery *query = nullptr;
+        quint64 lastUsed = 0;
+    };
+    
+    /**
+     * @struct ConnectionSet
+     * @brief 单个线程持有的连接及其语句缓存
+     */
+    struct ConnectionSet {
+        QSqlDatabase readWrite;
+        QSqlDatabase readOnly;
+        QHash<QString, CachedStatement> readWriteStatements;
+        QHash<QString, CachedStatement> readOnlyStatements;
+        quint64 useCounter = 0;
+        
+        ~ConnectionSet() { close(); }
+        void close();
+    };
+    
+    /**
+     * @brief 获取当前线程的连接集合
+     */
+    ConnectionSet *connectionSet();
+    
+    /**
+     * @brief 为当前线程打开一个新连接
+     * @param readOnly 是否只读
+     */
+    QSqlDatabase openThreadConnection(bool readOnly);
+    
+    /**
+     * @brief 从语句缓存中取出或编译语句
+     * 
+     * 达到上限时淘汰一条最久未使用且没有未读完结果集的语句，
+     * 调用方仍在使用的句柄不会被删除
+     */
+    QSqlQuery *cachedQuery(ConnectionSet *set, QHash<QString, CachedStatement> &cache,
+                           QSqlDatabase &db, const QString &sql);
+    
+    /**
+     * @brief 设置日志模式等数据库级参数并启动定期维护
+     */
+    void applyPerformanceProfile();
+    
     /**
      * @brief 创建所有数据表
      * @return 创建是否成功
@@ -90,6 +219,29 @@ private:
      */
     bool createCityTable();
     
+    /**
+     * @brief 为旧城市表补充拼音列并填充缺失的拼音，读音表版本变化时重算所有城市的拼音
+     */
+    void migrateCityPinyin();
+    
+    /**
+     * @brief 创建城市全文索引表及同步触发器
+     * @return 创建是否成功（FTS5 不可用不算失败）
+     */
+    bool createCityFtsTable();
+    
+    /**
+     * @brief 创建城市子串索引表(trigram)及同步触发器
+     * @return 创建是否成功（trigram 不可用不算失败）
+     */
+    bool createCityTrigramTable();
+    
+    /**
+     * @brief 创建城市坐标空间索引表及同步触发器
+     * @return 创建是否成功（R*Tree 不可用不算失败）
+     */
+    bool createCitySpatialIndex();
+    
     /**
      * @brief 创建当前天气表
      * @return 创建是否成功
@@ -108,6 +260,12 @@ private:
      */
     bool createWeatherHistoryTable();
     
+    /**
+     * @brief 创建多分辨率汇总表
+     * @return 创建是否成功
+     */
+    bool createWeatherRollupTable();
+    
     /**
      * @brief 创建用户设置表
      * @return 创建是否成功
@@ -116,10 +274,20 @@ private:
 
 private:
     QSqlDatabase m_database;
+    QString m_databasePath;
     QString m_lastError;
     bool m_isConnected;
+    bool m_hasFullTextSearch;
+    bool m_hasSubstringSearch;
+    bool m_hasSpatialIndex;
+    DatabaseProfile m_profile;
+    QTimer *m_maintenanceTimer;
+    ConnectionSet m_mainConnections;                  // 主线程连接，readWrite 即 m_database
+    QThreadStorage<ConnectionSet*> m_threadConnections;  // 其他线程的连接，线程退出时释放
     
     static const QString CONNECTION_NAME;
+    static const QString PINYIN_VERSION_KEY;   // user_settings 中记录读音表版本的键
+    static const int MAX_CACHED_STATEMENTS = 64;
 };
 
 #endif // DATABASEMANAGER_H
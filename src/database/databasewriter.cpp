@@ -0,0 +1,375 @@
+/**
+ * @file databasewriter.cpp
+ * @brief 数据库异步写入线程实现
+ */
+
+#include "databasewriter.h"
+#include "databasemanager.h"
+#include <QSqlError>
+#include <QElapsedTimer>
+#include <QDebug>
+
+// ==================== DatabaseWriteWorker ====================
+
+DatabaseWriteWorker::DatabaseWriteWorker(QObject *parent)
+    : QObject(parent)
+    , m_connectionName("WeatherAnalysisDB_writer")
+{
+}
+
+DatabaseWriteWorker::~DatabaseWriteWorker()
+{
+    close();
+}
+
+void DatabaseWriteWorker::enqueue(const DbWriteBatch &batch)
+{
+    if (batch.isEmpty()) {
+        return;
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    m_queue.enqueue(batch);
+    m_queuedStatements += batch.statements.size();
+    m_stats.queueDepth = m_queuedStatements;
+    m_stats.queuedBatches = m_queue.size();
+    
+    if (m_queuedStatements >= MAX_TRANSACTION_STATEMENTS) {
+        // 积累够一个事务的量，立即提交
+        QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+    } else if (!m_flushScheduled) {
+        // 时间窗口内到达的批次合并到同一个事务
+        m_flushScheduled = true;
+        QMetaObject::invokeMethod(this, "scheduleFlush", Qt::QueuedConnection);
+    }
+}
+
+DbWriterStats DatabaseWriteWorker::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
+
+bool DatabaseWriteWorker::open(const QString &path)
+{
+    if (m_database.isOpen()) {
+        return true;
+    }
+    
+    if (!m_flushTimer) {
+        m_flushTimer = new QTimer(this);
+        m_flushTimer->setSingleShot(true);
+        connect(m_flushTimer, &QTimer::timeout, this, &DatabaseWriteWorker::flush);
+    }
+    
+    // 独立连接，写入时不占用界面线程的连接
+    m_database = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    m_database.setDatabaseName(path);
+    m_database.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+    
+    if (!m_database.open()) {
+        QString error = m_database.lastError().text();
+        qCritical() << "Failed to open writer connection:" << error;
+        emit errorOccurred(error);
+        return false;
+    }
+    
+    // 与主连接使用相同的性能配置
+    DatabaseManager::instance().configureConnection(m_database);
+    
+    qDebug() << "Database writer connection opened";
+    return true;
+}
+
+void DatabaseWriteWorker::close()
+{
+    if (m_flushTimer) {
+        m_flushTimer->stop();
+    }
+    
+    if (m_database.isOpen()) {
+        // 退出前提交所有排队中的写入
+        while (true) {
+            {
+                QMutexLocker locker(&m_mutex);
+                if (m_queue.isEmpty()) {
+                    break;
+                }
+            }
+            flush();
+        }
+    }
+    
+    qDeleteAll(m_queryCache);
+    m_queryCache.clear();
+    
+    if (m_database.isOpen()) {
+        m_database.close();
+    }
+    m_database = QSqlDatabase();
+    if (QSqlDatabase::contains(m_connectionName)) {
+        QSqlDatabase::removeDatabase(m_connectionName);
+    }
+}
+
+void DatabaseWriteWorker::scheduleFlush()
+{
+    if (m_flushTimer && !m_flushTimer->isActive()) {
+        m_flushTimer->start(FLUSH_INTERVAL_MS);
+    }
+}
+
+void DatabaseWriteWorker::flush()
+{
+    if (m_flushTimer) {
+        m_flushTimer->stop();
+    }
+    
+    // 取出一个事务的批次，批次本身不会被拆分
+    QList<DbWriteBatch> batches;
+    int statementCount = 0;
+    bool more = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        while (!m_queue.isEmpty()) {
+            int size = m_queue.head().statements.size();
+            if (!batches.isEmpty() && statementCount + size > MAX_TRANSACTION_STATEMENTS) {
+                break;
+            }
+            batches.append(m_queue.dequeue());
+            statementCount += size;
+        }
+        m_queuedStatements -= statementCount;
+        m_stats.queueDepth = m_queuedStatements;
+        m_stats.queuedBatches = m_queue.size();
+        more = !m_queue.isEmpty();
+        m_flushScheduled = more;
+    }
+    
+    if (batches.isEmpty()) {
+        return;
+    }
+    
+    if (!m_database.isOpen()) {
+        qWarning() << "Database writer not open, dropping" << batches.size() << "batches";
+        QMutexLocker locker(&m_mutex);
+        m_stats.failedBatches += batches.size();
+        return;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    QList<bool> results;
+    results.reserve(batches.size());
+    
+    if (!m_database.transaction()) {
+        QString error = m_database.lastError().text();
+        qWarning() << "Failed to begin write transaction:" << error;
+        emit errorOccurred(error);
+        for (int i = 0; i < batches.size(); ++i) {
+            results.append(false);
+        }
+    } else {
+        QSqlQuery savepoint(m_database);
+        for (const DbWriteBatch &batch : std::as_const(batches)) {
+            // 每个批次用保存点隔离，一个批次失败不影响同事务中的其他批次
+            savepoint.exec("SAVEPOINT write_batch");
+            bool ok = executeBatch(batch);
+            if (!ok) {
+                savepoint.exec("ROLLBACK TO write_batch");
+            }
+            savepoint.exec("RELEASE write_batch");
+            results.append(ok);
+        }
+        
+        if (!m_database.commit()) {
+            QString error = m_database.lastError().text();
+            qWarning() << "Failed to commit write transaction:" << error;
+            emit errorOccurred(error);
+            m_database.rollback();
+            for (bool &ok : results) {
+                ok = false;
+            }
+        }
+    }
+    
+    double elapsedMs = timer.nsecsElapsed() / 1000000.0;
+    
+    int succeeded = 0;
+    int succeededStatements = 0;
+    for (int i = 0; i < batches.size(); ++i) {
+        if (results.at(i)) {
+            succeeded++;
+            succeededStatements += batches.at(i).statements.size();
+        }
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stats.failedBatches += batches.size() - succeeded;
+    }
+    recordCommit(elapsedMs, succeeded, succeededStatements);
+    
+    for (int i = 0; i < batches.size(); ++i) {
+        emit batchCommitted(batches.at(i).tag, results.at(i));
+    }
+    
+    if (more) {
+        QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+    }
+}
+
+QSqlQuery *DatabaseWriteWorker::preparedQuery(const QString &sql)
+{
+    // 相同SQL复用已准备好的语句，避免重复解析
+    auto it = m_queryCache.constFind(sql);
+    if (it != m_queryCache.constEnd()) {
+        return it.value();
+    }
+    
+    QSqlQuery *query = new QSqlQuery(m_database);
+    if (!query->prepare(sql)) {
+        QString error = query->lastError().text();
+        qWarning() << "Failed to prepare statement:" << error << sql;
+        emit errorOccurred(error);
+        delete query;
+        return nullptr;
+    }
+    m_queryCache.insert(sql, query);
+    return query;
+}
+
+bool DatabaseWriteWorker::executeBatch(const DbWriteBatch &batch)
+{
+    for (const DbStatement &statement : batch.statements) {
+        QSqlQuery *query = preparedQuery(statement.sql);
+        if (!query) {
+            return false;
+        }
+        
+        for (int i = 0; i < statement.values.size(); ++i) {
+            query->bindValue(i, statement.values.at(i));
+        }
+        
+        if (!query->exec()) {
+            QString error = query->lastError().text();
+            qWarning() << "Write batch" << batch.tag << "failed:" << error;
+            emit errorOccurred(error);
+            query->finish();
+            return false;
+        }
+        // 返回结果行的语句需要逐行执行完，否则 finish 会中途结束
+        while (query->isSelect() && query->next()) {
+        }
+        query->finish();
+    }
+    return true;
+}
+
+void DatabaseWriteWorker::recordCommit(double elapsedMs, int batches, int statements)
+{
+    QMutexLocker locker(&m_mutex);
+    m_stats.transactions++;
+    m_stats.committedBatches += batches;
+    m_stats.committedStatements += statements;
+    m_stats.lastCommitMs = elapsedMs;
+    m_stats.maxCommitMs = qMax(m_stats.maxCommitMs, elapsedMs);
+    m_stats.avgCommitMs += (elapsedMs - m_stats.avgCommitMs) / m_stats.transactions;
+}
+
+// ==================== DatabaseWriter ====================
+
+DatabaseWriter::DatabaseWriter(QObject *parent)
+    : QObject(parent)
+    , m_writerThread(new QThread(this))
+    , m_worker(new DatabaseWriteWorker())
+{
+    m_worker->moveToThread(m_writerThread);
+    
+    connect(m_worker, &DatabaseWriteWorker::batchCommitted,
+            this, &DatabaseWriter::batchCommitted);
+    connect(m_worker, &DatabaseWriteWorker::errorOccurred,
+            this, &DatabaseWriter::errorOccurred);
+    
+    connect(m_writerThread, &QThread::finished, m_worker, &QObject::deleteLater);
+    
+    m_writerThread->setObjectName("DatabaseWriter");
+    m_writerThread->start();
+}
+
+DatabaseWriter::~DatabaseWriter()
+{
+    stop();
+    m_writerThread->quit();
+    m_writerThread->wait();
+}
+
+DatabaseWriter& DatabaseWriter::instance()
+{
+    static DatabaseWriter instance;
+    return instance;
+}
+
+bool DatabaseWriter::start(const QString &path)
+{
+    if (m_running) {
+        return true;
+    }
+    
+    bool ok = false;
+    QMetaObject::invokeMethod(m_worker, "open", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(bool, ok), Q_ARG(QString, path));
+    m_running = ok;
+    return ok;
+}
+
+void DatabaseWriter::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    
+    // 阻塞等待剩余批次提交，保证退出时不丢数据
+    QMetaObject::invokeMethod(m_worker, "close", Qt::BlockingQueuedConnection);
+    m_running = false;
+    
+    DbWriterStats s = m_worker->stats();
+    qDebug() << "Database writer stopped:" << s.committedBatches << "batches,"
+             << s.transactions << "transactions, avg commit" << s.avgCommitMs << "ms";
+}
+
+bool DatabaseWriter::isRunning() const
+{
+    return m_running;
+}
+
+void DatabaseWriter::submit(const DbWriteBatch &batch)
+{
+    if (!m_running) {
+        qWarning() << "Database writer not running, batch dropped:" << batch.tag;
+        return;
+    }
+    m_worker->enqueue(batch);
+}
+
+void DatabaseWriter::submit(const QString &sql, const QVariantList &values)
+{
+    DbWriteBatch batch;
+    batch.add(sql, values);
+    submit(batch);
+}
+
+void DatabaseWriter::flush()
+{
+    QMetaObject::invokeMethod(m_worker, "flush", Qt::QueuedConnection);
+}
+
+int DatabaseWriter::queueDepth() const
+{
+    return m_worker->stats().queueDepth;
+}
+
+DbWriterStats DatabaseWriter::stats() const
+{
+    return m_worker->stats();
+}
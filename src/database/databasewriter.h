@@ -0,0 +1,199 @@
+/**
+ * @file databasewriter.h
+ * @brief 数据库异步写入线程
+ */
+
+#ifndef DATABASEWRITER_H
+#define DATABASEWRITER_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QQueue>
+#include <QHash>
+#include <QTimer>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QVariantList>
+
+/**
+ * @struct DbStatement
+ * @brief 单条写语句（SQL + 位置参数）
+ */
+struct DbStatement {
+    QString sql;
+    QVariantList values;
+};
+
+/**
+ * @struct DbWriteBatch
+ * @brief 写入批次
+ * 
+ * 同一批次内的语句总是在同一个事务中提交，要么全部成功要么全部回滚
+ */
+struct DbWriteBatch {
+    QString tag;                    // 批次标识，用于日志和完成通知
+    QList<DbStatement> statements;
+    
+    void add(const QString &sql, const QVariantList &values = QVariantList()) {
+        statements.append({sql, values});
+    }
+    
+    bool isEmpty() const { return statements.isEmpty(); }
+};
+
+/**
+ * @struct DbWriterStats
+ * @brief 写入线程统计
+ */
+struct DbWriterStats {
+    int queueDepth = 0;             // 排队中的语句数
+    int queuedBatches = 0;          // 排队中的批次数
+    qint64 committedBatches = 0;
+    qint64 committedStatements = 0;
+    qint64 failedBatches = 0;
+    qint64 transactions = 0;
+    double lastCommitMs = 0;        // 最近一次事务耗时
+    double avgCommitMs = 0;
+    double maxCommitMs = 0;
+};
+
+/**
+ * @class DatabaseWriteWorker
+ * @brief 写入线程中的工作对象
+ * 
+ * 持有独立的数据库连接，把排队的批次按数量或时间窗口合并成事务提交
+ */
+class DatabaseWriteWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DatabaseWriteWorker(QObject *parent = nullptr);
+    ~DatabaseWriteWorker();
+    
+    /**
+     * @brief 添加写入批次（线程安全）
+     */
+    void enqueue(const DbWriteBatch &batch);
+    
+    /**
+     * @brief 获取统计信息（线程安全）
+     */
+    DbWriterStats stats() const;
+
+public slots:
+    /**
+     * @brief 打开写入连接
+     * @param path 数据库文件路径
+     */
+    bool open(const QString &path);
+    
+    /**
+     * @brief 提交剩余批次并关闭连接
+     */
+    void close();
+    
+    /**
+     * @brief 立即提交排队中的批次
+     */
+    void flush();
+
+private slots:
+    void scheduleFlush();
+
+signals:
+    void batchCommitted(const QString &tag, bool success);
+    void errorOccurred(const QString &error);
+
+private:
+    QSqlQuery *preparedQuery(const QString &sql);
+    bool executeBatch(const DbWriteBatch &batch);
+    void recordCommit(double elapsedMs, int batches, int statements);
+    
+    QSqlDatabase m_database;
+    QString m_connectionName;
+    QTimer *m_flushTimer = nullptr;
+    QHash<QString, QSqlQuery*> m_queryCache;
+    
+    QQueue<DbWriteBatch> m_queue;
+    int m_queuedStatements = 0;
+    bool m_flushScheduled = false;
+    DbWriterStats m_stats;
+    mutable QMutex m_mutex;
+    
+    static const int MAX_TRANSACTION_STATEMENTS = 500;
+    static const int FLUSH_INTERVAL_MS = 200;
+};
+
+/**
+ * @class DatabaseWriter
+ * @brief 数据库写入线程控制器
+ * 
+ * 界面线程和工作线程通过 submit() 提交写入后立即返回，不会因SQLite写入而阻塞
+ */
+class DatabaseWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    static DatabaseWriter& instance();
+    
+    /**
+     * @brief 启动写入线程
+     * @param path 数据库文件路径
+     */
+    bool start(const QString &path);
+    
+    /**
+     * @brief 提交剩余写入并停止线程
+     */
+    void stop();
+    
+    /**
+     * @brief 写入线程是否在运行
+     */
+    bool isRunning() const;
+    
+    /**
+     * @brief 提交写入批次
+     */
+    void submit(const DbWriteBatch &batch);
+    
+    /**
+     * @brief 提交单条写语句
+     */
+    void submit(const QString &sql, const QVariantList &values = QVariantList());
+    
+    /**
+     * @brief 请求尽快提交排队中的批次
+     */
+    void flush();
+    
+    /**
+     * @brief 获取排队中的语句数
+     */
+    int queueDepth() const;
+    
+    /**
+     * @brief 获取统计信息
+     */
+    DbWriterStats stats() const;
+
+signals:
+    void batchCommitted(const QString &tag, bool success);
+    void errorOccurred(const QString &error);
+
+private:
+    explicit DatabaseWriter(QObject *parent = nullptr);
+    ~DatabaseWriter();
+    
+    DatabaseWriter(const DatabaseWriter&) = delete;
+    DatabaseWriter& operator=(const DatabaseWriter&) = delete;
+    
+    QThread *m_writerThread;
+    DatabaseWriteWorker *m_worker;
+    bool m_running = false;
+};
+
+#endif // DATABASEWRITER_H
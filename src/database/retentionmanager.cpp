@@ -0,0 +1,283 @@
+/**
+ * @file retentionmanager.cpp
+ * @brief 天气数据保留策略与空间回收实现
+ */
+
+#include "retentionmanager.h"
+#include "databasemanager.h"
+#include "databasewriter.h"
+#include "../config/configmanager.h"
+#include "../services/asyncdataservice.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+RetentionManager::RetentionManager(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &RetentionManager::onTimeout);
+    loadSizeHistory();
+}
+
+RetentionManager& RetentionManager::instance()
+{
+    static RetentionManager instance;
+    return instance;
+}
+
+void RetentionManager::start()
+{
+    // 启动后稍等片刻再清理，避开启动时的加载高峰
+    m_running = true;
+    m_timer->start(BACKLOG_INTERVAL_MS * 15);
+}
+
+void RetentionManager::stop()
+{
+    m_running = false;
+    m_timer->stop();
+}
+
+QList<RetentionPolicy> RetentionManager::policies() const
+{
+    // 原始观测和预报按天数保留，汇总表和历史表永久保留
+    QList<RetentionPolicy> defaults = {
+        {"current", "weather_current", "observation_time", QString(), 30},
+        {"hourlyForecast", "weather_forecast", "forecast_date", "forecast_hour >= 0", 7},
+        {"dailyForecast", "weather_forecast", "forecast_date", "forecast_hour < 0", 30},
+    };
+    
+    ConfigManager &config = ConfigManager::instance();
+    for (RetentionPolicy &policy : defaults) {
+        policy.keepDays = config.value(QString("retention/%1Days").arg(policy.name), policy.keepDays).toInt();
+    }
+    return defaults;
+}
+
+QList<DbSizeSample> RetentionManager::sizeHistory() const
+{
+    return m_sizeHistory;
+}
+
+qint64 RetentionManager::growthPerDay() const
+{
+    if (m_sizeHistory.size() < 2) {
+        return 0;
+    }
+    
+    // 以已用空间（总大小减空闲页）计算，避免空间回收造成的波动
+    const DbSizeSample &first = m_sizeHistory.first();
+    const DbSizeSample &last = m_sizeHistory.last();
+    qint64 secs = first.time.secsTo(last.time);
+    if (secs <= 0) {
+        return 0;
+    }
+    
+    qint64 used = (last.totalBytes - last.freeBytes) - (first.totalBytes - first.freeBytes);
+    return used * 86400 / secs;
+}
+
+void RetentionManager::onTimeout()
+{
+    if (!DatabaseManager::instance().isConnected() || !DatabaseWriter::instance().isRunning()) {
+        m_timer->start(IDLE_INTERVAL_MS);
+        return;
+    }
+    
+    // 配置在主线程读取，过期行和空闲页的探测放到数据库线程
+    QList<RetentionPolicy> active;
+    QStringList cutoffs;
+    for (const RetentionPolicy &policy : policies()) {
+        if (policy.keepDays <= 0) {
+            continue;
+        }
+        
+        QDateTime cutoffTime = QDateTime::currentDateTime().addDays(-policy.keepDays);
+        active.append(policy);
+        cutoffs.append(policy.timeColumn == "forecast_date"
+                       ? cutoffTime.date().toString("yyyy-MM-dd")
+                       : cutoffTime.toString("yyyy-MM-dd hh:mm:ss"));
+    }
+    
+    bool needSample = m_sizeHistory.isEmpty()
+        || m_sizeHistory.last().time.secsTo(QDateTime::currentDateTime()) >= SAMPLE_INTERVAL_SECS;
+    
+    AsyncDataService::instance().retentionScan(active, cutoffs, needSample)
+        .then(this, [this, active, cutoffs](const RetentionScan &scan) {
+            applyScan(active, cutoffs, scan);
+        });
+}
+
+void RetentionManager::applyScan(const QList<RetentionPolicy> &policies, const QStringList &cutoffs,
+                                 const RetentionScan &scan)
+{
+    if (!m_running) {
+        return;
+    }
+    
+    bool backlog = false;
+    for (int i = 0; i < policies.size(); ++i) {
+        if (scan.expired.value(i)) {
+            prune(policies[i], cutoffs[i]);
+            backlog = true;
+        }
+    }
+    
+    if (scan.freePages > 0) {
+        reclaimSpace(scan.freePages);
+    }
+    if (scan.size.time.isValid()) {
+        recordSizeSample(scan.size);
+    }
+    
+    m_timer->start(backlog ? BACKLOG_INTERVAL_MS : IDLE_INTERVAL_MS);
+}
+
+RetentionScan RetentionManager::scan(const QList<RetentionPolicy> &policies, const QStringList &cutoffs,
+                                     bool sampleSize)
+{
+    RetentionScan result;
+    if (!DatabaseManager::instance().isConnected()) {
+        return result;
+    }
+    
+    for (int i = 0; i < policies.size(); ++i) {
+        result.expired.append(hasExpiredRows(policies[i], cutoffs.value(i)));
+    }
+    
+    // 旧数据库文件在创建时未启用增量回收，只能等待用户手动整理
+    QSqlQuery query(DatabaseManager::instance().readOnlyDatabase());
+    if (query.exec("PRAGMA auto_vacuum") && query.next() && query.value(0).toInt() == 2) {
+        query.finish();
+        if (query.exec("PRAGMA freelist_count") && query.next()) {
+            result.freePages = query.value(0).toInt();
+        }
+    }
+    query.finish();
+    
+    if (sampleSize) {
+        result.size = RetentionManager::sampleSize();
+    }
+    return result;
+}
+
+QString RetentionManager::expiredCondition(const RetentionPolicy &policy)
+{
+    QString condition = QString("%1 < ?").arg(policy.timeColumn);
+    if (!policy.condition.isEmpty()) {
+        condition += " AND " + policy.condition;
+    }
+    return condition;
+}
+
+bool RetentionManager::hasExpiredRows(const RetentionPolicy &policy, const QString &cutoff)
+{
+    // 时间列上有单独的索引，没有过期行时也只读一个索引页
+    QSqlQuery *query = DatabaseManager::instance().cachedReadQuery(
+        QString("SELECT 1 FROM %1 WHERE %2 LIMIT 1").arg(policy.table, expiredCondition(policy)));
+    if (!query) {
+        return false;
+    }
+    
+    query->addBindValue(cutoff);
+    bool found = query->exec() && query->next();
+    query->finish();
+    return found;
+}
+
+void RetentionManager::prune(const RetentionPolicy &policy, const QString &cutoff)
+{
+    // 每批只删除有限行数，写事务保持很短
+    DbWriteBatch batch;
+    batch.tag = "retention:" + policy.name;
+    batch.add(QString("DELETE FROM %1 WHERE rowid IN (SELECT rowid FROM %1 WHERE %2 LIMIT %3)")
+              .arg(policy.table, expiredCondition(policy)).arg(PRUNE_BATCH_SIZE),
+              {cutoff});
+    DatabaseWriter::instance().submit(batch);
+}
+
+void RetentionManager::reclaimSpace(int freePages)
+{
+    // incremental_vacuum 每执行一步归还一页，而 QSqlQuery::exec 只执行一步，
+    // 所以按页数重复执行 incremental_vacuum(1)，预编译语句在写入线程中复用
+    DbWriteBatch batch;
+    batch.tag = "retention:vacuum";
+    int pages = qMin(freePages, int(VACUUM_PAGES));
+    for (int i = 0; i < pages; ++i) {
+        batch.add("PRAGMA incremental_vacuum(1)");
+    }
+    DatabaseWriter::instance().submit(batch);
+}
+
+DbSizeSample RetentionManager::sampleSize()
+{
+    QSqlQuery query(DatabaseManager::instance().readOnlyDatabase());
+    
+    qint64 pageSize = 0;
+    qint64 pageCount = 0;
+    qint64 freePages = 0;
+    if (query.exec("PRAGMA page_size") && query.next()) {
+        pageSize = query.value(0).toLongLong();
+    }
+    if (query.exec("PRAGMA page_count") && query.next()) {
+        pageCount = query.value(0).toLongLong();
+    }
+    if (query.exec("PRAGMA freelist_count") && query.next()) {
+        freePages = query.value(0).toLongLong();
+    }
+    query.finish();
+    
+    DbSizeSample sample;
+    if (pageSize <= 0) {
+        return sample;
+    }
+    
+    sample.time = QDateTime::currentDateTime();
+    sample.totalBytes = pageSize * pageCount;
+    sample.freeBytes = pageSize * freePages;
+    return sample;
+}
+
+void RetentionManager::recordSizeSample(const DbSizeSample &sample)
+{
+    m_sizeHistory.append(sample);
+    while (m_sizeHistory.size() > MAX_SIZE_SAMPLES) {
+        m_sizeHistory.removeFirst();
+    }
+    saveSizeHistory();
+    
+    qDebug() << "Database size:" << sample.totalBytes / 1024 << "KB, free"
+             << sample.freeBytes / 1024 << "KB, growth" << growthPerDay() / 1024 << "KB/day";
+    emit sizeSampled(sample);
+}
+
+void RetentionManager::loadSizeHistory()
+{
+    // 格式: 时间戳(秒),总字节数,空闲字节数
+    const QStringList entries = ConfigManager::instance().value("retention/sizeSamples").toStringList();
+    for (const QString &entry : entries) {
+        QStringList parts = entry.split(',');
+        if (parts.size() != 3) {
+            continue;
+        }
+        DbSizeSample sample;
+        sample.time = QDateTime::fromSecsSinceEpoch(parts[0].toLongLong());
+        sample.totalBytes = parts[1].toLongLong();
+        sample.freeBytes = parts[2].toLongLong();
+        m_sizeHistory.append(sample);
+    }
+}
+
+void RetentionManager::saveSizeHistory()
+{
+    QStringList entries;
+    for (const DbSizeSample &sample : std::as_const(m_sizeHistory)) {
+        entries.append(QString("%1,%2,%3")
+                       .arg(sample.time.toSecsSinceEpoch())
+                       .arg(sample.totalBytes)
+                       .arg(sample.freeBytes));
+    }
+    ConfigManager::instance().setValue("retention/sizeSamples", entries);
+}
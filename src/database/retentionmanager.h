@@ -0,0 +1,140 @@
+/**
+ * @file retentionmanager.h
+ * @brief 天气数据保留策略与空间回收
+ */
+
+#ifndef RETENTIONMANAGER_H
+#define RETENTIONMANAGER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QDateTime>
+#include <QList>
+#include <QStringList>
+
+/**
+ * @struct RetentionPolicy
+ * @brief 单张表（或表的一部分）的保留策略
+ */
+struct RetentionPolicy {
+    QString name;           // 策略名，对应配置键 retention/<name>Days
+    QString table;
+    QString timeColumn;     // 判断过期的时间列
+    QString condition;      // 额外过滤条件，可为空
+    int keepDays = 0;       // 保留天数，0 表示永久保留
+};
+
+/**
+ * @struct DbSizeSample
+ * @brief 数据库大小采样
+ */
+struct DbSizeSample {
+    QDateTime time;
+    qint64 totalBytes = 0;  // 文件大小(page_count * page_size)
+    qint64 freeBytes = 0;   // 空闲页大小(freelist_count * page_size)
+};
+
+/**
+ * @struct RetentionScan
+ * @brief 一轮清理前在数据库线程中探测到的状态
+ */
+struct RetentionScan {
+    QList<bool> expired;    // 与传入的策略一一对应，是否有过期行
+    int freePages = -1;     // 空闲页数，未启用增量回收时为 -1
+    DbSizeSample size;      // 未要求采样时 time 无效
+};
+
+/**
+ * @class RetentionManager
+ * @brief 数据保留管理器
+ * 
+ * 按策略在后台分批删除过期数据：
+ * - 每轮每个策略最多删除 PRUNE_BATCH_SIZE 行，通过 DatabaseWriter 提交，不阻塞界面
+ * - 有积压时短间隔连续清理，清理完后回到长间隔
+ * - 通过 PRAGMA incremental_vacuum 分批归还空闲页，从不执行阻塞的完整 VACUUM
+ * - 定期采样数据库大小，记录增长趋势
+ * 
+ * 是否有过期行、空闲页数和大小采样都通过 AsyncDataService 在数据库线程探测，
+ * 主线程只读取配置和提交写入批次。
+ */
+class RetentionManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    static RetentionManager& instance();
+    
+    /**
+     * @brief 启动后台清理
+     */
+    void start();
+    
+    /**
+     * @brief 停止后台清理
+     */
+    void stop();
+    
+    /**
+     * @brief 获取当前生效的保留策略
+     */
+    QList<RetentionPolicy> policies() const;
+    
+    /**
+     * @brief 获取数据库大小采样（按时间先后）
+     */
+    QList<DbSizeSample> sizeHistory() const;
+    
+    /**
+     * @brief 根据采样估算每天的增长字节数
+     */
+    qint64 growthPerDay() const;
+    
+    /**
+     * @brief 探测过期行、空闲页和数据库大小，在调用线程的数据库连接上执行
+     * @param policies 需要检查的策略
+     * @param cutoffs 各策略的过期时间点
+     * @param sampleSize 是否采样数据库大小
+     */
+    static RetentionScan scan(const QList<RetentionPolicy> &policies, const QStringList &cutoffs, bool sampleSize);
+
+signals:
+    /**
+     * @brief 新的数据库大小采样
+     */
+    void sizeSampled(const DbSizeSample &sample);
+
+private slots:
+    void onTimeout();
+
+private:
+    explicit RetentionManager(QObject *parent = nullptr);
+    ~RetentionManager() = default;
+    
+    RetentionManager(const RetentionManager&) = delete;
+    RetentionManager& operator=(const RetentionManager&) = delete;
+    
+    static QString expiredCondition(const RetentionPolicy &policy);
+    static bool hasExpiredRows(const RetentionPolicy &policy, const QString &cutoff);
+    static DbSizeSample sampleSize();
+    
+    void applyScan(const QList<RetentionPolicy> &policies, const QStringList &cutoffs, const RetentionScan &scan);
+    void prune(const RetentionPolicy &policy, const QString &cutoff);
+    void reclaimSpace(int freePages);
+    void recordSizeSample(const DbSizeSample &sample);
+    void loadSizeHistory();
+    void saveSizeHistory();
+
+private:
+    QTimer *m_timer;
+    bool m_running = false;
+    QList<DbSizeSample> m_sizeHistory;
+    
+    static const int PRUNE_BATCH_SIZE = 500;
+    static const int VACUUM_PAGES = 256;           // 每轮最多归还的页数
+    static const int BACKLOG_INTERVAL_MS = 2000;   // 有积压时的清理间隔
+    static const int IDLE_INTERVAL_MS = 600000;    // 无积压时的清理间隔(10分钟)
+    static const int SAMPLE_INTERVAL_SECS = 3600;  // 大小采样间隔
+    static const int MAX_SIZE_SAMPLES = 168;       // 保留一周的小时采样
+};
+
+#endif // RETENTIONMANAGER_H
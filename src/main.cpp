@@ -8,10 +8,19 @@
 #include "mainwindow.h"
 #include "config/configmanager.h"
 #include "services/weatherservice.h"
+#include "workers/reportrenderer.h"
+#include "workers/benchmarkrunner.h"
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
+    // 批量渲染报表和基准测试时不需要窗口系统
+    const bool renderReports = ReportRenderer::isRequested(argc, argv);
+    const bool bench = BenchmarkRunner::isRequested(argc, argv);
+    if (renderReports || bench) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    
     QApplication a(argc, argv);
     
     // 设置应用程序信息
@@ -19,6 +28,13 @@ int main(int argc, char *argv[])
     QApplication::setApplicationVersion("1.0.0");
     QApplication::setOrganizationName("YourOrganization");
     
+    if (renderReports) {
+        return ReportRenderer::run(QApplication::arguments());
+    }
+    if (bench) {
+        return BenchmarkRunner::run(QApplication::arguments());
+    }
+    
     // 加载保存的 API Key
     QString apiKey = ConfigManager::instance().value("api/qweatherKey", "").toString();
     if (!apiKey.isEmpty()) {
@@ -15,10 +15,18 @@
 #include "views/historywidget.h"
 #include "views/alertwidget.h"
 #include "workers/weatherworker.h"
-#include "models/citymodel.h"
+#include "workers/refreshscheduler.h"
+#include "workers/cityprefetcher.h"
+#include "workers/eventloopmonitor.h"
 #include "config/configmanager.h"
+#include "database/databasewriter.h"
+#include "database/retentionmanager.h"
+#include "services/asyncdataservice.h"
+#include "services/citydirectory.h"
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QMessageBox>
+#include <QDebug>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -33,6 +41,11 @@ MainWindow::MainWindow(QWidget *parent)
     , m_historyWidget(nullptr)
     , m_alertWidget(nullptr)
 {
+    // 记录构造期间和之后事件循环被阻塞的时间
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+    EventLoopMonitor::instance().start();
+    
     ui->setupUi(this);
     
     // 初始化数据库
@@ -96,6 +109,12 @@ MainWindow::MainWindow(QWidget *parent)
     // 启动缓存清理定时器
     controller.startCacheCleanTimer();
     
+    // 启动收藏城市后台刷新
+    RefreshScheduler::instance().start();
+    
+    // 预热常用城市的天气缓存
+    CityPrefetcher::instance().warmUp();
+    
     // 默认选中第一项
     ui->navListWidget->setCurrentRow(0);
     
@@ -104,13 +123,40 @@ MainWindow::MainWindow(QWidget *parent)
     
     // 更新状态栏
     updateStatusBar();
+    
+    // 恢复上次查看的城市，先用本地快照显示；数据库线程按提交顺序执行，
+    // 快照恢复完成后才会查询城市是否存在
+    AsyncDataService::instance().restoreWeatherSnapshots();
+    QString lastCityId = ConfigManager::instance().currentCityId();
+    if (!lastCityId.isEmpty()) {
+        AsyncDataService::instance().cityExists(lastCityId).then(this, [this, lastCityId](bool exists) {
+            // 用户已手动选择了其他城市时不再恢复
+            if (exists && m_currentCityId.isEmpty()) {
+                onCitySelected(lastCityId);
+            }
+        });
+    }
+    
+    qDebug() << "Main window constructed in" << startupTimer.elapsed() << "ms";
 }
 
 MainWindow::~MainWindow()
 {
+    EventLoopMonitor::instance().stop();
+    RefreshScheduler::instance().stop();
+    RetentionManager::instance().stop();
+    DatabaseWriter::instance().stop();
     delete ui;
 }
 
+void MainWindow::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::WindowStateChange) {
+        RefreshScheduler::instance().setMinimized(isMinimized());
+    }
+    QMainWindow::changeEvent(event);
+}
+
 bool MainWindow::initDatabase()
 {
     DatabaseManager &dbManager = DatabaseManager::instance();
@@ -119,7 +165,21 @@ bool MainWindow::initDatabase()
         qCritical() << "Database error:" << error;
     });
     
-    return dbManager.initialize();
+    if (!dbManager.initialize()) {
+        return false;
+    }
+    
+    // 启动异步写入线程，后台写入不阻塞界面
+    connect(&DatabaseWriter::instance(), &DatabaseWriter::errorOccurred, this, [](const QString &error) {
+        qCritical() << "Database writer error:" << error;
+    });
+    if (!DatabaseWriter::instance().start(dbManager.databasePath())) {
+        return false;
+    }
+    
+    // 后台按保留策略清理过期数据
+    RetentionManager::instance().start();
+    return true;
 }
 
 void MainWindow::updateStatusBar()
@@ -221,46 +281,8 @@ void MainWindow::setupPages()
     delete oldWidget;
     
     // 连接城市选择信号
-    connect(m_cityWidget, &CityWidget::citySelected, this, [this](const QString &cityId) {
-        m_currentCityId = cityId;
-        // 获取城市名称
-        CityModel model;
-        model.loadFromDatabase();
-        CityInfo city = model.cityById(cityId);
-        m_currentCityName = city.name;
-        
-        // 更新实时天气页面
-        if (m_currentWeatherWidget) {
-            m_currentWeatherWidget->setCity(cityId, m_currentCityName);
-        }
-        
-        // 更新预报页面
-        if (m_forecastWidget) {
-            m_forecastWidget->setCity(cityId, m_currentCityName);
-        }
-        
-        // 更新图表页面
-        if (m_chartWidget) {
-            m_chartWidget->setCity(cityId, m_currentCityName);
-        }
-        
-        // 更新生活指数页面
-        if (m_lifeIndexWidget) {
-            m_lifeIndexWidget->setCity(cityId, m_currentCityName);
-        }
-        
-        // 更新历史记录页面
-        if (m_historyWidget) {
-            m_historyWidget->setCity(cityId, m_currentCityName);
-        }
-        
-        // 请求所有天气数据
-        WeatherThreadController::instance().requestAllWeatherData(cityId);
-        
-        // 切换到实时天气页面
-        ui->navListWidget->setCurrentRow(0);
-        updateStatusBar();
-    });
+    connect(m_cityWidget, &CityWidget::citySelected,
+            this, &MainWindow::onCitySelected);
     
     // 创建设置页面
     m_settingsWidget = new SettingsWidget(this);
@@ -296,6 +318,104 @@ void MainWindow::setupPages()
     delete oldAboutWidget;
 }
 
+void MainWindow::onCitySelected(const QString &cityId)
+{
+    m_currentCityId = cityId;
+    RefreshScheduler::instance().setCurrentCity(cityId);
+    CityPrefetcher::instance().recordCityViewed(cityId);
+    ConfigManager::instance().setCurrentCityId(cityId);
+    
+    // 切换到实时天气页面
+    ui->navListWidget->setCurrentRow(0);
+    
+    // 城市目录命中时立即更新各页面，否则和本地快照一起在数据库线程按顺序读取
+    AsyncDataService &data = AsyncDataService::instance();
+    
+    CityInfo city;
+    if (CityDirectory::instance().lookup(cityId, city)) {
+        applySelectedCity(cityId, city);
+    } else {
+        data.getCity(cityId).then(this, [this, cityId](const CityInfo &city) {
+            // 读取期间用户已切换到其他城市
+            if (cityId != m_currentCityId) {
+                return;
+            }
+            applySelectedCity(cityId, city);
+        });
+    }
+    
+    data.weatherSnapshot(cityId).then(this, [this, cityId](const WeatherSnapshot &snapshot) {
+        if (cityId != m_currentCityId) {
+            return;
+        }
+        
+        // 先显示本地保存的快照，再请求网络数据，避免旧快照覆盖新数据
+        showStoredWeather(snapshot);
+        WeatherThreadController::instance().requestAllWeatherData(cityId);
+    });
+}
+
+void MainWindow::applySelectedCity(const QString &cityId, const CityInfo &city)
+{
+    m_currentCityName = city.name;
+    
+    // 更新实时天气页面
+    if (m_currentWeatherWidget) {
+        m_currentWeatherWidget->setCity(cityId, m_currentCityName);
+    }
+    
+    // 更新预报页面
+    if (m_forecastWidget) {
+        m_forecastWidget->setCity(cityId, m_currentCityName);
+    }
+    
+    // 更新图表页面
+    if (m_chartWidget) {
+        m_chartWidget->setCity(cityId, m_currentCityName);
+    }
+    
+    // 更新生活指数页面
+    if (m_lifeIndexWidget) {
+        m_lifeIndexWidget->setCity(cityId, m_currentCityName);
+    }
+    
+    // 更新历史记录页面
+    if (m_historyWidget) {
+        m_historyWidget->setCity(cityId, m_currentCityName);
+    }
+    
+    updateStatusBar();
+}
+
+void MainWindow::showStoredWeather(const WeatherSnapshot &snapshot)
+{
+    if (snapshot.isEmpty()) {
+        return;
+    }
+    
+    if (snapshot.current.isValid() && m_currentWeatherWidget) {
+        m_currentWeatherWidget->updateWeather(snapshot.current);
+    }
+    
+    if (!snapshot.hourly.isEmpty()) {
+        if (m_forecastWidget) {
+            m_forecastWidget->updateHourlyForecast(snapshot.hourly);
+        }
+        if (m_chartWidget) {
+            m_chartWidget->updateHourlyData(snapshot.hourly);
+        }
+    }
+    
+    if (!snapshot.daily.isEmpty()) {
+        if (m_forecastWidget) {
+            m_forecastWidget->updateDailyForecast(snapshot.daily);
+        }
+        if (m_chartWidget) {
+            m_chartWidget->updateDailyData(snapshot.daily);
+        }
+    }
+}
+
 void MainWindow::applyTheme(ThemeMode theme)
 {
     QString navStyle;
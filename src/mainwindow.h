@@ -23,6 +23,8 @@ class SettingsWidget;
 class AboutWidget;
 class HistoryWidget;
 class AlertWidget;
+struct WeatherSnapshot;
+struct CityInfo;
 
 /**
  * @class MainWindow
@@ -36,6 +38,16 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+protected:
+    void changeEvent(QEvent *event) override;
+
+private slots:
+    /**
+     * @brief 切换当前城市
+     * @param cityId 城市ID
+     */
+    void onCitySelected(const QString &cityId);
+
 private:
     /**
      * @brief 初始化数据库
@@ -57,6 +69,17 @@ private:
      * @brief 应用主题
      */
     void applyTheme(ThemeMode theme);
+    
+    /**
+     * @brief 把选中城市的信息应用到各页面
+     */
+    void applySelectedCity(const QString &cityId, const CityInfo &city);
+    
+    /**
+     * @brief 用本地保存的天气快照填充各页面
+     * @param snapshot 天气快照
+     */
+    void showStoredWeather(const WeatherSnapshot &snapshot);
 
 private:
     Ui::MainWindow *ui;
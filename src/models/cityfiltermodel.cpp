@@ -5,6 +5,7 @@
 
 #include "cityfiltermodel.h"
 #include "citymodel.h"
+#include "../utils/fuzzymatcher.h"
 
 CityFilterModel::CityFilterModel(QObject *parent)
     : QSortFilterProxyModel(parent)
@@ -14,12 +15,48 @@ CityFilterModel::CityFilterModel(QObject *parent)
     setSortCaseSensitivity(Qt::CaseInsensitive);
 }
 
+void CityFilterModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    if (this->sourceModel()) {
+        disconnect(this->sourceModel(), nullptr, this, nullptr);
+    }
+    
+    m_cityModel = qobject_cast<CityModel*>(sourceModel);
+    invalidateMatches();
+    
+    // 先于基类连接，基类重新过滤、排序变化的行时分数表已更新
+    if (sourceModel) {
+        connect(sourceModel, &QAbstractItemModel::modelReset, this, &CityFilterModel::invalidateMatches);
+        connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &CityFilterModel::onSourceRowsInserted);
+        connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, &CityFilterModel::onSourceRowsRemoved);
+        connect(sourceModel, &QAbstractItemModel::dataChanged, this, &CityFilterModel::onSourceDataChanged);
+    }
+    
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+}
+
 void CityFilterModel::setSearchKeyword(const QString &keyword)
 {
-    if (m_searchKeyword != keyword) {
-        m_searchKeyword = keyword.trimmed();
-        invalidateFilter();
+    // 关键词不变但源模型已更新时仍需重算匹配结果
+    QString trimmed = keyword.trimmed();
+    if (m_searchKeyword == trimmed && (m_matchesValid || !m_cityModel || trimmed.isEmpty())) {
+        return;
     }
+    
+    m_searchKeyword = trimmed;
+    m_foldedKeyword = trimmed.toCaseFolded();
+    
+    if (m_cityModel && !m_foldedKeyword.isEmpty()) {
+        const CachedMatch &match = matchRows(m_foldedKeyword);
+        m_rowScores.fill(FuzzyMatcher::NO_MATCH, m_cityModel->rowCount());
+        for (int i = 0; i < match.rows.size(); ++i) {
+            m_rowScores[match.rows[i]] = match.scores[i];
+        }
+        m_matchesValid = true;
+    }
+    
+    // 排序依据随关键词变化，过滤和排序一起重做
+    invalidate();
 }
 
 QString CityFilterModel::searchKeyword() const
@@ -42,46 +79,45 @@ bool CityFilterModel::favoritesOnly() const
 
 bool CityFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
 {
-    QModelIndex nameIndex = sourceModel()->index(sourceRow, CityModel::ColName, sourceParent);
-    QModelIndex provinceIndex = sourceModel()->index(sourceRow, CityModel::ColProvince, sourceParent);
-    QModelIndex favoriteIndex = sourceModel()->index(sourceRow, CityModel::ColIsFavorite, sourceParent);
-    
     // 检查收藏过滤
     if (m_favoritesOnly) {
-        bool isFavorite = sourceModel()->data(favoriteIndex).toBool();
-        if (!isFavorite) {
+        QModelIndex favoriteIndex = sourceModel()->index(sourceRow, CityModel::ColIsFavorite, sourceParent);
+        if (!sourceModel()->data(favoriteIndex).toBool()) {
             return false;
         }
     }
     
     // 如果没有搜索关键词，显示所有（或所有收藏）
-    if (m_searchKeyword.isEmpty()) {
+    if (m_foldedKeyword.isEmpty()) {
         return true;
     }
     
-    // 获取城市名和省份
-    QString cityName = sourceModel()->data(nameIndex).toString();
-    QString province = sourceModel()->data(provinceIndex).toString();
-    
-    // 检查是否匹配
-    if (matchesKeyword(cityName, m_searchKeyword)) {
-        return true;
-    }
-    if (matchesKeyword(province, m_searchKeyword)) {
-        return true;
-    }
-    
-    // 检查拼音首字母匹配
-    QString pinyinInitials = toPinyinInitials(cityName);
-    if (pinyinInitials.contains(m_searchKeyword, Qt::CaseInsensitive)) {
-        return true;
+    if (m_cityModel) {
+        // 关键词变化时已算好匹配的行
+        if (m_matchesValid) {
+            return sourceRow < m_rowScores.size() && m_rowScores[sourceRow] != FuzzyMatcher::NO_MATCH;
+        }
+        // 源模型刚变化，直接对预计算的搜索键打分
+        return m_cityModel->searchKey(sourceRow).score(m_foldedKeyword) != FuzzyMatcher::NO_MATCH;
     }
     
-    return false;
+    QModelIndex nameIndex = sourceModel()->index(sourceRow, CityModel::ColName, sourceParent);
+    QModelIndex provinceIndex = sourceModel()->index(sourceRow, CityModel::ColProvince, sourceParent);
+    return sourceModel()->data(nameIndex).toString().contains(m_searchKeyword, Qt::CaseInsensitive)
+           || sourceModel()->data(provinceIndex).toString().contains(m_searchKeyword, Qt::CaseInsensitive);
 }
 
 bool CityFilterModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
+    // 有关键词时按匹配分数排序，分数高的在前
+    if (m_cityModel && !m_foldedKeyword.isEmpty()) {
+        int leftScore = rankScore(left.row());
+        int rightScore = rankScore(right.row());
+        if (leftScore != rightScore) {
+            return leftScore > rightScore;
+        }
+    }
+    
     // 收藏的城市排在前面
     QModelIndex leftFav = sourceModel()->index(left.row(), CityModel::ColIsFavorite);
     QModelIndex rightFav = sourceModel()->index(right.row(), CityModel::ColIsFavorite);
@@ -104,80 +140,115 @@ bool CityFilterModel::lessThan(const QModelIndex &left, const QModelIndex &right
     return QSortFilterProxyModel::lessThan(left, right);
 }
 
-bool CityFilterModel::matchesKeyword(const QString &text, const QString &keyword) const
+const CityFilterModel::CachedMatch &CityFilterModel::matchRows(const QString &foldedKeyword)
+{
+    // 完全相同的关键词直接返回，并移到最前
+    for (int i = 0; i < m_matchCache.size(); ++i) {
+        if (m_matchCache[i].keyword == foldedKeyword) {
+            m_matchCache.move(i, 0);
+            return m_matchCache.first();
+        }
+    }
+    
+    // 以缓存关键词开头且容错程度不变时只可能匹配其结果中的行，取结果最少的作为候选。
+    // 容错程度随长度放宽，跨过阈值时必须全量重算
+    CachedMatch match;
+    match.keyword = foldedKeyword;
+    match.tolerance = FuzzyMatcher::tolerance(foldedKeyword.size());
+    
+    int baseIndex = -1;
+    for (int i = 0; i < m_matchCache.size(); ++i) {
+        const CachedMatch &cached = m_matchCache[i];
+        if (cached.tolerance == match.tolerance && foldedKeyword.startsWith(cached.keyword)
+            && (baseIndex < 0 || cached.rows.size() < m_matchCache[baseIndex].rows.size())) {
+            baseIndex = i;
+        }
+    }
+    
+    auto test = [&](int row) {
+        int score = m_cityModel->searchKey(row).score(foldedKeyword);
+        if (score != FuzzyMatcher::NO_MATCH) {
+            match.rows.append(row);
+            match.scores.append(score);
+        }
+    };
+    
+    if (baseIndex >= 0) {
+        for (int row : std::as_const(m_matchCache[baseIndex].rows)) {
+            test(row);
+        }
+    } else {
+        int rowCount = m_cityModel->rowCount();
+        for (int row = 0; row < rowCount; ++row) {
+            test(row);
+        }
+    }
+    
+    m_matchCache.prepend(match);
+    while (m_matchCache.size() > MATCH_CACHE_SIZE) {
+        m_matchCache.removeLast();
+    }
+    return m_matchCache.first();
+}
+
+int CityFilterModel::rankScore(int sourceRow) const
 {
-    return text.contains(keyword, Qt::CaseInsensitive);
+    int score = m_matchesValid && sourceRow < m_rowScores.size()
+                ? m_rowScores[sourceRow]
+                : m_cityModel->searchKey(sourceRow).score(m_foldedKeyword);
+    QModelIndex favoriteIndex = m_cityModel->index(sourceRow, CityModel::ColIsFavorite);
+    if (m_cityModel->data(favoriteIndex).toBool()) {
+        score += FAVORITE_BONUS;
+    }
+    return score;
 }
 
-QString CityFilterModel::toPinyinInitials(const QString &chinese) const
+void CityFilterModel::invalidateMatches()
 {
-    // 简化版拼音首字母转换
-    // 实际项目中可以使用完整的拼音库
-    static const QMap<QChar, QChar> pinyinMap = {
-        // 常用城市首字母映射
-        {QChar(0x5317), 'B'}, // 北
-        {QChar(0x4E0A), 'S'}, // 上
-        {QChar(0x5E7F), 'G'}, // 广
-        {QChar(0x6DF1), 'S'}, // 深
-        {QChar(0x5929), 'T'}, // 天
-        {QChar(0x91CD), 'C'}, // 重
-        {QChar(0x6210), 'C'}, // 成
-        {QChar(0x6B66), 'W'}, // 武
-        {QChar(0x897F), 'X'}, // 西
-        {QChar(0x5357), 'N'}, // 南
-        {QChar(0x4E1C), 'D'}, // 东
-        {QChar(0x957F), 'C'}, // 长
-        {QChar(0x676D), 'H'}, // 杭
-        {QChar(0x82CF), 'S'}, // 苏
-        {QChar(0x65E0), 'W'}, // 无
-        {QChar(0x5408), 'H'}, // 合
-        {QChar(0x6D4E), 'J'}, // 济
-        {QChar(0x9752), 'Q'}, // 青
-        {QChar(0x5927), 'D'}, // 大
-        {QChar(0x6C88), 'S'}, // 沈
-        {QChar(0x54C8), 'H'}, // 哈
-        {QChar(0x5170), 'L'}, // 兰
-        {QChar(0x6606), 'K'}, // 昆
-        {QChar(0x8D35), 'G'}, // 贵
-        {QChar(0x592A), 'T'}, // 太
-        {QChar(0x77F3), 'S'}, // 石
-        {QChar(0x90D1), 'Z'}, // 郑
-        {QChar(0x5357), 'N'}, // 南
-        {QChar(0x798F), 'F'}, // 福
-        {QChar(0x53A6), 'X'}, // 厦
-        {QChar(0x6D77), 'H'}, // 海
-        {QChar(0x4E91), 'Y'}, // 云
-        {QChar(0x5B81), 'N'}, // 宁
-        {QChar(0x6E29), 'W'}, // 温
-        {QChar(0x73E0), 'Z'}, // 珠
-        {QChar(0x4F5B), 'F'}, // 佛
-        {QChar(0x4E2D), 'Z'}, // 中
-        {QChar(0x5C71), 'S'}, // 山
-        {QChar(0x6CB3), 'H'}, // 河
-        {QChar(0x6E56), 'H'}, // 湖
-        {QChar(0x6C5F), 'J'}, // 江
-        {QChar(0x5DDE), 'Z'}, // 州
-        {QChar(0x5E02), 'S'}, // 市
-        {QChar(0x533A), 'Q'}, // 区
-        {QChar(0x53BF), 'X'}, // 县
-        {QChar(0x9547), 'Z'}, // 镇
-        {QChar(0x4EAC), 'J'}, // 京
-        {QChar(0x6D25), 'J'}, // 津
-        {QChar(0x5E86), 'Q'}, // 庆
-        {QChar(0x90FD), 'D'}, // 都
-        {QChar(0x6C49), 'H'}, // 汉
-        {QChar(0x5B89), 'A'}, // 安
-        {QChar(0x5DDE), 'Z'}, // 州
-    };
+    // 行号可能已经移动，缓存结果全部作废
+    m_matchCache.clear();
+    m_matchesValid = false;
+}
+
+void CityFilterModel::onSourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent);
+    m_matchCache.clear();
+    if (!m_matchesValid || m_foldedKeyword.isEmpty()) {
+        m_matchesValid = false;
+        return;
+    }
     
-    QString result;
-    for (const QChar &ch : chinese) {
-        if (ch.isLetter() && ch.unicode() < 128) {
-            // ASCII字母直接使用
-            result += ch.toUpper();
-        } else if (pinyinMap.contains(ch)) {
-            result += pinyinMap.value(ch);
-        }
+    QVector<int> scores;
+    scores.reserve(last - first + 1);
+    for (int row = first; row <= last; ++row) {
+        scores.append(m_cityModel->searchKey(row).score(m_foldedKeyword));
+    }
+    m_rowScores.insert(first, scores.size(), FuzzyMatcher::NO_MATCH);
+    std::copy(scores.cbegin(), scores.cend(), m_rowScores.begin() + first);
+}
+
+void CityFilterModel::onSourceRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent);
+    m_matchCache.clear();
+    if (!m_matchesValid || m_foldedKeyword.isEmpty()) {
+        m_matchesValid = false;
+        return;
+    }
+    
+    m_rowScores.remove(first, last - first + 1);
+}
+
+void CityFilterModel::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    m_matchCache.clear();
+    if (!m_matchesValid || m_foldedKeyword.isEmpty()) {
+        m_matchesValid = false;
+        return;
+    }
+    
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        m_rowScores[row] = m_cityModel->searchKey(row).score(m_foldedKeyword);
     }
-    return result;
 }
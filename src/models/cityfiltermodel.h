@@ -7,12 +7,21 @@
 #define CITYFILTERMODEL_H
 
 #include <QSortFilterProxyModel>
+#include <QVector>
+
+class CityModel;
 
 /**
  * @class CityFilterModel
  * @brief 城市搜索过滤代理模型
  * 
- * 支持按城市名称、拼音、省份进行模糊搜索
+ * 支持按城市名称、省份、全拼、拼音首字母进行模糊搜索，允许拼写错误（见 FuzzyMatcher）。
+ * 源模型为 CityModel 时直接对其预计算的搜索键打分，有关键词时按分数从高到低排序，
+ * 没有关键词时收藏的城市在前、其余按名称排序。
+ * 
+ * 关键词变化时先算出匹配的行及其分数，过滤和排序时只查表：
+ * - 新关键词以之前的某个关键词开头且容错程度相同时，结果必然是其子集，只复查那些行
+ * - 最近的关键词及其结果保存在 LRU 缓存中，退格时直接命中
  */
 class CityFilterModel : public QSortFilterProxyModel
 {
@@ -21,6 +30,8 @@ class CityFilterModel : public QSortFilterProxyModel
 public:
     explicit CityFilterModel(QObject *parent = nullptr);
     
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+    
     /**
      * @brief 设置搜索关键词
      * @param keyword 搜索关键词
@@ -64,23 +75,47 @@ protected:
 
 private:
     /**
-     * @brief 检查字符串是否匹配关键词
-     * @param text 待检查文本
-     * @param keyword 关键词
-     * @return 是否匹配
+     * @struct CachedMatch
+     * @brief 缓存的关键词匹配结果
+     */
+    struct CachedMatch {
+        QString keyword;
+        int tolerance = 0;      // FuzzyMatcher::Tolerance
+        QVector<int> rows;      // 匹配的源行（升序）
+        QVector<int> scores;    // 与 rows 一一对应的分数
+    };
+    
+    /**
+     * @brief 计算关键词匹配的源行及分数，优先使用缓存结果
      */
-    bool matchesKeyword(const QString &text, const QString &keyword) const;
+    const CachedMatch &matchRows(const QString &foldedKeyword);
     
     /**
-     * @brief 将中文转换为拼音首字母（简化版）
-     * @param chinese 中文字符串
-     * @return 拼音首字母
+     * @brief 源行对当前关键词的排序分数，收藏的城市略有加分
      */
-    QString toPinyinInitials(const QString &chinese) const;
+    int rankScore(int sourceRow) const;
+    
+    /**
+     * @brief 源模型重置后丢弃全部匹配结果
+     */
+    void invalidateMatches();
+    
+    // 源模型逐行变化时只更新受影响行的分数，缓存的历史结果行号已失效
+    void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void onSourceRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
 
 private:
+    CityModel *m_cityModel = nullptr;
+    QList<CachedMatch> m_matchCache;    // 最近使用的在前
+    QVector<int> m_rowScores;           // 源行 → 当前关键词的分数，不匹配为 NO_MATCH
+    bool m_matchesValid = false;        // 分数表是否与源模型一致
     QString m_searchKeyword;
+    QString m_foldedKeyword;    // 大小写折叠后的关键词，与搜索键直接比较
     bool m_favoritesOnly;
+    
+    static const int MATCH_CACHE_SIZE = 16;
+    static const int FAVORITE_BONUS = 50;
 };
 
 #endif // CITYFILTERMODEL_H
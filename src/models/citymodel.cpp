@@ -5,13 +5,35 @@
 
 #include "citymodel.h"
 #include "../database/databasemanager.h"
-#include <QSqlQuery>
-#include <QSqlError>
+#include "../services/cityservice.h"
+#include "../utils/pinyinutil.h"
+#include "../utils/fuzzymatcher.h"
 #include <QDebug>
 
+int CitySearchKey::score(const QString &foldedKeyword) const
+{
+    // 省份命中说明关键词不是城市本身，排在城市名命中之后
+    static const int PROVINCE_PENALTY = 500;
+    
+    int best = qMax(FuzzyMatcher::score(name, foldedKeyword),
+                    FuzzyMatcher::score(pinyin, foldedKeyword));
+    best = qMax(best, FuzzyMatcher::score(initials, foldedKeyword, false));
+    
+    int provinceScore = FuzzyMatcher::score(province, foldedKeyword, false);
+    if (provinceScore != FuzzyMatcher::NO_MATCH) {
+        best = qMax(best, qMax(1, provinceScore - PROVINCE_PENALTY));
+    }
+    return best;
+}
+
 CityModel::CityModel(QObject *parent)
     : QAbstractTableModel(parent)
 {
+    CityService &service = CityService::instance();
+    connect(&service, &CityService::cityAdded, this, &CityModel::onServiceCityAdded);
+    connect(&service, &CityService::cityUpdated, this, &CityModel::onServiceCityUpdated);
+    connect(&service, &CityService::cityDeleted, this, &CityModel::onServiceCityDeleted);
+    connect(&service, &CityService::favoriteChanged, this, &CityModel::onServiceFavoriteChanged);
 }
 
 int CityModel::rowCount(const QModelIndex &parent) const
@@ -31,10 +53,13 @@ QVariant CityModel::data(const QModelIndex &index, int role) const
     if (!index.isValid() || index.row() >= m_cities.count())
         return QVariant();
     
-    const CityInfo &city = m_cities.at(index.row());
-    
+    return cityData(m_cities.at(index.row()), index.column(), role);
+}
+
+QVariant CityModel::cityData(const CityInfo &city, int column, int role)
+{
     if (role == Qt::DisplayRole || role == Qt::EditRole) {
-        switch (index.column()) {
+        switch (column) {
             case ColId: return city.id;
             case ColCityId: return city.cityId;
             case ColName: return city.name;
@@ -59,6 +84,11 @@ QVariant CityModel::headerData(int section, Qt::Orientation orientation, int rol
     if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
         return QVariant();
     
+    return columnHeader(section);
+}
+
+QVariant CityModel::columnHeader(int section)
+{
     switch (section) {
         case ColId: return tr("ID");
         case ColCityId: return tr("城市ID");
@@ -84,6 +114,7 @@ void CityModel::setCities(const QList<CityInfo> &cities)
 {
     beginResetModel();
     m_cities = cities;
+    rebuildIndex();
     endResetModel();
 }
 
@@ -91,6 +122,9 @@ void CityModel::addCity(const CityInfo &city)
 {
     beginInsertRows(QModelIndex(), m_cities.count(), m_cities.count());
     m_cities.append(city);
+    m_searchKeys.append(makeSearchKey(city));
+    m_rowByCityId.insert(city.cityId, m_cities.count() - 1);
+    indexFavorite(city);
     endInsertRows();
     emit cityAdded(city);
 }
@@ -99,7 +133,16 @@ void CityModel::updateCity(int row, const CityInfo &city)
 {
     if (row < 0 || row >= m_cities.count()) return;
     
+    const CityInfo &old = m_cities.at(row);
+    unindexFavorite(old);
+    if (old.cityId != city.cityId) {
+        m_rowByCityId.remove(old.cityId);
+        m_rowByCityId.insert(city.cityId, row);
+    }
+    
     m_cities[row] = city;
+    m_searchKeys[row] = makeSearchKey(city);
+    indexFavorite(city);
     emit dataChanged(index(row, 0), index(row, ColCount - 1));
 }
 
@@ -109,7 +152,11 @@ void CityModel::removeCity(int row)
     
     QString cityId = m_cities.at(row).cityId;
     beginRemoveRows(QModelIndex(), row, row);
+    unindexFavorite(m_cities.at(row));
+    m_rowByCityId.remove(cityId);
     m_cities.removeAt(row);
+    m_searchKeys.removeAt(row);
+    reindexFrom(row);
     endRemoveRows();
     emit cityRemoved(cityId);
 }
@@ -118,6 +165,7 @@ void CityModel::clear()
 {
     beginResetModel();
     m_cities.clear();
+    rebuildIndex();
     endResetModel();
 }
 
@@ -130,20 +178,27 @@ CityInfo CityModel::cityAt(int row) const
 
 CityInfo CityModel::cityById(const QString &cityId) const
 {
-    for (const CityInfo &city : m_cities) {
-        if (city.cityId == cityId)
-            return city;
-    }
-    return CityInfo();
+    return cityAt(findRowByCityId(cityId));
 }
 
 int CityModel::findRowByCityId(const QString &cityId) const
 {
-    for (int i = 0; i < m_cities.count(); ++i) {
-        if (m_cities.at(i).cityId == cityId)
-            return i;
-    }
-    return -1;
+    return m_rowByCityId.value(cityId, -1);
+}
+
+const CitySearchKey &CityModel::searchKey(int row) const
+{
+    return m_searchKeys.at(row);
+}
+
+CitySearchKey CityModel::makeSearchKey(const CityInfo &city)
+{
+    CitySearchKey key;
+    key.name = city.name.toCaseFolded();
+    key.province = city.province.toCaseFolded();
+    key.pinyin = PinyinUtil::fullPinyin(city.name);
+    key.initials = PinyinUtil::initials(city.name);
+    return key;
 }
 
 QList<CityInfo> CityModel::allCities() const
@@ -153,15 +208,12 @@ QList<CityInfo> CityModel::allCities() const
 
 QList<CityInfo> CityModel::favoriteCities() const
 {
+    // 收藏索引已按收藏顺序排列
     QList<CityInfo> favorites;
-    for (const CityInfo &city : m_cities) {
-        if (city.isFavorite)
-            favorites.append(city);
+    favorites.reserve(m_favoritesByOrder.size());
+    for (const QString &cityId : m_favoritesByOrder) {
+        favorites.append(m_cities.at(m_rowByCityId.value(cityId)));
     }
-    // 按收藏顺序排序
-    std::sort(favorites.begin(), favorites.end(), [](const CityInfo &a, const CityInfo &b) {
-        return a.favoriteOrder < b.favoriteOrder;
-    });
     return favorites;
 }
 
@@ -169,16 +221,16 @@ void CityModel::setFavorite(int row, bool favorite)
 {
     if (row < 0 || row >= m_cities.count()) return;
     
+    unindexFavorite(m_cities.at(row));
     m_cities[row].isFavorite = favorite;
     if (favorite) {
         // 设置收藏顺序为当前最大值+1
-        int maxOrder = 0;
-        for (const CityInfo &city : m_cities) {
-            if (city.isFavorite && city.favoriteOrder > maxOrder)
-                maxOrder = city.favoriteOrder;
-        }
+        int maxOrder = m_favoritesByOrder.isEmpty() ? 0 : qMax(0, m_favoritesByOrder.lastKey());
         m_cities[row].favoriteOrder = maxOrder + 1;
+    } else {
+        m_cities[row].favoriteOrder = 0;
     }
+    indexFavorite(m_cities.at(row));
     
     emit dataChanged(index(row, ColIsFavorite), index(row, ColFavoriteOrder));
     emit favoriteChanged(m_cities.at(row).cityId, favorite);
@@ -198,9 +250,13 @@ void CityModel::moveFavorite(int fromRow, int toRow)
     if (fromRow == toRow) return;
     
     // 交换收藏顺序
+    unindexFavorite(m_cities.at(fromRow));
+    unindexFavorite(m_cities.at(toRow));
     int tempOrder = m_cities[fromRow].favoriteOrder;
     m_cities[fromRow].favoriteOrder = m_cities[toRow].favoriteOrder;
     m_cities[toRow].favoriteOrder = tempOrder;
+    indexFavorite(m_cities.at(fromRow));
+    indexFavorite(m_cities.at(toRow));
     
     emit dataChanged(index(fromRow, ColFavoriteOrder), index(fromRow, ColFavoriteOrder));
     emit dataChanged(index(toRow, ColFavoriteOrder), index(toRow, ColFavoriteOrder));
@@ -213,30 +269,7 @@ void CityModel::loadFromDatabase()
         return;
     }
     
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare("SELECT id, city_id, name, province, country, latitude, longitude, "
-                  "is_favorite, favorite_order FROM city ORDER BY name");
-    
-    if (!query.exec()) {
-        qWarning() << "Failed to load cities:" << query.lastError().text();
-        return;
-    }
-    
-    QList<CityInfo> cities;
-    while (query.next()) {
-        CityInfo city;
-        city.id = query.value(0).toInt();
-        city.cityId = query.value(1).toString();
-        city.name = query.value(2).toString();
-        city.province = query.value(3).toString();
-        city.country = query.value(4).toString();
-        city.latitude = query.value(5).toDouble();
-        city.longitude = query.value(6).toDouble();
-        city.isFavorite = query.value(7).toBool();
-        city.favoriteOrder = query.value(8).toInt();
-        cities.append(city);
-    }
-    
+    QList<CityInfo> cities = CityService::instance().getAllCities();
     setCities(cities);
     qDebug() << "Loaded" << cities.count() << "cities from database";
 }
@@ -248,31 +281,78 @@ void CityModel::loadFavoritesFromDatabase()
         return;
     }
     
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare("SELECT id, city_id, name, province, country, latitude, longitude, "
-                  "is_favorite, favorite_order FROM city WHERE is_favorite = 1 "
-                  "ORDER BY favorite_order");
-    
-    if (!query.exec()) {
-        qWarning() << "Failed to load favorite cities:" << query.lastError().text();
-        return;
+    QList<CityInfo> cities = CityService::instance().getFavoriteCities();
+    setCities(cities);
+    qDebug() << "Loaded" << cities.count() << "favorite cities from database";
+}
+
+void CityModel::onServiceCityAdded(const CityInfo &city)
+{
+    int row = findRowByCityId(city.cityId);
+    if (row >= 0) {
+        updateCity(row, city);
+    } else {
+        addCity(city);
     }
-    
-    QList<CityInfo> cities;
-    while (query.next()) {
-        CityInfo city;
-        city.id = query.value(0).toInt();
-        city.cityId = query.value(1).toString();
-        city.name = query.value(2).toString();
-        city.province = query.value(3).toString();
-        city.country = query.value(4).toString();
-        city.latitude = query.value(5).toDouble();
-        city.longitude = query.value(6).toDouble();
-        city.isFavorite = query.value(7).toBool();
-        city.favoriteOrder = query.value(8).toInt();
-        cities.append(city);
+}
+
+void CityModel::onServiceCityUpdated(const CityInfo &city)
+{
+    int row = findRowByCityId(city.cityId);
+    if (row >= 0) {
+        CityInfo updated = city;
+        updated.id = m_cities.at(row).id;
+        updateCity(row, updated);
     }
+}
+
+void CityModel::onServiceCityDeleted(const QString &cityId)
+{
+    removeCity(findRowByCityId(cityId));
+}
+
+void CityModel::onServiceFavoriteChanged(const QString &cityId, bool isFavorite)
+{
+    // 与 CityService 相同，新收藏的城市排在最后
+    int row = findRowByCityId(cityId);
+    if (row >= 0 && m_cities.at(row).isFavorite != isFavorite) {
+        setFavorite(row, isFavorite);
+    }
+}
+
+void CityModel::rebuildIndex()
+{
+    m_rowByCityId.clear();
+    m_rowByCityId.reserve(m_cities.count());
+    m_favoritesByOrder.clear();
+    m_searchKeys.clear();
+    m_searchKeys.reserve(m_cities.count());
     
-    setCities(cities);
-    qDebug() << "Loaded" << cities.count() << "favorite cities from database";
+    for (int row = 0; row < m_cities.count(); ++row) {
+        const CityInfo &city = m_cities.at(row);
+        m_rowByCityId.insert(city.cityId, row);
+        m_searchKeys.append(makeSearchKey(city));
+        indexFavorite(city);
+    }
+}
+
+void CityModel::reindexFrom(int row)
+{
+    for (int i = row; i < m_cities.count(); ++i) {
+        m_rowByCityId.insert(m_cities.at(i).cityId, i);
+    }
+}
+
+void CityModel::indexFavorite(const CityInfo &city)
+{
+    if (city.isFavorite) {
+        m_favoritesByOrder.insert(city.favoriteOrder, city.cityId);
+    }
+}
+
+void CityModel::unindexFavorite(const CityInfo &city)
+{
+    if (city.isFavorite) {
+        m_favoritesByOrder.remove(city.favoriteOrder, city.cityId);
+    }
 }
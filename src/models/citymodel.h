@@ -8,6 +8,8 @@
 
 #include <QAbstractTableModel>
 #include <QList>
+#include <QHash>
+#include <QMultiMap>
 
 /**
  * @struct CityInfo
@@ -25,11 +27,37 @@ struct CityInfo {
     int favoriteOrder = 0;
 };
 
+/**
+ * @struct CitySearchKey
+ * @brief 城市的预计算搜索键
+ * 
+ * 加载城市时计算一次，所有字段均已做大小写折叠，过滤时直接比较
+ */
+struct CitySearchKey {
+    QString name;
+    QString province;
+    QString pinyin;         // 全拼，如 beijing
+    QString initials;       // 拼音首字母，如 bj
+    
+    /**
+     * @brief 模糊匹配分数，取各字段的最高分，不匹配时返回 FuzzyMatcher::NO_MATCH
+     * 
+     * 名称和全拼允许拼写容错，首字母和省份只做子串/子序列匹配，省份命中的分数较低
+     */
+    int score(const QString &foldedKeyword) const;
+};
+
 /**
  * @class CityModel
  * @brief 城市数据模型
  * 
  * 基于QAbstractTableModel实现，用于城市列表的显示和管理
+ * 
+ * 维护 cityId → 行号 的哈希索引和按收藏顺序排列的收藏索引，
+ * 按ID查找为 O(1)，获取收藏列表只与收藏数量有关
+ * 
+ * 订阅 CityService 的增删改和收藏信号，只对受影响的行发出插入、删除或 dataChanged，
+ * 数据库变化后无需整体重新加载
  */
 class CityModel : public QAbstractTableModel
 {
@@ -63,6 +91,16 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
     Qt::ItemFlags flags(const QModelIndex &index) const override;
     
+    /**
+     * @brief 城市在指定列、角色下的数据，与 data() 一致，供其他城市模型复用
+     */
+    static QVariant cityData(const CityInfo &city, int column, int role);
+    
+    /**
+     * @brief 列标题
+     */
+    static QVariant columnHeader(int section);
+    
     // 数据操作
     void setCities(const QList<CityInfo> &cities);
     void addCity(const CityInfo &city);
@@ -74,6 +112,16 @@ public:
     CityInfo cityAt(int row) const;
     CityInfo cityById(const QString &cityId) const;
     int findRowByCityId(const QString &cityId) const;
+    
+    /**
+     * @brief 获取行的预计算搜索键
+     */
+    const CitySearchKey &searchKey(int row) const;
+    
+    /**
+     * @brief 为城市计算搜索键
+     */
+    static CitySearchKey makeSearchKey(const CityInfo &city);
     QList<CityInfo> allCities() const;
     QList<CityInfo> favoriteCities() const;
     
@@ -91,8 +139,31 @@ signals:
     void cityRemoved(const QString &cityId);
     void favoriteChanged(const QString &cityId, bool isFavorite);
 
+private slots:
+    // CityService 信号
+    void onServiceCityAdded(const CityInfo &city);
+    void onServiceCityUpdated(const CityInfo &city);
+    void onServiceCityDeleted(const QString &cityId);
+    void onServiceFavoriteChanged(const QString &cityId, bool isFavorite);
+
 private:
+    /**
+     * @brief 重建全部索引
+     */
+    void rebuildIndex();
+    
+    /**
+     * @brief 从 row 开始重新登记行号（插入或删除行之后）
+     */
+    void reindexFrom(int row);
+    
+    void indexFavorite(const CityInfo &city);
+    void unindexFavorite(const CityInfo &city);
+    
     QList<CityInfo> m_cities;
+    QList<CitySearchKey> m_searchKeys;             // 与 m_cities 按行对应
+    QHash<QString, int> m_rowByCityId;             // cityId → 行号
+    QMultiMap<int, QString> m_favoritesByOrder;    // 收藏顺序 → cityId
 };
 
 #endif // CITYMODEL_H
@@ -0,0 +1,619 @@
+/**
+ * @file citypagemodel.cpp
+ * @brief 分页加载的城市列表模型实现
+ */
+
+#include "citypagemodel.h"
+#include "../services/asyncdataservice.h"
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+// 与 getCityPage 的 ORDER BY name, id 一致
+bool keyLess(const QString &name1, int id1, const QString &name2, int id2)
+{
+    int cmp = QString::compare(name1, name2);
+    return cmp < 0 || (cmp == 0 && id1 < id2);
+}
+}
+
+CityPageModel::CityPageModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+    CityService &service = CityService::instance();
+    connect(&service, &CityService::cityAdded, this, &CityPageModel::onServiceCityAdded);
+    connect(&service, &CityService::cityUpdated, this, &CityPageModel::onServiceCityUpdated);
+    connect(&service, &CityService::cityDeleted, this, &CityPageModel::onServiceCityDeleted);
+    connect(&service, &CityService::favoriteChanged, this, &CityPageModel::onServiceFavoriteChanged);
+}
+
+int CityPageModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+    return m_rowCount;
+}
+
+int CityPageModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+    return CityModel::ColCount;
+}
+
+QVariant CityPageModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rowCount)
+        return QVariant();
+    
+    int row = index.row();
+    if (row < m_favorites.count()) {
+        return CityModel::cityData(m_favorites.at(row), index.column(), role);
+    }
+    
+    // 视图按需取数据，在这里记录页的访问并补读被释放的页
+    int pageIndex = pageOfRow(row);
+    const_cast<CityPageModel*>(this)->touchPage(pageIndex);
+    
+    const Page &page = m_pages.at(pageIndex);
+    if (!page.isResident()) {
+        if (role == Qt::DisplayRole && index.column() == CityModel::ColName) {
+            return tr("加载中...");
+        }
+        return QVariant();
+    }
+    
+    int offset = row - m_favorites.count() - page.firstRow;
+    return CityModel::cityData(page.cities.at(offset), index.column(), role);
+}
+
+QVariant CityPageModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+    
+    return CityModel::columnHeader(section);
+}
+
+Qt::ItemFlags CityPageModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+bool CityPageModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return false;
+    return m_favoritesLoaded && !m_fetching && !m_exhausted;
+}
+
+void CityPageModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+    
+    Page page;
+    if (!m_pages.isEmpty()) {
+        page.afterName = m_pages.last().lastName;
+        page.afterId = m_pages.last().lastId;
+    }
+    
+    m_fetching = true;
+    int generation = m_generation;
+    AsyncDataService::instance().getCityPage(page.afterName, page.afterId, PAGE_SIZE)
+        .then(this, [this, generation, after = page](const QList<CityInfo> &cities) {
+        if (generation != m_generation) {
+            return;
+        }
+        
+        m_fetching = false;
+        if (cities.size() < PAGE_SIZE) {
+            m_exhausted = true;
+        }
+        if (cities.isEmpty()) {
+            return;
+        }
+        
+        Page page = after;
+        page.firstRow = m_rowCount - m_favorites.count();
+        page.cities = cities;
+        page.count = cities.size();
+        page.lastName = cities.last().name;
+        page.lastId = cities.last().id;
+        page.lastUsed = ++m_useCounter;
+        
+        beginInsertRows(QModelIndex(), m_rowCount, m_rowCount + page.count - 1);
+        m_pages.append(page);
+        m_rowCount += page.count;
+        endInsertRows();
+        
+        evictPages();
+    });
+}
+
+void CityPageModel::reload()
+{
+    beginResetModel();
+    ++m_generation;
+    m_favorites.clear();
+    m_pages.clear();
+    m_rowCount = 0;
+    m_totalCount = -1;
+    m_favoritesLoaded = false;
+    m_fetching = false;
+    m_exhausted = false;
+    endResetModel();
+    
+    // 数据库线程按提交顺序执行：先数总数，再读收藏，收藏就绪后读第一页
+    int generation = m_generation;
+    AsyncDataService &service = AsyncDataService::instance();
+    
+    service.getCityCount().then(this, [this, generation](int count) {
+        if (generation != m_generation) {
+            return;
+        }
+        m_totalCount = count;
+        emit totalCountChanged(count);
+    });
+    
+    service.getFavoriteCities().then(this, [this, generation](const QList<CityInfo> &favorites) {
+        if (generation != m_generation) {
+            return;
+        }
+        
+        if (!favorites.isEmpty()) {
+            beginInsertRows(QModelIndex(), 0, favorites.count() - 1);
+            m_favorites = favorites;
+            m_rowCount += favorites.count();
+            endInsertRows();
+        }
+        m_favoritesLoaded = true;
+        fetchMore(QModelIndex());
+    });
+}
+
+CityInfo CityPageModel::cityAt(int row) const
+{
+    if (row < 0 || row >= m_rowCount) return CityInfo();
+    
+    if (row < m_favorites.count()) {
+        return m_favorites.at(row);
+    }
+    
+    const Page &page = m_pages.at(pageOfRow(row));
+    return page.isResident() ? page.cities.at(row - m_favorites.count() - page.firstRow) : CityInfo();
+}
+
+int CityPageModel::totalCount() const
+{
+    return m_totalCount;
+}
+
+int CityPageModel::pageOfRow(int row) const
+{
+    if (row < m_favorites.count()) {
+        return -1;
+    }
+    
+    // 各页行数随增删变化，按首行二分查找
+    int pageRow = row - m_favorites.count();
+    auto it = std::upper_bound(m_pages.cbegin(), m_pages.cend(), pageRow,
+                               [](int value, const Page &page) { return value < page.firstRow; });
+    return int(it - m_pages.cbegin()) - 1;
+}
+
+int CityPageModel::findPage(const QString &afterName, int afterId) const
+{
+    // 各页按起点键升序排列
+    auto it = std::lower_bound(m_pages.cbegin(), m_pages.cend(), std::make_pair(afterName, afterId),
+                               [](const Page &page, const std::pair<QString, int> &key) {
+        return keyLess(page.afterName, page.afterId, key.first, key.second);
+    });
+    if (it == m_pages.cend() || it->afterName != afterName || it->afterId != afterId) {
+        return -1;
+    }
+    return int(it - m_pages.cbegin());
+}
+
+void CityPageModel::updateFirstRows(int pageIndex)
+{
+    int row = pageIndex > 0 ? m_pages[pageIndex - 1].firstRow + m_pages[pageIndex - 1].count : 0;
+    for (int i = pageIndex; i < m_pages.size(); ++i) {
+        m_pages[i].firstRow = row;
+        row += m_pages[i].count;
+    }
+}
+
+void CityPageModel::touchPage(int pageIndex)
+{
+    Page &page = m_pages[pageIndex];
+    page.lastUsed = ++m_useCounter;
+    if (!page.isResident() && !page.loading) {
+        loadPage(pageIndex);
+    }
+}
+
+void CityPageModel::loadPage(int pageIndex)
+{
+    Page &page = m_pages[pageIndex];
+    page.loading = true;
+    
+    // 读取期间页可能因增删被移除或移位，完成时按起点键重新查找
+    int generation = m_generation;
+    AsyncDataService::instance().getCityPage(page.afterName, page.afterId, page.count)
+        .then(this, [this, generation, afterName = page.afterName, afterId = page.afterId]
+              (const QList<CityInfo> &cities) {
+        if (generation != m_generation) {
+            return;
+        }
+        
+        int pageIndex = findPage(afterName, afterId);
+        if (pageIndex < 0 || !m_pages[pageIndex].loading) {
+            return;
+        }
+        Page &page = m_pages[pageIndex];
+        page.loading = false;
+        
+        // 页被释放期间城市表发生了未收到通知的变化，行号已经对不上，整体重新加载
+        if (cities.size() != page.count
+            || keyLess(page.lastName, page.lastId, cities.last().name, cities.last().id)) {
+            qDebug() << "City table changed while paging, reloading";
+            reload();
+            return;
+        }
+        
+        page.cities = cities;
+        page.lastUsed = ++m_useCounter;
+        
+        int firstRow = m_favorites.count() + page.firstRow;
+        emit dataChanged(index(firstRow, 0), index(firstRow + page.count - 1, CityModel::ColCount - 1));
+        
+        evictPages();
+    });
+}
+
+void CityPageModel::evictPages()
+{
+    int resident = 0;
+    for (const Page &page : std::as_const(m_pages)) {
+        if (!page.cities.isEmpty()) {
+            ++resident;
+        }
+    }
+    
+    while (resident > MAX_RESIDENT_PAGES) {
+        int oldest = -1;
+        for (int i = 0; i < m_pages.size(); ++i) {
+            if (!m_pages[i].cities.isEmpty()
+                && (oldest < 0 || m_pages[i].lastUsed < m_pages[oldest].lastUsed)) {
+                oldest = i;
+            }
+        }
+        // 只释放数据，行数和页边界保留，视图不受影响
+        m_pages[oldest].cities.clear();
+        m_pages[oldest].cities.squeeze();
+        --resident;
+    }
+}
+
+bool CityPageModel::hasEvictedPages() const
+{
+    return std::any_of(m_pages.cbegin(), m_pages.cend(), [](const Page &page) { return !page.isResident(); });
+}
+
+bool CityPageModel::locate(const QString &cityId, int &pageIndex, int &offset) const
+{
+    for (int i = 0; i < m_favorites.count(); ++i) {
+        if (m_favorites.at(i).cityId == cityId) {
+            pageIndex = -1;
+            offset = i;
+            return true;
+        }
+    }
+    
+    for (int p = 0; p < m_pages.size(); ++p) {
+        const QList<CityInfo> &cities = m_pages.at(p).cities;
+        for (int i = 0; i < cities.size(); ++i) {
+            if (cities.at(i).cityId == cityId) {
+                pageIndex = p;
+                offset = i;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool CityPageModel::findSlot(const CityInfo &city, int &pageIndex, int &offset) const
+{
+    // 每页覆盖 (afterName, lastName] 的键范围，取第一个上界不小于该城市的页
+    auto it = std::lower_bound(m_pages.cbegin(), m_pages.cend(), city,
+                               [](const Page &page, const CityInfo &value) {
+        return keyLess(page.lastName, page.lastId, value.name, value.id);
+    });
+    pageIndex = int(it - m_pages.cbegin());
+    offset = 0;
+    
+    if (pageIndex == m_pages.size()) {
+        // 在已读取的范围之后，之后的 fetchMore 会读到
+        if (!m_favoritesLoaded || !m_exhausted) {
+            return false;
+        }
+        if (m_pages.isEmpty()) {
+            return true;
+        }
+        pageIndex = m_pages.size() - 1;
+    }
+    
+    // 数据不在内存中时放在页首，重新读取时整页刷新
+    const Page &page = m_pages.at(pageIndex);
+    if (page.isResident()) {
+        auto pos = std::lower_bound(page.cities.cbegin(), page.cities.cend(), city,
+                                    [](const CityInfo &a, const CityInfo &b) {
+            return keyLess(a.name, a.id, b.name, b.id);
+        });
+        offset = int(pos - page.cities.cbegin());
+    }
+    return true;
+}
+
+int CityPageModel::slotRow(int pageIndex, int offset) const
+{
+    int firstRow = pageIndex < m_pages.size() ? m_pages.at(pageIndex).firstRow : 0;
+    return m_favorites.count() + firstRow + offset;
+}
+
+void CityPageModel::placeInPage(const CityInfo &city, int pageIndex, int offset)
+{
+    if (m_pages.isEmpty()) {
+        m_pages.append(Page());
+    }
+    
+    Page &page = m_pages[pageIndex];
+    if (keyLess(page.lastName, page.lastId, city.name, city.id)) {
+        page.lastName = city.name;
+        page.lastId = city.id;
+    }
+    if (page.isResident()) {
+        page.cities.insert(offset, city);
+        page.lastUsed = ++m_useCounter;
+    }
+    ++page.count;
+    ++m_rowCount;
+    updateFirstRows(pageIndex + 1);
+}
+
+CityInfo CityPageModel::takeFromPage(int pageIndex, int offset)
+{
+    Page &page = m_pages[pageIndex];
+    CityInfo city = page.cities.takeAt(offset);
+    --page.count;
+    --m_rowCount;
+    
+    // 页的上界保持不变；空页并入下一页的键范围
+    if (page.count == 0) {
+        if (pageIndex + 1 < m_pages.size()) {
+            // 起点键变化后旧的读取结果找不到这一页，清除标记以便重新读取
+            Page &next = m_pages[pageIndex + 1];
+            next.afterName = page.afterName;
+            next.afterId = page.afterId;
+            next.loading = false;
+        }
+        m_pages.removeAt(pageIndex);
+    }
+    updateFirstRows(pageIndex);
+    return city;
+}
+
+void CityPageModel::putFavorite(CityInfo city)
+{
+    // 与 CityService 相同，新收藏的城市排在最后
+    city.isFavorite = true;
+    if (city.favoriteOrder <= 0) {
+        city.favoriteOrder = m_favorites.isEmpty() ? 1 : m_favorites.last().favoriteOrder + 1;
+    }
+    m_favorites.append(city);
+    ++m_rowCount;
+}
+
+CityInfo CityPageModel::takeFavorite(int offset)
+{
+    --m_rowCount;
+    return m_favorites.takeAt(offset);
+}
+
+void CityPageModel::insertIntoPages(const CityInfo &city)
+{
+    int pageIndex = 0;
+    int offset = 0;
+    if (!findSlot(city, pageIndex, offset)) {
+        return;
+    }
+    
+    int row = slotRow(pageIndex, offset);
+    beginInsertRows(QModelIndex(), row, row);
+    placeInPage(city, pageIndex, offset);
+    endInsertRows();
+}
+
+void CityPageModel::removeFromPage(int pageIndex, int offset)
+{
+    int row = slotRow(pageIndex, offset);
+    beginRemoveRows(QModelIndex(), row, row);
+    takeFromPage(pageIndex, offset);
+    endRemoveRows();
+}
+
+void CityPageModel::appendFavorite(const CityInfo &city)
+{
+    int row = m_favorites.count();
+    beginInsertRows(QModelIndex(), row, row);
+    putFavorite(city);
+    endInsertRows();
+}
+
+void CityPageModel::removeFavorite(int offset)
+{
+    beginRemoveRows(QModelIndex(), offset, offset);
+    takeFavorite(offset);
+    endRemoveRows();
+}
+
+void CityPageModel::moveToFavorites(int pageIndex, int offset)
+{
+    // 用行移动而不是删除再插入，选中项和持久索引跟随城市移动
+    int sourceRow = slotRow(pageIndex, offset);
+    int destinationRow = m_favorites.count();
+    bool moved = beginMoveRows(QModelIndex(), sourceRow, sourceRow, QModelIndex(), destinationRow);
+    
+    CityInfo city = takeFromPage(pageIndex, offset);
+    city.favoriteOrder = 0;
+    putFavorite(city);
+    
+    // 行号不变时 Qt 不接受移动，只需刷新该行
+    if (moved) {
+        endMoveRows();
+    } else {
+        emit dataChanged(index(destinationRow, 0), index(destinationRow, CityModel::ColCount - 1));
+    }
+}
+
+void CityPageModel::moveToPages(int offset)
+{
+    CityInfo city = m_favorites.at(offset);
+    city.isFavorite = false;
+    city.favoriteOrder = 0;
+    
+    int pageIndex = 0;
+    int pageOffset = 0;
+    if (!findSlot(city, pageIndex, pageOffset)) {
+        removeFavorite(offset);
+        return;
+    }
+    
+    int destinationRow = slotRow(pageIndex, pageOffset);
+    bool moved = beginMoveRows(QModelIndex(), offset, offset, QModelIndex(), destinationRow);
+    takeFavorite(offset);
+    placeInPage(city, pageIndex, pageOffset);
+    
+    if (moved) {
+        endMoveRows();
+    } else {
+        emit dataChanged(index(offset, 0), index(offset, CityModel::ColCount - 1));
+    }
+}
+
+void CityPageModel::onServiceCityAdded(const CityInfo &city)
+{
+    int pageIndex = 0;
+    int offset = 0;
+    if (locate(city.cityId, pageIndex, offset)) {
+        onServiceCityUpdated(city);
+        return;
+    }
+    
+    if (city.isFavorite) {
+        appendFavorite(city);
+    } else {
+        insertIntoPages(city);
+    }
+    
+    if (m_totalCount >= 0) {
+        emit totalCountChanged(++m_totalCount);
+    }
+}
+
+void CityPageModel::onServiceCityUpdated(const CityInfo &city)
+{
+    int pageIndex = 0;
+    int offset = 0;
+    if (!locate(city.cityId, pageIndex, offset)) {
+        return;
+    }
+    
+    const CityInfo &old = pageIndex < 0 ? m_favorites.at(offset) : m_pages.at(pageIndex).cities.at(offset);
+    CityInfo updated = city;
+    updated.id = old.id;
+    
+    // 位置不变时原地更新
+    bool samePlace = old.isFavorite == updated.isFavorite
+                     && (updated.isFavorite ? old.favoriteOrder == updated.favoriteOrder : old.name == updated.name);
+    if (samePlace) {
+        int row = pageIndex < 0 ? offset : m_favorites.count() + m_pages.at(pageIndex).firstRow + offset;
+        if (pageIndex < 0) {
+            m_favorites[offset] = updated;
+        } else {
+            m_pages[pageIndex].cities[offset] = updated;
+        }
+        emit dataChanged(index(row, 0), index(row, CityModel::ColCount - 1));
+        return;
+    }
+    
+    if (pageIndex < 0) {
+        removeFavorite(offset);
+    } else {
+        removeFromPage(pageIndex, offset);
+    }
+    if (updated.isFavorite) {
+        appendFavorite(updated);
+    } else {
+        insertIntoPages(updated);
+    }
+}
+
+void CityPageModel::onServiceCityDeleted(const QString &cityId)
+{
+    int pageIndex = 0;
+    int offset = 0;
+    if (locate(cityId, pageIndex, offset)) {
+        if (pageIndex < 0) {
+            removeFavorite(offset);
+        } else {
+            removeFromPage(pageIndex, offset);
+        }
+    } else if (hasEvictedPages()) {
+        // 可能在已释放的页中，无法确定行号
+        reload();
+        return;
+    }
+    
+    if (m_totalCount > 0) {
+        emit totalCountChanged(--m_totalCount);
+    }
+}
+
+void CityPageModel::onServiceFavoriteChanged(const QString &cityId, bool isFavorite)
+{
+    int pageIndex = 0;
+    int offset = 0;
+    bool found = locate(cityId, pageIndex, offset);
+    
+    if (!isFavorite) {
+        if (found && pageIndex < 0) {
+            moveToPages(offset);
+        }
+        return;
+    }
+    
+    if (found) {
+        if (pageIndex >= 0) {
+            moveToFavorites(pageIndex, offset);
+        }
+        return;
+    }
+    
+    if (hasEvictedPages()) {
+        reload();
+        return;
+    }
+    
+    // 城市还在未读取的范围内，只需补读它本身加入收藏
+    int generation = m_generation;
+    AsyncDataService::instance().getCity(cityId).then(this, [this, generation](const CityInfo &city) {
+        int pageIndex = 0;
+        int offset = 0;
+        if (generation == m_generation && !city.cityId.isEmpty() && !locate(city.cityId, pageIndex, offset)) {
+            appendFavorite(city);
+        }
+    });
+}
@@ -0,0 +1,159 @@
+/**
+ * @file citypagemodel.h
+ * @brief 分页加载的城市列表模型
+ */
+
+#ifndef CITYPAGEMODEL_H
+#define CITYPAGEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QList>
+#include "citymodel.h"
+
+/**
+ * @class CityPageModel
+ * @brief 按需分页加载的城市列表模型
+ * 
+ * 列定义与 CityModel 相同。收藏城市按收藏顺序排在最前并常驻内存，
+ * 其余城市按名称排序，视图滚动到底部时通过 fetchMore 在数据库线程读取下一页（键集分页）。
+ * 
+ * 只有最近访问的 MAX_RESIDENT_PAGES 页保留城市数据，其他页只保留页边界的 (name, id)，
+ * 再次显示时按边界重新读取。城市表再大，启动时也只读取收藏和第一页，常驻内存有上限。
+ * 
+ * 订阅 CityService 的增删改和收藏信号，按 (name, id) 把变化落到对应页的对应行，
+ * 只发出单行的插入、删除或 dataChanged，选中项和滚动位置保持不变。
+ */
+class CityPageModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit CityPageModel(QObject *parent = nullptr);
+    
+    // QAbstractTableModel 接口实现
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    
+    /**
+     * @brief 清空并重新读取收藏和第一页
+     */
+    void reload();
+    
+    /**
+     * @brief 获取行对应的城市，数据不在内存中时返回空的 CityInfo
+     */
+    CityInfo cityAt(int row) const;
+    
+    /**
+     * @brief 数据库中的城市总数，尚未读取时为 -1
+     */
+    int totalCount() const;
+
+signals:
+    /**
+     * @brief reload 后城市总数已读取
+     */
+    void totalCountChanged(int count);
+
+private slots:
+    // CityService 信号
+    void onServiceCityAdded(const CityInfo &city);
+    void onServiceCityUpdated(const CityInfo &city);
+    void onServiceCityDeleted(const QString &cityId);
+    void onServiceFavoriteChanged(const QString &cityId, bool isFavorite);
+
+private:
+    /**
+     * @struct Page
+     * @brief 一页非收藏城市
+     */
+    struct Page {
+        QString afterName;          // 上一页最后一行，作为本页的读取起点
+        int afterId = 0;
+        QString lastName;           // 本页最后一行，作为下一页的读取起点
+        int lastId = 0;
+        int firstRow = 0;           // 本页首行在非收藏部分中的行号
+        int count = 0;              // 本页行数，数据被释放后保持不变
+        QList<CityInfo> cities;     // 为空表示数据不在内存中
+        bool loading = false;
+        quint64 lastUsed = 0;
+        
+        bool isResident() const { return cities.size() == count; }
+    };
+    
+    /**
+     * @brief 行所在的页，收藏行返回 -1
+     */
+    int pageOfRow(int row) const;
+    
+    /**
+     * @brief 按读取起点键查找页，找不到返回 -1
+     */
+    int findPage(const QString &afterName, int afterId) const;
+    
+    /**
+     * @brief 从 pageIndex 开始重新计算各页首行
+     */
+    void updateFirstRows(int pageIndex);
+    
+    /**
+     * @brief 在常驻数据中查找城市
+     * @param pageIndex 所在页，收藏城市为 -1
+     * @param offset 在收藏列表或页内的位置
+     * @return 是否找到
+     */
+    bool locate(const QString &cityId, int &pageIndex, int &offset) const;
+    bool hasEvictedPages() const;
+    
+    /**
+     * @brief 非收藏城市按 (name, id) 应在的页和页内位置
+     * @return 在尚未读取到的范围内时返回 false
+     */
+    bool findSlot(const CityInfo &city, int &pageIndex, int &offset) const;
+    int slotRow(int pageIndex, int offset) const;
+    
+    // 只修改数据，由调用方发出模型信号
+    void placeInPage(const CityInfo &city, int pageIndex, int offset);
+    CityInfo takeFromPage(int pageIndex, int offset);
+    void putFavorite(CityInfo city);
+    CityInfo takeFavorite(int offset);
+    
+    // 修改数据并发出单行的插入、删除或移动信号
+    void insertIntoPages(const CityInfo &city);
+    void removeFromPage(int pageIndex, int offset);
+    void appendFavorite(const CityInfo &city);
+    void removeFavorite(int offset);
+    void moveToFavorites(int pageIndex, int offset);
+    void moveToPages(int offset);
+    
+    /**
+     * @brief 标记页被访问，数据不在内存中时发起读取
+     */
+    void touchPage(int pageIndex);
+    void loadPage(int pageIndex);
+    
+    /**
+     * @brief 释放最久未访问的页，直到常驻页数不超过上限
+     */
+    void evictPages();
+    
+    QList<CityInfo> m_favorites;
+    QList<Page> m_pages;
+    int m_rowCount = 0;
+    int m_totalCount = -1;
+    int m_generation = 0;           // reload 后递增，丢弃旧请求的结果
+    bool m_favoritesLoaded = false;
+    bool m_fetching = false;
+    bool m_exhausted = false;
+    quint64 m_useCounter = 0;
+    
+    static const int PAGE_SIZE = 200;
+    static const int MAX_RESIDENT_PAGES = 10;
+};
+
+#endif // CITYPAGEMODEL_H
@@ -0,0 +1,162 @@
+/**
+ * @file asyncdataservice.cpp
+ * @brief 异步数据访问服务实现
+ */
+
+#include "asyncdataservice.h"
+#include <QtConcurrent>
+
+AsyncDataService::AsyncDataService(QObject *parent)
+    : QObject(parent)
+{
+    // 单线程保证提交顺序；线程不过期，连接和语句缓存一直可用
+    m_pool.setMaxThreadCount(1);
+    m_pool.setExpiryTimeout(-1);
+}
+
+AsyncDataService::~AsyncDataService()
+{
+    m_pool.waitForDone();
+}
+
+AsyncDataService& AsyncDataService::instance()
+{
+    static AsyncDataService instance;
+    return instance;
+}
+
+QFuture<CityInfo> AsyncDataService::getCity(const QString &cityId)
+{
+    return QtConcurrent::run(&m_pool, [cityId]() {
+        return CityDirectory::instance().city(cityId);
+    });
+}
+
+QFuture<QList<CityInfo>> AsyncDataService::getAllCities()
+{
+    return QtConcurrent::run(&m_pool, []() {
+        return CityService::instance().getAllCities();
+    });
+}
+
+QFuture<QList<CityInfo>> AsyncDataService::getFavoriteCities()
+{
+    return QtConcurrent::run(&m_pool, []() {
+        return CityService::instance().getFavoriteCities();
+    });
+}
+
+QFuture<int> AsyncDataService::getCityCount()
+{
+    return QtConcurrent::run(&m_pool, []() {
+        return CityService::instance().getCityCount();
+    });
+}
+
+QFuture<QList<CityInfo>> AsyncDataService::getCityPage(const QString &afterName, int afterId, int limit)
+{
+    return QtConcurrent::run(&m_pool, [afterName, afterId, limit]() {
+        return CityService::instance().getCityPage(afterName, afterId, limit);
+    });
+}
+
+QFuture<QList<CityInfo>> AsyncDataService::searchCities(const QString &keyword, int limit)
+{
+    return QtConcurrent::run(&m_pool, [keyword, limit]() {
+        return CityService::instance().searchCities(keyword, limit);
+    });
+}
+
+QFuture<QList<NearbyCity>> AsyncDataService::nearestCities(double latitude, double longitude, int count)
+{
+    return QtConcurrent::run(&m_pool, [latitude, longitude, count]() {
+        return CityService::instance().nearestCities(latitude, longitude, count);
+    });
+}
+
+QFuture<bool> AsyncDataService::cityExists(const QString &cityId)
+{
+    return QtConcurrent::run(&m_pool, [cityId]() {
+        return CityService::instance().cityExists(cityId);
+    });
+}
+
+QFuture<QList<CityInfo>> AsyncDataService::favorites()
+{
+    return QtConcurrent::run(&m_pool, []() {
+        return CityDirectory::instance().favorites();
+    });
+}
+
+QFuture<bool> AsyncDataService::addCity(const CityInfo &city)
+{
+    return QtConcurrent::run(&m_pool, [city]() {
+        return CityService::instance().addCity(city);
+    });
+}
+
+QFuture<bool> AsyncDataService::addCities(const QList<CityInfo> &cities)
+{
+    return QtConcurrent::run(&m_pool, [cities]() {
+        return CityService::instance().addCities(cities);
+    });
+}
+
+QFuture<bool> AsyncDataService::deleteCity(const QString &cityId)
+{
+    return QtConcurrent::run(&m_pool, [cityId]() {
+        return CityService::instance().deleteCity(cityId);
+    });
+}
+
+QFuture<bool> AsyncDataService::setFavorite(const QString &cityId, bool favorite)
+{
+    return QtConcurrent::run(&m_pool, [cityId, favorite]() {
+        return CityService::instance().setFavorite(cityId, favorite);
+    });
+}
+
+QFuture<int> AsyncDataService::restoreWeatherSnapshots()
+{
+    return QtConcurrent::run(&m_pool, []() {
+        return WeatherStore::instance().restoreSnapshots();
+    });
+}
+
+QFuture<WeatherSnapshot> AsyncDataService::weatherSnapshot(const QString &cityId)
+{
+    return QtConcurrent::run(&m_pool, [cityId]() {
+        return WeatherStore::instance().snapshot(cityId);
+    });
+}
+
+QFuture<QHash<QString, WeatherSnapshot>> AsyncDataService::weatherSnapshots(const QStringList &cityIds)
+{
+    return QtConcurrent::run(&m_pool, [cityIds]() {
+        return WeatherStore::instance().snapshots(cityIds);
+    });
+}
+
+QFuture<QHash<QString, QList<RollupPoint>>> AsyncDataService::rollups(const QString &cityId,
+                                                                       const QStringList &metrics,
+                                                                       const QDateTime &from,
+                                                                       const QDateTime &to,
+                                                                       WeatherRollup::Resolution resolution)
+{
+    return QtConcurrent::run(&m_pool, [cityId, metrics, from, to, resolution]() {
+        QHash<QString, QList<RollupPoint>> result;
+        for (const QString &metric : metrics) {
+            result.insert(metric, WeatherRollup::query(cityId, metric, from, to, resolution));
+        }
+        return result;
+    });
+}
+
+QFuture<RetentionScan> AsyncDataService::retentionScan(const QList<RetentionPolicy> &policies,
+                                                       const QStringList &cutoffs,
+                                                       bool sampleSize)
+{
+    return QtConcurrent::run(&m_pool, [policies, cutoffs, sampleSize]() {
+        return RetentionManager::scan(policies, cutoffs, sampleSize);
+    });
+}
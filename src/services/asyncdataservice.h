@@ -0,0 +1,98 @@
+/**
+ * @file asyncdataservice.h
+ * @brief 异步数据访问服务
+ */
+
+#ifndef ASYNCDATASERVICE_H
+#define ASYNCDATASERVICE_H
+
+#include <QObject>
+#include <QFuture>
+#include <QThreadPool>
+#include <QHash>
+#include "cityservice.h"
+#include "citydirectory.h"
+#include "weatherstore.h"
+#include "weatherrollup.h"
+#include "../database/retentionmanager.h"
+
+/**
+ * @class AsyncDataService
+ * @brief 异步数据访问门面
+ * 
+ * 把 CityService / WeatherStore / WeatherRollup 的数据库访问放到专用的数据库线程执行，
+ * 立即返回 QFuture，界面代码通过 then(this, ...) 在主线程处理结果，
+ * 不会因 SQLite 磁盘读写而阻塞事件循环。
+ * 
+ * 所有调用在同一个线程中按提交顺序执行，先提交的写入一定在后提交的读取之前完成。
+ * 线程常驻，其数据库连接和预编译语句缓存在多次调用之间复用。
+ */
+class AsyncDataService : public QObject
+{
+    Q_OBJECT
+
+public:
+    static AsyncDataService& instance();
+    
+    // 城市查询
+    QFuture<CityInfo> getCity(const QString &cityId);
+    QFuture<QList<CityInfo>> getAllCities();
+    QFuture<QList<CityInfo>> getFavoriteCities();
+    QFuture<int> getCityCount();
+    QFuture<QList<CityInfo>> getCityPage(const QString &afterName, int afterId, int limit);
+    QFuture<QList<CityInfo>> searchCities(const QString &keyword, int limit = 50);
+    QFuture<QList<NearbyCity>> nearestCities(double latitude, double longitude, int count = 5);
+    QFuture<bool> cityExists(const QString &cityId);
+    
+    /**
+     * @brief 从 CityDirectory 获取收藏城市，目录尚未加载收藏时在数据库线程读取
+     */
+    QFuture<QList<CityInfo>> favorites();
+    
+    // 城市写入，信号仍由 CityService 发出并自动排队到接收者线程
+    QFuture<bool> addCity(const CityInfo &city);
+    QFuture<bool> addCities(const QList<CityInfo> &cities);
+    QFuture<bool> deleteCity(const QString &cityId);
+    QFuture<bool> setFavorite(const QString &cityId, bool favorite);
+    
+    /**
+     * @brief 从数据库恢复每个城市最近的实时天气，见 WeatherStore::restoreSnapshots
+     */
+    QFuture<int> restoreWeatherSnapshots();
+    
+    /**
+     * @brief 获取城市的天气快照
+     */
+    QFuture<WeatherSnapshot> weatherSnapshot(const QString &cityId);
+    
+    /**
+     * @brief 在一个任务中获取多个城市的天气快照
+     * @return cityId → 天气快照，没有数据的城市不包含在结果中
+     */
+    QFuture<QHash<QString, WeatherSnapshot>> weatherSnapshots(const QStringList &cityIds);
+    
+    /**
+     * @brief 查询多个指标的汇总数据
+     * @return 指标名 → 汇总点列表
+     */
+    QFuture<QHash<QString, QList<RollupPoint>>> rollups(const QString &cityId, const QStringList &metrics,
+                                                       const QDateTime &from, const QDateTime &to,
+                                                       WeatherRollup::Resolution resolution);
+    
+    /**
+     * @brief 探测过期数据和空闲页，见 RetentionManager::scan
+     */
+    QFuture<RetentionScan> retentionScan(const QList<RetentionPolicy> &policies, const QStringList &cutoffs,
+                                         bool sampleSize);
+
+private:
+    explicit AsyncDataService(QObject *parent = nullptr);
+    ~AsyncDataService();
+    
+    AsyncDataService(const AsyncDataService&) = delete;
+    AsyncDataService& operator=(const AsyncDataService&) = delete;
+    
+    QThreadPool m_pool;
+};
+
+#endif // ASYNCDATASERVICE_H
@@ -0,0 +1,158 @@
+/**
+ * @file citydirectory.cpp
+ * @brief 全局城市目录实现
+ */
+
+#include "citydirectory.h"
+#include "cityservice.h"
+#include <QDebug>
+#include <algorithm>
+
+CityDirectory::CityDirectory(QObject *parent)
+    : QObject(parent)
+{
+    // 直接连接：数据库写入线程发出信号时就更新，不等主线程事件循环
+    CityService &service = CityService::instance();
+    connect(&service, &CityService::cityAdded, this, &CityDirectory::onCityAdded, Qt::DirectConnection);
+    connect(&service, &CityService::cityUpdated, this, &CityDirectory::onCityUpdated, Qt::DirectConnection);
+    connect(&service, &CityService::cityDeleted, this, &CityDirectory::onCityDeleted, Qt::DirectConnection);
+    connect(&service, &CityService::favoriteChanged, this, &CityDirectory::onFavoriteChanged, Qt::DirectConnection);
+    connect(&service, &CityService::citiesAdded, this, &CityDirectory::onCitiesAdded, Qt::DirectConnection);
+}
+
+CityDirectory& CityDirectory::instance()
+{
+    static CityDirectory instance;
+    return instance;
+}
+
+CityInfo CityDirectory::city(const QString &cityId)
+{
+    CityInfo result;
+    if (lookup(cityId, result)) {
+        return result;
+    }
+    
+    // 查询期间不持锁，并发查询同一城市时最多多读一次
+    result = CityService::instance().getCity(cityId);
+    if (!result.cityId.isEmpty()) {
+        QWriteLocker locker(&m_lock);
+        store(result);
+    }
+    return result;
+}
+
+bool CityDirectory::lookup(const QString &cityId, CityInfo &city) const
+{
+    QReadLocker locker(&m_lock);
+    auto it = m_cities.constFind(cityId);
+    if (it == m_cities.constEnd()) {
+        return false;
+    }
+    city = it.value();
+    return true;
+}
+
+QString CityDirectory::cityName(const QString &cityId)
+{
+    CityInfo info = city(cityId);
+    return info.cityId.isEmpty() ? cityId : info.name;
+}
+
+QList<CityInfo> CityDirectory::favorites()
+{
+    loadFavorites();
+    
+    QList<CityInfo> result;
+    {
+        QReadLocker locker(&m_lock);
+        for (const CityInfo &city : m_cities) {
+            if (city.isFavorite) {
+                result.append(city);
+            }
+        }
+    }
+    
+    std::sort(result.begin(), result.end(), [](const CityInfo &a, const CityInfo &b) {
+        return a.favoriteOrder < b.favoriteOrder;
+    });
+    return result;
+}
+
+void CityDirectory::loadFavorites()
+{
+    {
+        QReadLocker locker(&m_lock);
+        if (m_favoritesLoaded) {
+            return;
+        }
+    }
+    
+    QList<CityInfo> favorites = CityService::instance().getFavoriteCities();
+    
+    QWriteLocker locker(&m_lock);
+    for (const CityInfo &city : std::as_const(favorites)) {
+        store(city);
+    }
+    m_favoritesLoaded = true;
+}
+
+void CityDirectory::store(const CityInfo &city)
+{
+    // 超过上限时丢弃非收藏城市，收藏城市始终保留
+    if (m_cities.size() >= MAX_CACHED_CITIES && !m_cities.contains(city.cityId)) {
+        m_cities.removeIf([](const QHash<QString, CityInfo>::iterator it) {
+            return !it.value().isFavorite;
+        });
+    }
+    m_cities.insert(city.cityId, city);
+}
+
+void CityDirectory::onCityAdded(const CityInfo &city)
+{
+    // 只预先放入收藏城市，其他城市等到查询时再读
+    if (city.isFavorite) {
+        QWriteLocker locker(&m_lock);
+        store(city);
+    }
+}
+
+void CityDirectory::onCityUpdated(const CityInfo &city)
+{
+    QWriteLocker locker(&m_lock);
+    auto it = m_cities.find(city.cityId);
+    if (it != m_cities.end()) {
+        CityInfo updated = city;
+        updated.id = it.value().id;
+        it.value() = updated;
+    }
+}
+
+void CityDirectory::onCityDeleted(const QString &cityId)
+{
+    QWriteLocker locker(&m_lock);
+    m_cities.remove(cityId);
+}
+
+void CityDirectory::onFavoriteChanged(const QString &cityId, bool isFavorite)
+{
+    // 在发出信号的线程中执行，收藏顺序以数据库为准
+    CityInfo city = CityService::instance().getCity(cityId);
+    
+    QWriteLocker locker(&m_lock);
+    if (city.cityId.isEmpty()) {
+        m_cities.remove(cityId);
+        return;
+    }
+    city.isFavorite = isFavorite;
+    store(city);
+}
+
+void CityDirectory::onCitiesAdded(int count)
+{
+    // 批量写入可能更新了已缓存城市的名称和坐标，全部作废后按需重新读取
+    QWriteLocker locker(&m_lock);
+    m_cities.clear();
+    m_favoritesLoaded = false;
+    qDebug() << "City directory cleared after" << count << "cities were written";
+}
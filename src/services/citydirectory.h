@@ -0,0 +1,82 @@
+/**
+ * @file citydirectory.h
+ * @brief 全局城市目录
+ */
+
+#ifndef CITYDIRECTORY_H
+#define CITYDIRECTORY_H
+
+#include <QObject>
+#include <QHash>
+#include <QReadWriteLock>
+#include "../models/citymodel.h"
+
+/**
+ * @class CityDirectory
+ * @brief 全局共享的城市信息目录
+ * 
+ * 按 cityId 解析城市名称、坐标等信息的统一入口，读多写少：
+ * - 收藏城市首次使用时一次读入并常驻，按收藏顺序提供
+ * - 其他城市在第一次查询时从数据库读取并缓存，缓存条目数有上限
+ * 
+ * 直接连接 CityService 的增删改和收藏信号，在发出信号的线程中立即更新，
+ * 之后任何线程读到的都是新数据。内部用读写锁保护，可在工作线程中调用。
+ */
+class CityDirectory : public QObject
+{
+    Q_OBJECT
+
+public:
+    static CityDirectory& instance();
+    
+    /**
+     * @brief 获取城市信息，未缓存时在调用线程的数据库连接上查询
+     * @return 城市不存在时返回空的 CityInfo
+     */
+    CityInfo city(const QString &cityId);
+    
+    /**
+     * @brief 只查缓存，不访问数据库
+     * @return 是否命中
+     */
+    bool lookup(const QString &cityId, CityInfo &city) const;
+    
+    /**
+     * @brief 城市名称，未找到时返回 cityId
+     */
+    QString cityName(const QString &cityId);
+    
+    /**
+     * @brief 收藏城市，按收藏顺序排列
+     */
+    QList<CityInfo> favorites();
+
+private slots:
+    // CityService 信号，直接连接
+    void onCityAdded(const CityInfo &city);
+    void onCityUpdated(const CityInfo &city);
+    void onCityDeleted(const QString &cityId);
+    void onFavoriteChanged(const QString &cityId, bool isFavorite);
+    void onCitiesAdded(int count);
+
+private:
+    explicit CityDirectory(QObject *parent = nullptr);
+    ~CityDirectory() = default;
+    
+    CityDirectory(const CityDirectory&) = delete;
+    CityDirectory& operator=(const CityDirectory&) = delete;
+    
+    /**
+     * @brief 写入缓存，调用方需持有写锁
+     */
+    void store(const CityInfo &city);
+    void loadFavorites();
+    
+    mutable QReadWriteLock m_lock;
+    QHash<QString, CityInfo> m_cities;      // cityId → 城市
+    bool m_favoritesLoaded = false;
+    
+    static const int MAX_CACHED_CITIES = 4096;
+};
+
+#endif // CITYDIRECTORY_H
@@ -5,10 +5,52 @@
 
 #include "cityservice.h"
 #include "../database/databasemanager.h"
+#include "../utils/pinyinutil.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
 #include <QDateTime>
+#include <QSet>
+#include <QtMath>
+#include <algorithm>
+
+// 与 cityFromQuery 的列顺序一致
+const QString CityService::CITY_COLUMNS =
+    "id, city_id, name, province, country, latitude, longitude, is_favorite, favorite_order";
+
+namespace {
+// 收藏城市在搜索排序中的加权，bm25 分值越小越相关
+const double FAVORITE_BOOST = 5.0;
+
+const double EARTH_RADIUS_KM = 6371.0;
+const double KM_PER_DEGREE = 111.32;            // 每度纬度的距离
+const double INITIAL_SEARCH_RADIUS_KM = 25.0;   // 最近城市的初始搜索半径
+const double MAX_SEARCH_RADIUS_KM = 20040.0;    // 半个赤道周长
+
+/**
+ * @brief 把用户输入转换为 FTS5 前缀查询
+ * 
+ * 每个词去掉 FTS5 语法字符后作为带引号的前缀短语，多个词之间为 AND：
+ * "bei jing" → "bei"* "jing"*
+ */
+QString ftsMatchExpression(const QString &keyword)
+{
+    QStringList terms;
+    const QStringList words = keyword.toLower().split(' ', Qt::SkipEmptyParts);
+    for (const QString &word : words) {
+        QString term;
+        for (const QChar &ch : word) {
+            if (ch.isLetterOrNumber()) {
+                term.append(ch);
+            }
+        }
+        if (!term.isEmpty()) {
+            terms.append("\"" + term + "\"*");
+        }
+    }
+    return terms.join(' ');
+}
+}
 
 CityService::CityService(QObject *parent)
     : QObject(parent)
@@ -31,9 +73,9 @@ bool CityService::addCity(const CityInfo &city)
     QSqlQuery query(DatabaseManager::instance().database());
     query.prepare(
         "INSERT INTO city (city_id, name, province, country, latitude, longitude, "
-        "is_favorite, favorite_order, create_time, update_time) "
+        "is_favorite, favorite_order, pinyin, pinyin_initials, create_time, update_time) "
         "VALUES (:city_id, :name, :province, :country, :latitude, :longitude, "
-        ":is_favorite, :favorite_order, :create_time, :update_time)"
+        ":is_favorite, :favorite_order, :pinyin, :pinyin_initials, :create_time, :update_time)"
     );
     
     query.bindValue(":city_id", city.cityId);
@@ -44,6 +86,8 @@ bool CityService::addCity(const CityInfo &city)
     query.bindValue(":longitude", city.longitude);
     query.bindValue(":is_favorite", city.isFavorite ? 1 : 0);
     query.bindValue(":favorite_order", city.favoriteOrder);
+    query.bindValue(":pinyin", PinyinUtil::fullPinyin(city.name));
+    query.bindValue(":pinyin_initials", PinyinUtil::initials(city.name));
     query.bindValue(":create_time", QDateTime::currentDateTime().toString(Qt::ISODate));
     query.bindValue(":update_time", QDateTime::currentDateTime().toString(Qt::ISODate));
     
@@ -54,7 +98,10 @@ bool CityService::addCity(const CityInfo &city)
         return false;
     }
     
-    emit cityAdded(city);
+    // 带上自增主键，模型可以按 (name, id) 确定新行的位置
+    CityInfo added = city;
+    added.id = query.lastInsertId().toInt();
+    emit cityAdded(added);
     return true;
 }
 
@@ -69,8 +116,8 @@ bool CityService::updateCity(const CityInfo &city)
     query.prepare(
         "UPDATE city SET name = :name, province = :province, country = :country, "
         "latitude = :latitude, longitude = :longitude, is_favorite = :is_favorite, "
-        "favorite_order = :favorite_order, update_time = :update_time "
-        "WHERE city_id = :city_id"
+        "favorite_order = :favorite_order, pinyin = :pinyin, pinyin_initials = :pinyin_initials, "
+        "update_time = :update_time WHERE city_id = :city_id"
     );
     
     query.bindValue(":city_id", city.cityId);
@@ -81,6 +128,8 @@ bool CityService::updateCity(const CityInfo &city)
     query.bindValue(":longitude", city.longitude);
     query.bindValue(":is_favorite", city.isFavorite ? 1 : 0);
     query.bindValue(":favorite_order", city.favoriteOrder);
+    query.bindValue(":pinyin", PinyinUtil::fullPinyin(city.name));
+    query.bindValue(":pinyin_initials", PinyinUtil::initials(city.name));
     query.bindValue(":update_time", QDateTime::currentDateTime().toString(Qt::ISODate));
     
     if (!query.exec()) {
@@ -122,14 +171,16 @@ bool CityService::cityExists(const QString &cityId)
         return false;
     }
     
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare("SELECT COUNT(*) FROM city WHERE city_id = :city_id");
-    query.bindValue(":city_id", cityId);
-    
-    if (query.exec() && query.next()) {
-        return query.value(0).toInt() > 0;
+    QSqlQuery *query = DatabaseManager::instance().cachedReadQuery(
+        "SELECT 1 FROM city WHERE city_id = :city_id LIMIT 1");
+    if (!query) {
+        return false;
     }
-    return false;
+    query->bindValue(":city_id", cityId);
+    
+    bool exists = query->exec() && query->next();
+    query->finish();
+    return exists;
 }
 
 CityInfo CityService::getCity(const QString &cityId)
@@ -139,88 +190,77 @@ CityInfo CityService::getCity(const QString &cityId)
         return city;
     }
     
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare(
-        "SELECT id, city_id, name, province, country, latitude, longitude, "
-        "is_favorite, favorite_order FROM city WHERE city_id = :city_id"
-    );
-    query.bindValue(":city_id", cityId);
+    // 每次获取天气都会调用（包括工作线程），使用本线程只读连接上缓存的预编译语句
+    QSqlQuery *query = DatabaseManager::instance().cachedReadQuery(
+        "SELECT " + CITY_COLUMNS + " FROM city WHERE city_id = :city_id");
+    if (!query) {
+        return city;
+    }
+    query->bindValue(":city_id", cityId);
     
-    if (query.exec() && query.next()) {
-        city.id = query.value(0).toInt();
-        city.cityId = query.value(1).toString();
-        city.name = query.value(2).toString();
-        city.province = query.value(3).toString();
-        city.country = query.value(4).toString();
-        city.latitude = query.value(5).toDouble();
-        city.longitude = query.value(6).toDouble();
-        city.isFavorite = query.value(7).toBool();
-        city.favoriteOrder = query.value(8).toInt();
+    if (query->exec() && query->next()) {
+        city = cityFromQuery(*query);
     }
+    query->finish();
     return city;
 }
 
 QList<CityInfo> CityService::getAllCities()
 {
-    QList<CityInfo> cities;
     if (!DatabaseManager::instance().isConnected()) {
-        return cities;
+        return QList<CityInfo>();
     }
     
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare(
-        "SELECT id, city_id, name, province, country, latitude, longitude, "
-        "is_favorite, favorite_order FROM city ORDER BY name"
-    );
-    
-    if (query.exec()) {
-        while (query.next()) {
-            CityInfo city;
-            city.id = query.value(0).toInt();
-            city.cityId = query.value(1).toString();
-            city.name = query.value(2).toString();
-            city.province = query.value(3).toString();
-            city.country = query.value(4).toString();
-            city.latitude = query.value(5).toDouble();
-            city.longitude = query.value(6).toDouble();
-            city.isFavorite = query.value(7).toBool();
-            city.favoriteOrder = query.value(8).toInt();
-            cities.append(city);
-        }
-    }
-    return cities;
+    QSqlQuery *query = DatabaseManager::instance().cachedReadQuery(
+        "SELECT " + CITY_COLUMNS + " FROM city ORDER BY name");
+    return queryCities(query);
 }
 
 QList<CityInfo> CityService::getFavoriteCities()
 {
-    QList<CityInfo> cities;
     if (!DatabaseManager::instance().isConnected()) {
-        return cities;
+        return QList<CityInfo>();
     }
     
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare(
-        "SELECT id, city_id, name, province, country, latitude, longitude, "
-        "is_favorite, favorite_order FROM city WHERE is_favorite = 1 "
-        "ORDER BY favorite_order"
-    );
+    QSqlQuery *query = DatabaseManager::instance().cachedReadQuery(
+        "SELECT " + CITY_COLUMNS + " FROM city WHERE is_favorite = 1 "
+        "ORDER BY favorite_order");
+    return queryCities(query);
+}
+
+int CityService::getCityCount()
+{
+    if (!DatabaseManager::instance().isConnected()) {
+        return 0;
+    }
     
-    if (query.exec()) {
-        while (query.next()) {
-            CityInfo city;
-            city.id = query.value(0).toInt();
-            city.cityId = query.value(1).toString();
-            city.name = query.value(2).toString();
-            city.province = query.value(3).toString();
-            city.country = query.value(4).toString();
-            city.latitude = query.value(5).toDouble();
-            city.longitude = query.value(6).toDouble();
-            city.isFavorite = query.value(7).toBool();
-            city.favoriteOrder = query.value(8).toInt();
-            cities.append(city);
-        }
+    QSqlQuery *query = DatabaseManager::instance().cachedReadQuery("SELECT COUNT(*) FROM city");
+    int count = 0;
+    if (query && query->exec() && query->next()) {
+        count = query->value(0).toInt();
     }
-    return cities;
+    if (query) {
+        query->finish();
+    }
+    return count;
+}
+
+QList<CityInfo> CityService::getCityPage(const QString &afterName, int afterId, int limit)
+{
+    if (!DatabaseManager::instance().isConnected()) {
+        return QList<CityInfo>();
+    }
+    
+    QSqlQuery *query = DatabaseManager::instance().cachedReadQuery(
+        "SELECT " + CITY_COLUMNS + " FROM city "
+        "WHERE is_favorite = 0 AND (name, id) > (:name, :id) "
+        "ORDER BY name, id LIMIT :limit");
+    if (query) {
+        query->bindValue(":name", afterName);
+        query->bindValue(":id", afterId);
+        query->bindValue(":limit", limit);
+    }
+    return queryCities(query);
 }
 
 bool CityService::setFavorite(const QString &cityId, bool favorite)
@@ -312,17 +352,73 @@ bool CityService::addCities(const QList<CityInfo> &cities)
         return false;
     }
     
-    QSqlDatabase db = DatabaseManager::instance().database();
+    QSqlDatabase &db = DatabaseManager::instance().database();
     db.transaction();
     
+    int inserted = insertCities(cities);
+    if (inserted != cities.size()) {
+        db.rollback();
+        return false;
+    }
+    
+    if (!db.commit()) {
+        return false;
+    }
+    
+    // 批量写入只发出一次通知
+    emit citiesAdded(inserted);
+    return true;
+}
+
+void CityService::notifyCitiesAdded(int count)
+{
+    if (count > 0) {
+        emit citiesAdded(count);
+    }
+}
+
+int CityService::insertCities(const QList<CityInfo> &cities)
+{
+    if (!DatabaseManager::instance().isConnected()) {
+        return 0;
+    }
+    
+    QSqlQuery *query = DatabaseManager::instance().cachedQuery(
+        "INSERT INTO city (city_id, name, province, country, latitude, longitude, "
+        "is_favorite, favorite_order, pinyin, pinyin_initials, create_time, update_time) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?) "
+        "ON CONFLICT(city_id) DO UPDATE SET name = excluded.name, province = excluded.province, "
+        "country = excluded.country, latitude = excluded.latitude, longitude = excluded.longitude, "
+        "pinyin = excluded.pinyin, pinyin_initials = excluded.pinyin_initials, "
+        "update_time = excluded.update_time");
+    if (!query) {
+        return 0;
+    }
+    
+    QString now = QDateTime::currentDateTime().toString(Qt::ISODate);
+    int inserted = 0;
     for (const CityInfo &city : cities) {
-        if (!addCity(city)) {
-            db.rollback();
-            return false;
+        query->addBindValue(city.cityId);
+        query->addBindValue(city.name);
+        query->addBindValue(city.province);
+        query->addBindValue(city.country);
+        query->addBindValue(city.latitude);
+        query->addBindValue(city.longitude);
+        query->addBindValue(city.isFavorite ? 1 : 0);
+        query->addBindValue(city.favoriteOrder);
+        query->addBindValue(PinyinUtil::fullPinyin(city.name));
+        query->addBindValue(PinyinUtil::initials(city.name));
+        query->addBindValue(now);
+        query->addBindValue(now);
+        
+        if (query->exec()) {
+            ++inserted;
+        } else {
+            qWarning() << "Failed to insert city" << city.cityId << ":" << query->lastError().text();
         }
     }
-    
-    return db.commit();
+    query->finish();
+    return inserted;
 }
 
 bool CityService::clearAllCities()
@@ -337,35 +433,206 @@ bool CityService::clearAllCities()
 
 QList<CityInfo> CityService::searchCities(const QString &keyword, int limit)
 {
-    QList<CityInfo> cities;
     if (!DatabaseManager::instance().isConnected() || keyword.isEmpty()) {
+        return QList<CityInfo>();
+    }
+    
+    DatabaseManager &db = DatabaseManager::instance();
+    
+    // 全文索引按名称、省份、全拼、拼音首字母做前缀匹配，
+    // 名称和拼音命中的权重高于省份，收藏城市额外加权
+    QList<CityInfo> cities;
+    QString match = ftsMatchExpression(keyword);
+    if (db.hasFullTextSearch() && !match.isEmpty()) {
+        QSqlQuery *query = db.cachedReadQuery(
+            "SELECT " + CITY_COLUMNS + " FROM city "
+            "JOIN (SELECT rowid AS fts_id, bm25(city_fts, 10.0, 2.0, 8.0, 6.0) AS score "
+            "      FROM city_fts WHERE city_fts MATCH :match) ON id = fts_id "
+            "ORDER BY score - is_favorite * :boost, name LIMIT :limit");
+        if (query) {
+            query->bindValue(":match", match);
+            query->bindValue(":boost", FAVORITE_BOOST);
+            query->bindValue(":limit", limit);
+        }
+        cities = queryCities(query);
+    }
+    
+    // 前缀匹配不到（如只输入城市名中间的字）或没有全文索引时退回子串匹配
+    if (cities.isEmpty()) {
+        QSqlQuery *query = db.cachedReadQuery(
+            "SELECT " + CITY_COLUMNS + " FROM city "
+            "WHERE name LIKE :keyword OR province LIKE :keyword OR pinyin LIKE :keyword "
+            "ORDER BY is_favorite DESC, name LIMIT :limit");
+        if (query) {
+            query->bindValue(":keyword", "%" + keyword + "%");
+            query->bindValue(":limit", limit);
+        }
+        return queryCities(query);
+    }
+    
+    // 前缀匹配有结果时，中间片段的命中（如 jing 命中 beijing）由 trigram 索引补在后面，
+    // 不做全表扫描；trigram 至少需要三个字符
+    QString fragment = keyword.trimmed();
+    if (!db.hasSubstringSearch() || fragment.size() < 3 || (limit >= 0 && cities.size() >= limit)) {
         return cities;
     }
     
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare(
-        "SELECT id, city_id, name, province, country, latitude, longitude, "
-        "is_favorite, favorite_order FROM city "
-        "WHERE name LIKE :keyword OR province LIKE :keyword "
-        "ORDER BY is_favorite DESC, name LIMIT :limit"
-    );
-    query.bindValue(":keyword", "%" + keyword + "%");
-    query.bindValue(":limit", limit);
-    
-    if (query.exec()) {
-        while (query.next()) {
-            CityInfo city;
-            city.id = query.value(0).toInt();
-            city.cityId = query.value(1).toString();
-            city.name = query.value(2).toString();
-            city.province = query.value(3).toString();
-            city.country = query.value(4).toString();
-            city.latitude = query.value(5).toDouble();
-            city.longitude = query.value(6).toDouble();
-            city.isFavorite = query.value(7).toBool();
-            city.favoriteOrder = query.value(8).toInt();
+    QSqlQuery *query = db.cachedReadQuery(
+        "SELECT " + CITY_COLUMNS + " FROM city "
+        "WHERE id IN (SELECT rowid FROM city_trigram WHERE city_trigram MATCH :match LIMIT :limit)");
+    if (query) {
+        query->bindValue(":match", "\"" + fragment.replace('"', "\"\"") + "\"");
+        query->bindValue(":limit", limit < 0 ? -1 : limit + cities.size());
+    }
+    
+    QSet<int> seen;
+    for (const CityInfo &city : cities) {
+        seen.insert(city.id);
+    }
+    const QList<CityInfo> infixMatches = queryCities(query);
+    for (const CityInfo &city : infixMatches) {
+        if (limit >= 0 && cities.size() >= limit) {
+            break;
+        }
+        if (!seen.contains(city.id)) {
+            seen.insert(city.id);
             cities.append(city);
         }
     }
     return cities;
 }
+
+QList<CityInfo> CityService::citiesInBoundingBox(double minLat, double minLon, double maxLat, double maxLon,
+                                                 int limit)
+{
+    if (!DatabaseManager::instance().isConnected()) {
+        return QList<CityInfo>();
+    }
+    
+    // 跨越 180° 经线时拆成两个矩形
+    if (minLon > maxLon) {
+        QList<CityInfo> cities = citiesInBoundingBox(minLat, minLon, maxLat, 180.0, limit);
+        if (limit < 0 || cities.size() < limit) {
+            cities += citiesInBoundingBox(minLat, -180.0, maxLat, maxLon,
+                                          limit < 0 ? -1 : limit - cities.size());
+        }
+        return cities;
+    }
+    
+    // R*Tree 以单精度向外取整保存坐标，命中后再用原始坐标精确过滤
+    DatabaseManager &db = DatabaseManager::instance();
+    QString candidates = db.hasSpatialIndex()
+        ? "id IN (SELECT id FROM city_rtree WHERE min_lat <= :max_lat AND max_lat >= :min_lat "
+          "AND min_lon <= :max_lon AND max_lon >= :min_lon) AND "
+        : "";
+    
+    QSqlQuery *query = db.cachedReadQuery(
+        "SELECT " + CITY_COLUMNS + " FROM city WHERE " + candidates +
+        "latitude BETWEEN :min_lat AND :max_lat AND longitude BETWEEN :min_lon AND :max_lon "
+        "ORDER BY is_favorite DESC LIMIT :limit");
+    if (query) {
+        query->bindValue(":min_lat", minLat);
+        query->bindValue(":max_lat", maxLat);
+        query->bindValue(":min_lon", minLon);
+        query->bindValue(":max_lon", maxLon);
+        query->bindValue(":limit", limit);
+    }
+    return queryCities(query);
+}
+
+QList<NearbyCity> CityService::nearestCities(double latitude, double longitude, int count,
+                                             double maxDistanceKm)
+{
+    QList<NearbyCity> result;
+    if (count <= 0 || !DatabaseManager::instance().isConnected()) {
+        return result;
+    }
+    
+    double limitKm = maxDistanceKm > 0 ? qMin(maxDistanceKm, MAX_SEARCH_RADIUS_KM) : MAX_SEARCH_RADIUS_KM;
+    double radiusKm = qMin(INITIAL_SEARCH_RADIUS_KM, limitKm);
+    
+    forever {
+        // 包含半径为 radiusKm 的圆的经纬度矩形，经度跨度按离赤道最远的纬度计算
+        double dLat = radiusKm / KM_PER_DEGREE;
+        double minLat = qMax(-90.0, latitude - dLat);
+        double maxLat = qMin(90.0, latitude + dLat);
+        double cosLat = qCos(qDegreesToRadians(qMax(qAbs(minLat), qAbs(maxLat))));
+        
+        double minLon = -180.0;
+        double maxLon = 180.0;
+        if (cosLat > 1e-6 && radiusKm / (KM_PER_DEGREE * cosLat) < 180.0) {
+            double dLon = radiusKm / (KM_PER_DEGREE * cosLat);
+            minLon = longitude - dLon;
+            maxLon = longitude + dLon;
+            if (minLon < -180.0) minLon += 360.0;
+            if (maxLon > 180.0) maxLon -= 360.0;
+        }
+        
+        // 矩形的角落可能比圆外的城市更远，只保留圆内的城市
+        result.clear();
+        const QList<CityInfo> candidates = citiesInBoundingBox(minLat, minLon, maxLat, maxLon, -1);
+        for (const CityInfo &city : candidates) {
+            double distance = distanceKm(latitude, longitude, city.latitude, city.longitude);
+            if (distance <= radiusKm) {
+                result.append({city, distance});
+            }
+        }
+        
+        if (result.size() >= count || radiusKm >= limitKm) {
+            break;
+        }
+        radiusKm = qMin(radiusKm * 4, limitKm);
+    }
+    
+    std::sort(result.begin(), result.end(), [](const NearbyCity &a, const NearbyCity &b) {
+        return a.distanceKm < b.distanceKm;
+    });
+    if (result.size() > count) {
+        result.resize(count);
+    }
+    return result;
+}
+
+double CityService::distanceKm(double lat1, double lon1, double lat2, double lon2)
+{
+    // 半正矢公式
+    double dLat = qDegreesToRadians(lat2 - lat1);
+    double dLon = qDegreesToRadians(lon2 - lon1);
+    double a = qSin(dLat / 2) * qSin(dLat / 2)
+               + qCos(qDegreesToRadians(lat1)) * qCos(qDegreesToRadians(lat2)) * qSin(dLon / 2) * qSin(dLon / 2);
+    return 2 * EARTH_RADIUS_KM * qAsin(qMin(1.0, qSqrt(a)));
+}
+
+CityInfo CityService::cityFromQuery(const QSqlQuery &query)
+{
+    CityInfo city;
+    city.id = query.value(0).toInt();
+    city.cityId = query.value(1).toString();
+    city.name = query.value(2).toString();
+    city.province = query.value(3).toString();
+    city.country = query.value(4).toString();
+    city.latitude = query.value(5).toDouble();
+    city.longitude = query.value(6).toDouble();
+    city.isFavorite = query.value(7).toBool();
+    city.favoriteOrder = query.value(8).toInt();
+    return city;
+}
+
+QList<CityInfo> CityService::queryCities(QSqlQuery *query)
+{
+    QList<CityInfo> cities;
+    if (!query) {
+        return cities;
+    }
+    
+    if (query->exec()) {
+        while (query->next()) {
+            cities.append(cityFromQuery(*query));
+        }
+    } else {
+        qWarning() << "Failed to query cities:" << query->lastError().text();
+    }
+    // 释放结果集，语句留在缓存中复用
+    query->finish();
+    return cities;
+}
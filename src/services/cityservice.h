@@ -9,6 +9,17 @@
 #include <QObject>
 #include "../models/citymodel.h"
 
+class QSqlQuery;
+
+/**
+ * @struct NearbyCity
+ * @brief 附近城市查询结果
+ */
+struct NearbyCity {
+    CityInfo city;
+    double distanceKm = 0;
+};
+
 /**
  * @class CityService
  * @brief 城市数据服务类
@@ -30,6 +41,18 @@ public:
     CityInfo getCity(const QString &cityId);
     QList<CityInfo> getAllCities();
     QList<CityInfo> getFavoriteCities();
+    int getCityCount();
+    
+    /**
+     * @brief 按名称分页读取非收藏城市（键集分页）
+     * 
+     * 以上一页最后一行的 (name, id) 为起点，走 (is_favorite, name, id) 索引，
+     * 翻到任何位置的代价都与页大小有关，与偏移量无关
+     * @param afterName 上一页最后一行的名称，第一页传空字符串
+     * @param afterId 上一页最后一行的 id，第一页传 0
+     * @param limit 页大小
+     */
+    QList<CityInfo> getCityPage(const QString &afterName, int afterId, int limit);
     
     // 收藏操作
     bool setFavorite(const QString &cityId, bool favorite);
@@ -41,11 +64,63 @@ public:
     bool addCities(const QList<CityInfo> &cities);
     bool clearAllCities();
     
+    /**
+     * @brief 批量写入城市，已存在的城市更新名称和坐标，保留收藏状态
+     * 
+     * 使用当前线程连接上缓存的同一条预编译语句，不开启事务、不发出逐行信号，
+     * 供 addCities 和后台导入在各自的事务中调用
+     * @param cities 城市列表
+     * @return 成功写入的行数
+     */
+    int insertCities(const QList<CityInfo> &cities);
+    
+    /**
+     * @brief 调用方提交了包含 insertCities 的事务后调用，发出 citiesAdded
+     * @param count 本次事务写入的行数
+     */
+    void notifyCitiesAdded(int count);
+    
     // 搜索
     QList<CityInfo> searchCities(const QString &keyword, int limit = 50);
+    
+    /**
+     * @brief 查询矩形范围内的城市，收藏城市优先
+     * 
+     * minLon 大于 maxLon 时表示范围跨越 180° 经线
+     * @param limit 最多返回的数量，-1 表示不限
+     */
+    QList<CityInfo> citiesInBoundingBox(double minLat, double minLon, double maxLat, double maxLon,
+                                        int limit = 1000);
+    
+    /**
+     * @brief 查询距离某点最近的城市（离线逆地理编码）
+     * 
+     * 以该点为中心逐步扩大搜索范围，按球面距离由近到远返回
+     * @param count 返回的数量
+     * @param maxDistanceKm 最大距离，0 表示不限
+     */
+    QList<NearbyCity> nearestCities(double latitude, double longitude, int count = 5,
+                                    double maxDistanceKm = 0);
+    
+    /**
+     * @brief 两点间的球面距离（公里）
+     */
+    static double distanceKm(double lat1, double lon1, double lat2, double lon2);
+    
+    /**
+     * @brief 查询城市时选择的列，顺序与 cityFromQuery 对应
+     */
+    static const QString CITY_COLUMNS;
+    
+    /**
+     * @brief 把查询结果的当前行映射为 CityInfo
+     * @param query 已定位到有效行、按 CITY_COLUMNS 选择列的查询
+     */
+    static CityInfo cityFromQuery(const QSqlQuery &query);
 
 signals:
     void cityAdded(const CityInfo &city);
+    void citiesAdded(int count);
     void cityUpdated(const CityInfo &city);
     void cityDeleted(const QString &cityId);
     void favoriteChanged(const QString &cityId, bool isFavorite);
@@ -57,6 +132,11 @@ private:
     
     CityService(const CityService&) = delete;
     CityService& operator=(const CityService&) = delete;
+    
+    /**
+     * @brief 执行查询并映射所有行，完成后释放结果集
+     */
+    QList<CityInfo> queryCities(QSqlQuery *query);
 };
 
 #endif // CITYSERVICE_H
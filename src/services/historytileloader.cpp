@@ -0,0 +1,177 @@
+/**
+ * @file historytileloader.cpp
+ * @brief 历史曲线分块加载器实现
+ */
+
+#include "historytileloader.h"
+#include "asyncdataservice.h"
+
+HistoryTileLoader::HistoryTileLoader(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void HistoryTileLoader::setCity(const QString &cityId)
+{
+    m_cityId = cityId;
+    m_tiles.clear();
+    m_pending.clear();
+    m_lastTile = m_firstTile - 1;
+    ++m_generation;
+}
+
+void HistoryTileLoader::setView(const QString &metric, const QDateTime &from, const QDateTime &to, int maxPoints)
+{
+    m_metric = metric;
+    m_from = from;
+    m_to = to;
+    m_resolution = WeatherRollup::chooseResolution(from, to, maxPoints);
+    m_firstTile = tileIndex(m_resolution, from);
+    m_lastTile = tileIndex(m_resolution, to);
+    
+    if (m_cityId.isEmpty()) {
+        return;
+    }
+    
+    for (qint64 index = m_firstTile; index <= m_lastTile; ++index) {
+        touchTile(keyOf(index));
+    }
+    
+    // 预取两侧相邻的块
+    touchTile(keyOf(m_firstTile - 1));
+    touchTile(keyOf(m_lastTile + 1));
+    
+    evictTiles();
+}
+
+QList<RollupPoint> HistoryTileLoader::visiblePoints() const
+{
+    QList<RollupPoint> points;
+    QDateTime from = WeatherRollup::bucketStart(m_from, m_resolution);
+    
+    for (qint64 index = m_firstTile; index <= m_lastTile; ++index) {
+        auto it = m_tiles.constFind(keyOf(index));
+        if (it == m_tiles.constEnd()) {
+            continue;
+        }
+        for (const RollupPoint &point : it->points) {
+            if (point.bucketStart >= from && point.bucketStart < m_to) {
+                points.append(point);
+            }
+        }
+    }
+    return points;
+}
+
+bool HistoryTileLoader::isComplete() const
+{
+    for (qint64 index = m_firstTile; index <= m_lastTile; ++index) {
+        if (!m_tiles.contains(keyOf(index))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+qint64 HistoryTileLoader::tileIndex(WeatherRollup::Resolution resolution, const QDateTime &time)
+{
+    const qint64 tileSeconds = WeatherRollup::bucketSeconds(resolution) * TILE_BUCKETS;
+    const qint64 secs = time.toSecsSinceEpoch();
+    qint64 index = secs / tileSeconds;
+    if (secs < 0 && secs % tileSeconds != 0) {
+        --index;
+    }
+    
+    // 块起点向前对齐到时间桶，落在下一块对齐后范围内的时间归下一块
+    if (time >= tileStart(resolution, index + 1)) {
+        ++index;
+    }
+    return index;
+}
+
+QDateTime HistoryTileLoader::tileStart(WeatherRollup::Resolution resolution, qint64 index)
+{
+    const qint64 tileSeconds = WeatherRollup::bucketSeconds(resolution) * TILE_BUCKETS;
+    return WeatherRollup::bucketStart(QDateTime::fromSecsSinceEpoch(index * tileSeconds), resolution);
+}
+
+HistoryTileLoader::TileKey HistoryTileLoader::keyOf(qint64 index) const
+{
+    TileKey key;
+    key.metric = m_metric;
+    key.resolution = int(m_resolution);
+    key.index = index;
+    return key;
+}
+
+bool HistoryTileLoader::isVisible(const TileKey &key) const
+{
+    return key.metric == m_metric && key.resolution == int(m_resolution)
+        && key.index >= m_firstTile && key.index <= m_lastTile;
+}
+
+void HistoryTileLoader::touchTile(const TileKey &key)
+{
+    auto it = m_tiles.find(key);
+    if (it == m_tiles.end()) {
+        requestTile(key);
+        return;
+    }
+    it->lastUsed = ++m_useCounter;
+    
+    // 包含当前时间的块可能已有新观测写入
+    QDateTime now = QDateTime::currentDateTime();
+    WeatherRollup::Resolution resolution = static_cast<WeatherRollup::Resolution>(key.resolution);
+    if (tileStart(resolution, key.index + 1) > it->loadedAt
+        && it->loadedAt.secsTo(now) > LATEST_TILE_REFRESH_SECS) {
+        requestTile(key);
+    }
+}
+
+void HistoryTileLoader::requestTile(const TileKey &key)
+{
+    if (m_pending.contains(key)) {
+        return;
+    }
+    m_pending.insert(key);
+    
+    WeatherRollup::Resolution resolution = static_cast<WeatherRollup::Resolution>(key.resolution);
+    QDateTime from = tileStart(resolution, key.index);
+    QDateTime to = tileStart(resolution, key.index + 1);
+    int generation = m_generation;
+    
+    AsyncDataService::instance().rollups(m_cityId, {key.metric}, from, to, resolution)
+        .then(this, [this, key, generation](const QHash<QString, QList<RollupPoint>> &rollups) {
+            if (generation != m_generation) {
+                return;
+            }
+            m_pending.remove(key);
+            
+            Tile tile;
+            tile.points = rollups.value(key.metric);
+            tile.loadedAt = QDateTime::currentDateTime();
+            tile.lastUsed = ++m_useCounter;
+            m_tiles.insert(key, tile);
+            evictTiles();
+            
+            if (isVisible(key)) {
+                emit tilesLoaded();
+            }
+        });
+}
+
+void HistoryTileLoader::evictTiles()
+{
+    while (m_tiles.size() > MAX_CACHED_TILES) {
+        auto oldest = m_tiles.end();
+        for (auto it = m_tiles.begin(); it != m_tiles.end(); ++it) {
+            if (!isVisible(it.key()) && (oldest == m_tiles.end() || it->lastUsed < oldest->lastUsed)) {
+                oldest = it;
+            }
+        }
+        if (oldest == m_tiles.end()) {
+            break;
+        }
+        m_tiles.erase(oldest);
+    }
+}
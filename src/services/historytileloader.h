@@ -0,0 +1,117 @@
+/**
+ * @file historytileloader.h
+ * @brief 历史曲线分块加载器
+ */
+
+#ifndef HISTORYTILELOADER_H
+#define HISTORYTILELOADER_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QDateTime>
+#include "weatherrollup.h"
+
+/**
+ * @class HistoryTileLoader
+ * @brief 按可见范围分块读取汇总数据
+ * 
+ * weather_rollup 的 小时/日/周/月 四级汇总构成多分辨率金字塔。每级分辨率按
+ * TILE_BUCKETS 个时间桶切成固定的数据块，块边界对齐到时间桶起点，相邻块互不重叠。
+ * 
+ * 可见范围变化时按点数上限选择分辨率，只在数据库线程读取缺少的块，
+ * 同时预取两侧相邻的块，平移时通常直接命中缓存。缓存块数有上限，按最久未使用淘汰。
+ * 包含当前时间的块会定期重新读取，以显示新写入的观测。
+ */
+class HistoryTileLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HistoryTileLoader(QObject *parent = nullptr);
+    
+    /**
+     * @brief 切换城市，清空缓存并丢弃尚未返回的读取
+     */
+    void setCity(const QString &cityId);
+    
+    /**
+     * @brief 设置可见范围，读取缺少的数据块
+     * @param metric 指标名（weather_current 中的列名）
+     * @param from 起始时间
+     * @param to 结束时间
+     * @param maxPoints 最大点数，通常为绘图区宽度
+     */
+    void setView(const QString &metric, const QDateTime &from, const QDateTime &to, int maxPoints);
+    
+    /**
+     * @brief 可见范围内已读取的汇总点，按时间排序
+     */
+    QList<RollupPoint> visiblePoints() const;
+    
+    /**
+     * @brief 可见范围的数据块是否都已读取
+     */
+    bool isComplete() const;
+    
+    WeatherRollup::Resolution resolution() const { return m_resolution; }
+
+signals:
+    /**
+     * @brief 可见范围内有数据块读取完成
+     */
+    void tilesLoaded();
+
+private:
+    struct TileKey {
+        QString metric;
+        int resolution = 0;
+        qint64 index = 0;
+        
+        bool operator==(const TileKey &other) const {
+            return index == other.index && resolution == other.resolution && metric == other.metric;
+        }
+        friend size_t qHash(const TileKey &key, size_t seed = 0) {
+            return qHashMulti(seed, key.metric, key.resolution, key.index);
+        }
+    };
+    
+    struct Tile {
+        QList<RollupPoint> points;
+        QDateTime loadedAt;
+        quint64 lastUsed = 0;
+    };
+    
+    // 数据块的编号和起点，块 i 覆盖 [tileStart(i), tileStart(i + 1))
+    static qint64 tileIndex(WeatherRollup::Resolution resolution, const QDateTime &time);
+    static QDateTime tileStart(WeatherRollup::Resolution resolution, qint64 index);
+    
+    TileKey keyOf(qint64 index) const;
+    bool isVisible(const TileKey &key) const;
+    
+    /**
+     * @brief 标记数据块被使用，未缓存或已过期时发起读取
+     */
+    void touchTile(const TileKey &key);
+    void requestTile(const TileKey &key);
+    void evictTiles();
+    
+    QString m_cityId;
+    QString m_metric;
+    QDateTime m_from;
+    QDateTime m_to;
+    WeatherRollup::Resolution m_resolution = WeatherRollup::Hour;
+    qint64 m_firstTile = 0;
+    qint64 m_lastTile = -1;             // 小于 m_firstTile 表示没有可见范围
+    
+    QHash<TileKey, Tile> m_tiles;
+    QSet<TileKey> m_pending;
+    int m_generation = 0;               // 切换城市后递增，丢弃旧请求的结果
+    quint64 m_useCounter = 0;
+    
+    static const int TILE_BUCKETS = 256;
+    static const int MAX_CACHED_TILES = 64;
+    static const int LATEST_TILE_REFRESH_SECS = 600;
+};
+
+#endif // HISTORYTILELOADER_H
@@ -0,0 +1,185 @@
+/**
+ * @file weatherrollup.cpp
+ * @brief 天气时间序列多分辨率汇总实现
+ */
+
+#include "weatherrollup.h"
+#include "../database/databasemanager.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+namespace {
+const char *DATETIME_FORMAT = "yyyy-MM-dd hh:mm:ss";
+
+QString formatTime(const QDateTime &time)
+{
+    return time.toString(DATETIME_FORMAT);
+}
+}
+
+QStringList WeatherRollup::metrics()
+{
+    return {"temperature", "humidity", "pressure", "wind_speed"};
+}
+
+QList<DbStatement> WeatherRollup::refreshStatements(const QString &cityId, const QDateTime &observationTime)
+{
+    QList<DbStatement> statements;
+    if (cityId.isEmpty() || !observationTime.isValid()) {
+        return statements;
+    }
+    
+    // 小时桶：从原始观测重算，每个指标一个 UNION ALL 分支
+    QDateTime hourStart = bucketStart(observationTime, Hour);
+    QDateTime hourEnd = bucketEnd(hourStart, Hour);
+    
+    QStringList branches;
+    QVariantList hourValues;
+    for (const QString &metric : metrics()) {
+        branches.append(QString(
+            "SELECT city_id, %1, ?, '%2', MIN(%2), MAX(%2), SUM(%2), COUNT(%2) "
+            "FROM weather_current "
+            "WHERE city_id = ? AND observation_time >= ? AND observation_time < ? "
+            "AND %2 IS NOT NULL GROUP BY city_id").arg(int(Hour)).arg(metric));
+        hourValues << formatTime(hourStart) << cityId << formatTime(hourStart) << formatTime(hourEnd);
+    }
+    statements.append({
+        "INSERT OR REPLACE INTO weather_rollup (city_id, resolution, bucket_start, metric, "
+        "min_value, max_value, sum_value, sample_count) " + branches.join(" UNION ALL "),
+        hourValues
+    });
+    
+    // 日/周/月桶：从下一级汇总合并，与指标无关
+    static const QString mergeSql =
+        "INSERT OR REPLACE INTO weather_rollup (city_id, resolution, bucket_start, metric, "
+        "min_value, max_value, sum_value, sample_count) "
+        "SELECT city_id, ?, ?, metric, MIN(min_value), MAX(max_value), SUM(sum_value), SUM(sample_count) "
+        "FROM weather_rollup "
+        "WHERE city_id = ? AND resolution = ? AND bucket_start >= ? AND bucket_start < ? "
+        "GROUP BY city_id, metric";
+    
+    struct Level {
+        Resolution target;
+        Resolution source;
+    };
+    // 周和月都由日桶合并，避免周跨月带来的误差
+    const Level levels[] = {{Day, Hour}, {Week, Day}, {Month, Day}};
+    
+    for (const Level &level : levels) {
+        QDateTime start = bucketStart(observationTime, level.target);
+        QDateTime end = bucketEnd(start, level.target);
+        statements.append({mergeSql, {
+            int(level.target), formatTime(start), cityId, int(level.source),
+            formatTime(start), formatTime(end)
+        }});
+    }
+    
+    return statements;
+}
+
+WeatherRollup::Resolution WeatherRollup::chooseResolution(const QDateTime &from, const QDateTime &to, int maxPoints)
+{
+    qint64 span = qMax<qint64>(0, from.secsTo(to));
+    for (Resolution resolution : {Hour, Day, Week}) {
+        if (span / bucketSeconds(resolution) <= maxPoints) {
+            return resolution;
+        }
+    }
+    return Month;
+}
+
+QList<RollupPoint> WeatherRollup::query(const QString &cityId, const QString &metric,
+                                        const QDateTime &from, const QDateTime &to,
+                                        Resolution resolution)
+{
+    QList<RollupPoint> points;
+    if (!DatabaseManager::instance().isConnected()) {
+        return points;
+    }
+    
+    QSqlQuery *query = DatabaseManager::instance().cachedReadQuery(
+        "SELECT bucket_start, min_value, max_value, sum_value, sample_count "
+        "FROM weather_rollup "
+        "WHERE city_id = :city_id AND resolution = :resolution AND metric = :metric "
+        "AND bucket_start >= :from AND bucket_start < :to "
+        "ORDER BY bucket_start");
+    if (!query) {
+        return points;
+    }
+    
+    // 起点对齐到桶边界，包含 from 所在的桶
+    query->bindValue(":city_id", cityId);
+    query->bindValue(":resolution", int(resolution));
+    query->bindValue(":metric", metric);
+    query->bindValue(":from", formatTime(bucketStart(from, resolution)));
+    query->bindValue(":to", formatTime(to));
+    
+    if (query->exec()) {
+        while (query->next()) {
+            RollupPoint point;
+            point.bucketStart = QDateTime::fromString(query->value(0).toString(), DATETIME_FORMAT);
+            point.minValue = query->value(1).toDouble();
+            point.maxValue = query->value(2).toDouble();
+            point.sumValue = query->value(3).toDouble();
+            point.count = query->value(4).toInt();
+            points.append(point);
+        }
+    } else {
+        qWarning() << "Failed to query rollup:" << query->lastError().text();
+    }
+    query->finish();
+    return points;
+}
+
+QList<RollupPoint> WeatherRollup::query(const QString &cityId, const QString &metric,
+                                        const QDateTime &from, const QDateTime &to)
+{
+    return query(cityId, metric, from, to, chooseResolution(from, to));
+}
+
+QDateTime WeatherRollup::bucketStart(const QDateTime &time, Resolution resolution)
+{
+    QDate date = time.date();
+    switch (resolution) {
+        case Hour:
+            return QDateTime(date, QTime(time.time().hour(), 0));
+        case Day:
+            return QDateTime(date, QTime(0, 0));
+        case Week:
+            // 周一为一周的开始
+            return QDateTime(date.addDays(1 - date.dayOfWeek()), QTime(0, 0));
+        default:
+            return QDateTime(QDate(date.year(), date.month(), 1), QTime(0, 0));
+    }
+}
+
+QDateTime WeatherRollup::bucketEnd(const QDateTime &start, Resolution resolution)
+{
+    switch (resolution) {
+        case Hour: return start.addSecs(3600);
+        case Day: return start.addDays(1);
+        case Week: return start.addDays(7);
+        default: return start.addMonths(1);
+    }
+}
+
+qint64 WeatherRollup::bucketSeconds(Resolution resolution)
+{
+    switch (resolution) {
+        case Hour: return 3600;
+        case Day: return 86400;
+        case Week: return 7 * 86400;
+        default: return 30 * 86400;
+    }
+}
+
+QString WeatherRollup::resolutionName(Resolution resolution)
+{
+    switch (resolution) {
+        case Hour: return "小时";
+        case Day: return "日";
+        case Week: return "周";
+        default: return "月";
+    }
+}
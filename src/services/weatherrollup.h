@@ -0,0 +1,118 @@
+/**
+ * @file weatherrollup.h
+ * @brief 天气时间序列多分辨率汇总
+ */
+
+#ifndef WEATHERROLLUP_H
+#define WEATHERROLLUP_H
+
+#include <QString>
+#include <QStringList>
+#include <QDateTime>
+#include <QList>
+#include "../database/databasewriter.h"
+
+/**
+ * @struct RollupPoint
+ * @brief 单个时间桶的汇总值
+ */
+struct RollupPoint {
+    QDateTime bucketStart;
+    double minValue = 0;
+    double maxValue = 0;
+    double sumValue = 0;
+    int count = 0;
+    
+    double average() const { return count > 0 ? sumValue / count : 0; }
+};
+
+/**
+ * @class WeatherRollup
+ * @brief 天气汇总表工具
+ * 
+ * weather_rollup 表按 小时 → 日 → 周 → 月 四级保存每个指标的 min/max/sum/count：
+ * - 小时桶由 weather_current 原始观测计算
+ * - 日桶由小时桶合并，周桶和月桶由日桶合并
+ * 
+ * 每次写入观测时只重算该观测所在的各级时间桶，随写入批次一起提交。
+ * 长时间范围查询自动选择合适的分辨率，只读取数百行而不是全部原始数据。
+ */
+class WeatherRollup
+{
+public:
+    enum Resolution {
+        Hour = 0,
+        Day,
+        Week,
+        Month
+    };
+    
+    /**
+     * @brief 参与汇总的指标（weather_current 中的列名）
+     */
+    static QStringList metrics();
+    
+    /**
+     * @brief 生成重算某次观测所在各级时间桶的语句
+     * 
+     * 语句需追加在观测写入语句之后，放在同一批次中执行
+     * @param cityId 城市ID
+     * @param observationTime 观测时间
+     */
+    static QList<DbStatement> refreshStatements(const QString &cityId, const QDateTime &observationTime);
+    
+    /**
+     * @brief 为时间范围选择分辨率
+     * 
+     * 返回时间桶数量不超过 maxPoints 的最细分辨率
+     * @param from 起始时间
+     * @param to 结束时间
+     * @param maxPoints 最大点数
+     */
+    static Resolution chooseResolution(const QDateTime &from, const QDateTime &to, int maxPoints = DEFAULT_MAX_POINTS);
+    
+    /**
+     * @brief 查询指定分辨率的汇总数据
+     * @param cityId 城市ID
+     * @param metric 指标名
+     * @param from 起始时间（含）
+     * @param to 结束时间（不含）
+     * @param resolution 分辨率
+     */
+    static QList<RollupPoint> query(const QString &cityId, const QString &metric,
+                                    const QDateTime &from, const QDateTime &to,
+                                    Resolution resolution);
+    
+    /**
+     * @brief 查询汇总数据，自动选择分辨率
+     */
+    static QList<RollupPoint> query(const QString &cityId, const QString &metric,
+                                    const QDateTime &from, const QDateTime &to);
+    
+    /**
+     * @brief 计算时间所在时间桶的起点
+     */
+    static QDateTime bucketStart(const QDateTime &time, Resolution resolution);
+    
+    /**
+     * @brief 计算时间桶的终点（下一个桶的起点）
+     */
+    static QDateTime bucketEnd(const QDateTime &start, Resolution resolution);
+    
+    /**
+     * @brief 单个时间桶的近似秒数（月按 30 天计），用于估算点数
+     */
+    static qint64 bucketSeconds(Resolution resolution);
+    
+    /**
+     * @brief 分辨率的显示名称
+     */
+    static QString resolutionName(Resolution resolution);
+    
+    static const int DEFAULT_MAX_POINTS = 400;
+
+private:
+    WeatherRollup() = default;
+};
+
+#endif // WEATHERROLLUP_H
@@ -5,6 +5,8 @@
 
 #include "weatherservice.h"
 #include "cityservice.h"
+#include "citydirectory.h"
+#include "weatherstore.h"
 #include <QJsonArray>
 #include <QUrlQuery>
 #include <QDebug>
@@ -37,55 +39,88 @@ QString WeatherService::buildUrl(const QString &endpoint, const QString &cityId,
     return m_baseUrl + endpoint;
 }
 
-void WeatherService::fetchCurrentWeather(const QString &cityId)
+QString WeatherService::currentWeatherUrl(const QString &cityId)
 {
     // 获取城市经纬度
     double lat = 39.9042, lon = 116.4074;  // 默认北京
     getCityCoordinates(cityId, lat, lon);
     
-    QString url = QString("%1/forecast?latitude=%2&longitude=%3"
-                         "&current=temperature_2m,relative_humidity_2m,apparent_temperature,"
-                         "weather_code,surface_pressure,wind_speed_10m,wind_direction_10m"
-                         "&timezone=auto")
-                  .arg(m_baseUrl).arg(lat).arg(lon);
-    
-    qDebug() << "Fetching current weather:" << url;
-    m_pendingRequests[url] = CurrentWeatherRequest;
-    m_pendingCityId = cityId;
-    NetworkManager::instance().get(url, true, 300);
+    return QString("%1/forecast?latitude=%2&longitude=%3"
+                   "&current=temperature_2m,relative_humidity_2m,apparent_temperature,"
+                   "weather_code,surface_pressure,wind_speed_10m,wind_direction_10m"
+                   "&timezone=auto")
+           .arg(m_baseUrl).arg(lat).arg(lon);
 }
 
-void WeatherService::fetchHourlyForecast(const QString &cityId, int hours)
+QString WeatherService::hourlyForecastUrl(const QString &cityId, int hours)
 {
     double lat = 39.9042, lon = 116.4074;
     getCityCoordinates(cityId, lat, lon);
     
-    QString url = QString("%1/forecast?latitude=%2&longitude=%3"
-                         "&hourly=temperature_2m,relative_humidity_2m,weather_code,"
-                         "wind_speed_10m,wind_direction_10m,precipitation_probability"
-                         "&forecast_hours=%4&timezone=auto")
-                  .arg(m_baseUrl).arg(lat).arg(lon).arg(hours);
-    
-    m_pendingRequests[url] = HourlyForecastRequest;
-    m_pendingCityId = cityId;
-    NetworkManager::instance().get(url, true, 600);
+    return QString("%1/forecast?latitude=%2&longitude=%3"
+                   "&hourly=temperature_2m,relative_humidity_2m,weather_code,"
+                   "wind_speed_10m,wind_direction_10m,precipitation_probability"
+                   "&forecast_hours=%4&timezone=auto")
+           .arg(m_baseUrl).arg(lat).arg(lon).arg(hours);
 }
 
-void WeatherService::fetchDailyForecast(const QString &cityId, int days)
+QString WeatherService::dailyForecastUrl(const QString &cityId, int days)
 {
     double lat = 39.9042, lon = 116.4074;
     getCityCoordinates(cityId, lat, lon);
     
-    QString url = QString("%1/forecast?latitude=%2&longitude=%3"
-                         "&daily=temperature_2m_max,temperature_2m_min,weather_code,"
-                         "wind_speed_10m_max,wind_direction_10m_dominant,"
-                         "precipitation_probability_max,uv_index_max,sunrise,sunset"
-                         "&forecast_days=%4&timezone=auto")
-                  .arg(m_baseUrl).arg(lat).arg(lon).arg(days);
+    return QString("%1/forecast?latitude=%2&longitude=%3"
+                   "&daily=temperature_2m_max,temperature_2m_min,weather_code,"
+                   "wind_speed_10m_max,wind_direction_10m_dominant,"
+                   "precipitation_probability_max,uv_index_max,sunrise,sunset"
+                   "&forecast_days=%4&timezone=auto")
+           .arg(m_baseUrl).arg(lat).arg(lon).arg(days);
+}
+
+void WeatherService::fetchCurrentWeather(const QString &cityId)
+{
+    QString url = currentWeatherUrl(cityId);
     
-    m_pendingRequests[url] = DailyForecastRequest;
-    m_pendingCityId = cityId;
-    NetworkManager::instance().get(url, true, 1800);
+    qDebug() << "Fetching current weather:" << url;
+    m_pendingRequests[url] = {CurrentWeatherRequest, cityId};
+    NetworkManager::instance().get(url, true, CURRENT_WEATHER_TTL);
+}
+
+void WeatherService::fetchHourlyForecast(const QString &cityId, int hours)
+{
+    QString url = hourlyForecastUrl(cityId, hours);
+    
+    m_pendingRequests[url] = {HourlyForecastRequest, cityId};
+    NetworkManager::instance().get(url, true, HOURLY_FORECAST_TTL);
+}
+
+void WeatherService::fetchDailyForecast(const QString &cityId, int days)
+{
+    QString url = dailyForecastUrl(cityId, days);
+    
+    m_pendingRequests[url] = {DailyForecastRequest, cityId};
+    NetworkManager::instance().get(url, true, DAILY_FORECAST_TTL);
+}
+
+void WeatherService::prefetchCurrentWeather(const QString &cityId)
+{
+    QString url = currentWeatherUrl(cityId);
+    m_prefetchRequests[url] = {CurrentWeatherRequest, cityId};
+    NetworkManager::instance().get(url, true, CURRENT_WEATHER_TTL);
+}
+
+void WeatherService::prefetchHourlyForecast(const QString &cityId, int hours)
+{
+    QString url = hourlyForecastUrl(cityId, hours);
+    m_prefetchRequests[url] = {HourlyForecastRequest, cityId};
+    NetworkManager::instance().get(url, true, HOURLY_FORECAST_TTL);
+}
+
+void WeatherService::prefetchDailyForecast(const QString &cityId, int days)
+{
+    QString url = dailyForecastUrl(cityId, days);
+    m_prefetchRequests[url] = {DailyForecastRequest, cityId};
+    NetworkManager::instance().get(url, true, DAILY_FORECAST_TTL);
 }
 
 void WeatherService::fetchLifeIndex(const QString &cityId)
@@ -147,11 +182,21 @@ void WeatherService::fetchAirQuality(const QString &cityId)
 
 void WeatherService::onRequestFinished(const QString &url, const NetworkResponse &response)
 {
+    // 后台预取：NetworkManager 已在请求完成时写入缓存，这里只需持久化
+    if (m_prefetchRequests.contains(url)) {
+        PendingRequest request = m_prefetchRequests.take(url);
+        // 同一URL也有普通请求时由下面统一处理，避免重复写入
+        if (response.success && !response.fromCache && !m_pendingRequests.contains(url)) {
+            storePrefetchResponse(request, response.data);
+        }
+        emit prefetchFinished(request.cityId, response.success);
+    }
+    
     if (!m_pendingRequests.contains(url)) {
         return;
     }
     
-    RequestType type = m_pendingRequests.take(url);
+    PendingRequest request = m_pendingRequests.take(url);
     
     if (!response.success) {
         qWarning() << "API request failed:" << response.errorString;
@@ -169,19 +214,31 @@ void WeatherService::onRequestFinished(const QString &url, const NetworkResponse
         return;
     }
     
-    switch (type) {
+    // 缓存命中的数据已经持久化过，只保存新获取的数据
+    bool store = !response.fromCache;
+    
+    switch (request.type) {
         case CurrentWeatherRequest: {
-            CurrentWeather weather = parseOpenMeteoCurrentWeather(json, m_pendingCityId);
+            CurrentWeather weather = parseOpenMeteoCurrentWeather(json, request.cityId);
+            if (store) {
+                WeatherStore::instance().saveCurrentWeather(weather);
+            }
             emit currentWeatherReady(weather);
             break;
         }
         case HourlyForecastRequest: {
             QList<HourlyForecast> forecast = parseOpenMeteoHourlyForecast(json);
+            if (store) {
+                WeatherStore::instance().saveHourlyForecast(request.cityId, forecast);
+            }
             emit hourlyForecastReady(forecast);
             break;
         }
         case DailyForecastRequest: {
             QList<DailyForecast> forecast = parseOpenMeteoDailyForecast(json);
+            if (store) {
+                WeatherStore::instance().saveDailyForecast(request.cityId, forecast);
+            }
             emit dailyForecastReady(forecast);
             break;
         }
@@ -190,10 +247,32 @@ void WeatherService::onRequestFinished(const QString &url, const NetworkResponse
     }
 }
 
+void WeatherService::storePrefetchResponse(const PendingRequest &request, const QJsonObject &json)
+{
+    if (json.contains("error") && json["error"].toBool()) {
+        return;
+    }
+    
+    WeatherStore &store = WeatherStore::instance();
+    switch (request.type) {
+        case CurrentWeatherRequest:
+            store.saveCurrentWeather(parseOpenMeteoCurrentWeather(json, request.cityId));
+            break;
+        case HourlyForecastRequest:
+            store.saveHourlyForecast(request.cityId, parseOpenMeteoHourlyForecast(json));
+            break;
+        case DailyForecastRequest:
+            store.saveDailyForecast(request.cityId, parseOpenMeteoDailyForecast(json));
+            break;
+        default:
+            break;
+    }
+}
+
 void WeatherService::getCityCoordinates(const QString &cityId, double &lat, double &lon)
 {
-    // 优先从数据库获取城市经纬度
-    CityInfo city = CityService::instance().getCity(cityId);
+    // 优先使用城市目录中的经纬度
+    CityInfo city = CityDirectory::instance().city(cityId);
     if (!city.cityId.isEmpty() && city.latitude != 0 && city.longitude != 0) {
         lat = city.latitude;
         lon = city.longitude;
@@ -318,6 +397,12 @@ CurrentWeather WeatherService::parseOpenMeteoCurrentWeather(const QJsonObject &j
     weather.sunsetTime = "18:30";
     weather.updateTime = QDateTime::currentDateTime();
     
+    // 观测时间作为持久化的唯一键之一，缺失时使用本地更新时间
+    weather.observationTime = QDateTime::fromString(current["time"].toString(), Qt::ISODate);
+    if (!weather.observationTime.isValid()) {
+        weather.observationTime = weather.updateTime;
+    }
+    
     return weather;
 }
 
@@ -21,6 +21,11 @@ class WeatherService : public QObject
     Q_OBJECT
 
 public:
+    // 各类数据的缓存生存时间(秒)
+    static const int CURRENT_WEATHER_TTL = 300;
+    static const int HOURLY_FORECAST_TTL = 600;
+    static const int DAILY_FORECAST_TTL = 1800;
+    
     static WeatherService& instance();
     
     /**
@@ -66,6 +71,29 @@ public:
      * @param cityId 城市ID
      */
     void fetchAirQuality(const QString &cityId);
+    
+    /**
+     * @brief 后台预取当前天气
+     * 
+     * 只发起请求以预热网络缓存，不发出 currentWeatherReady 信号，
+     * 用于刷新当前未显示的城市
+     * @param cityId 城市ID
+     */
+    void prefetchCurrentWeather(const QString &cityId);
+    
+    /**
+     * @brief 后台预取逐小时预报
+     * @param cityId 城市ID
+     * @param hours 小时数
+     */
+    void prefetchHourlyForecast(const QString &cityId, int hours = 24);
+    
+    /**
+     * @brief 后台预取每日预报
+     * @param cityId 城市ID
+     * @param days 天数
+     */
+    void prefetchDailyForecast(const QString &cityId, int days = 7);
 
 signals:
     void currentWeatherReady(const CurrentWeather &weather);
@@ -74,6 +102,13 @@ signals:
     void lifeIndexReady(const QList<LifeIndex> &indices);
     void weatherAlertReady(const QList<WeatherAlert> &alerts);
     void errorOccurred(const QString &error);
+    
+    /**
+     * @brief 后台预取完成信号
+     * @param cityId 城市ID
+     * @param success 是否成功
+     */
+    void prefetchFinished(const QString &cityId, bool success);
 
 private slots:
     void onRequestFinished(const QString &url, const NetworkResponse &response);
@@ -94,11 +129,13 @@ private:
     QString getWmoWeatherDesc(int code);
     
     QString buildUrl(const QString &endpoint, const QString &cityId, const QMap<QString, QString> &params = {});
+    QString currentWeatherUrl(const QString &cityId);
+    QString hourlyForecastUrl(const QString &cityId, int hours);
+    QString dailyForecastUrl(const QString &cityId, int days);
 
 private:
     QString m_apiKey;
     QString m_baseUrl;
-    QString m_pendingCityId;
     
     // 请求类型标识
     enum RequestType {
@@ -109,7 +146,25 @@ private:
         AlertRequest,
         AirQualityRequest
     };
-    QMap<QString, RequestType> m_pendingRequests;
+    
+    /**
+     * @struct PendingRequest
+     * @brief 进行中的请求
+     */
+    struct PendingRequest {
+        RequestType type;
+        QString cityId;
+    };
+    
+    // URL -> 请求信息，每个请求记录自己的城市ID，并发请求互不干扰
+    QMap<QString, PendingRequest> m_pendingRequests;
+    // 后台预取请求
+    QMap<QString, PendingRequest> m_prefetchRequests;
+    
+    /**
+     * @brief 解析预取结果并持久化（不更新界面）
+     */
+    void storePrefetchResponse(const PendingRequest &request, const QJsonObject &json);
 };
 
 #endif // WEATHERSERVICE_H
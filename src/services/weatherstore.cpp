@@ -0,0 +1,399 @@
+/**
+ * @file weatherstore.cpp
+ * @brief 天气数据持久化服务实现
+ */
+
+#include "weatherstore.h"
+#include "../database/databasemanager.h"
+#include "../database/databasewriter.h"
+#include "weatherrollup.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+namespace {
+const char *DATE_FORMAT = "yyyy-MM-dd";
+const char *DATETIME_FORMAT = "yyyy-MM-dd hh:mm:ss";
+}
+
+WeatherStore::WeatherStore(QObject *parent)
+    : QObject(parent)
+{
+    m_currentUpsertSql = upsertSql("weather_current", {
+        "city_id", "temperature", "feels_like", "humidity", "pressure", "visibility",
+        "wind_speed", "wind_direction", "wind_degree", "weather_code", "weather_desc",
+        "weather_icon", "cloud_cover", "uv_index", "aqi", "aqi_level", "pm25", "pm10",
+        "o3", "sunrise_time", "sunset_time", "observation_time"
+    }, {"city_id", "observation_time"});
+    
+    m_hourlyUpsertSql = upsertSql("weather_forecast", {
+        "city_id", "forecast_date", "forecast_hour", "temperature", "humidity",
+        "weather_code_day", "weather_desc_day", "weather_icon_day", "wind_speed",
+        "wind_direction", "precipitation_prob", "precipitation"
+    }, {"city_id", "forecast_date", "forecast_hour"});
+    
+    m_dailyUpsertSql = upsertSql("weather_forecast", {
+        "city_id", "forecast_date", "forecast_hour", "high_temp", "low_temp", "humidity",
+        "weather_code_day", "weather_desc_day", "weather_icon_day",
+        "weather_code_night", "weather_desc_night", "weather_icon_night",
+        "wind_speed", "wind_direction", "precipitation_prob", "precipitation",
+        "uv_index", "sunrise_time", "sunset_time"
+    }, {"city_id", "forecast_date", "forecast_hour"});
+}
+
+WeatherStore& WeatherStore::instance()
+{
+    static WeatherStore instance;
+    return instance;
+}
+
+QString WeatherStore::upsertSql(const QString &table, const QStringList &columns,
+                                const QStringList &conflictColumns)
+{
+    QStringList placeholders;
+    QStringList updates;
+    for (const QString &column : columns) {
+        placeholders.append("?");
+        if (!conflictColumns.contains(column)) {
+            updates.append(QString("%1 = excluded.%1").arg(column));
+        }
+    }
+    updates.append("update_time = CURRENT_TIMESTAMP");
+    
+    return QString("INSERT INTO %1 (%2) VALUES (%3) ON CONFLICT(%4) DO UPDATE SET %5")
+           .arg(table, columns.join(", "), placeholders.join(", "),
+                conflictColumns.join(", "), updates.join(", "));
+}
+
+void WeatherStore::saveCurrentWeather(const CurrentWeather &weather)
+{
+    if (!weather.isValid()) {
+        return;
+    }
+    
+    QDateTime observed = weather.observationTime.isValid() ? weather.observationTime
+                                                           : weather.updateTime;
+    
+    DbWriteBatch batch;
+    batch.tag = "current:" + weather.cityId;
+    batch.add(m_currentUpsertSql, {
+        weather.cityId, weather.temperature, weather.feelsLike, weather.humidity,
+        weather.pressure, weather.visibility, weather.windSpeed, weather.windDirection,
+        weather.windDegree, weather.weatherCode, weather.weatherDesc, weather.weatherIcon,
+        weather.cloudCover, weather.uvIndex, weather.aqi, weather.aqiLevel,
+        weather.pm25, weather.pm10, weather.o3, weather.sunriseTime, weather.sunsetTime,
+        observed.toString(DATETIME_FORMAT)
+    });
+    // 同一批次内重算该观测所在的各级汇总桶
+    batch.statements.append(WeatherRollup::refreshStatements(weather.cityId, observed));
+    DatabaseWriter::instance().submit(batch);
+    
+    QMutexLocker locker(&m_mutex);
+    m_snapshots[weather.cityId].current = weather;
+}
+
+void WeatherStore::saveHourlyForecast(const QString &cityId, const QList<HourlyForecast> &forecast)
+{
+    if (cityId.isEmpty() || forecast.isEmpty()) {
+        return;
+    }
+    
+    // 同一城市的一组预报作为一个批次，在同一个事务中写入
+    DbWriteBatch batch;
+    batch.tag = "hourly:" + cityId;
+    for (const HourlyForecast &h : forecast) {
+        if (!h.time.isValid()) {
+            continue;
+        }
+        batch.add(m_hourlyUpsertSql, {
+            cityId, h.time.date().toString(DATE_FORMAT), h.time.time().hour(),
+            h.temperature, h.humidity, h.weatherCode, h.weatherDesc, h.weatherIcon,
+            h.windSpeed, h.windDirection, h.precipitationProb, h.precipitation
+        });
+    }
+    DatabaseWriter::instance().submit(batch);
+    
+    QMutexLocker locker(&m_mutex);
+    m_snapshots[cityId].hourly = forecast;
+}
+
+void WeatherStore::saveDailyForecast(const QString &cityId, const QList<DailyForecast> &forecast)
+{
+    if (cityId.isEmpty() || forecast.isEmpty()) {
+        return;
+    }
+    
+    DbWriteBatch batch;
+    batch.tag = "daily:" + cityId;
+    for (const DailyForecast &d : forecast) {
+        if (!d.date.isValid()) {
+            continue;
+        }
+        batch.add(m_dailyUpsertSql, {
+            cityId, d.date.toString(DATE_FORMAT), DAILY_FORECAST_HOUR,
+            d.highTemp, d.lowTemp, d.humidity,
+            d.weatherCodeDay, d.weatherDescDay, d.weatherIconDay,
+            d.weatherCodeNight, d.weatherDescNight, d.weatherIconNight,
+            d.windSpeed, d.windDirection, d.precipitationProb, d.precipitation,
+            d.uvIndex, d.sunriseTime, d.sunsetTime
+        });
+    }
+    DatabaseWriter::instance().submit(batch);
+    
+    QMutexLocker locker(&m_mutex);
+    m_snapshots[cityId].daily = forecast;
+}
+
+int WeatherStore::restoreSnapshots()
+{
+    QSqlQuery query(DatabaseManager::instance().readOnlyDatabase());
+    
+    // SQLite 中与 MAX() 一起选择的其他列取自最大值所在的行，即每个城市最新的一条
+    QString sql = R"(
+        SELECT city_id, temperature, feels_like, humidity, pressure, visibility,
+               wind_speed, wind_direction, wind_degree, weather_code, weather_desc,
+               weather_icon, cloud_cover, uv_index, aqi, aqi_level, pm25, pm10, o3,
+               sunrise_time, sunset_time, update_time, MAX(observation_time)
+        FROM weather_current
+        GROUP BY city_id
+    )";
+    
+    if (!query.exec(sql)) {
+        qWarning() << "Failed to restore weather snapshots:" << query.lastError().text();
+        return 0;
+    }
+    
+    int count = 0;
+    QMutexLocker locker(&m_mutex);
+    while (query.next()) {
+        CurrentWeather weather;
+        weather.cityId = query.value(0).toString();
+        weather.temperature = query.value(1).toDouble();
+        weather.feelsLike = query.value(2).toDouble();
+        weather.humidity = query.value(3).toInt();
+        weather.pressure = query.value(4).toInt();
+        weather.visibility = query.value(5).toInt();
+        weather.windSpeed = query.value(6).toDouble();
+        weather.windDirection = query.value(7).toString();
+        weather.windDegree = query.value(8).toInt();
+        weather.weatherCode = query.value(9).toString();
+        weather.weatherDesc = query.value(10).toString();
+        weather.weatherIcon = query.value(11).toString();
+        weather.cloudCover = query.value(12).toInt();
+        weather.uvIndex = query.value(13).toDouble();
+        weather.aqi = query.value(14).toInt();
+        weather.aqiLevel = query.value(15).toString();
+        weather.pm25 = query.value(16).toDouble();
+        weather.pm10 = query.value(17).toDouble();
+        weather.o3 = query.value(18).toDouble();
+        weather.sunriseTime = query.value(19).toString();
+        weather.sunsetTime = query.value(20).toString();
+        weather.updateTime = QDateTime::fromString(query.value(21).toString(), DATETIME_FORMAT);
+        weather.observationTime = QDateTime::fromString(query.value(22).toString(), DATETIME_FORMAT);
+        
+        // 本次运行中已获取到更新的数据时不覆盖
+        WeatherSnapshot &snapshot = m_snapshots[weather.cityId];
+        if (!snapshot.current.isValid()) {
+            snapshot.current = weather;
+            count++;
+        }
+    }
+    
+    qDebug() << "Restored weather snapshots for" << count << "cities";
+    return count;
+}
+
+WeatherSnapshot WeatherStore::snapshot(const QString &cityId)
+{
+    bool needLoad = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        needLoad = !m_forecastLoaded.contains(cityId);
+    }
+    
+    QHash<QString, WeatherSnapshot> loaded;
+    if (needLoad) {
+        loaded = loadForecasts({cityId});
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    if (needLoad) {
+        storeForecasts({cityId}, loaded);
+    }
+    return m_snapshots.value(cityId);
+}
+
+QHash<QString, WeatherSnapshot> WeatherStore::snapshots(const QStringList &cityIds)
+{
+    QStringList needLoad;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const QString &cityId : cityIds) {
+            if (!m_forecastLoaded.contains(cityId)) {
+                needLoad.append(cityId);
+            }
+        }
+    }
+    
+    // 在锁外读取数据库，读完后一次写回
+    QHash<QString, WeatherSnapshot> loaded = loadForecasts(needLoad);
+    
+    QHash<QString, WeatherSnapshot> result;
+    QMutexLocker locker(&m_mutex);
+    storeForecasts(needLoad, loaded);
+    for (const QString &cityId : cityIds) {
+        auto it = m_snapshots.constFind(cityId);
+        if (it != m_snapshots.constEnd() && !it->isEmpty()) {
+            result.insert(cityId, it.value());
+        }
+    }
+    return result;
+}
+
+QHash<QString, WeatherSnapshot> WeatherStore::readSnapshots(const QStringList &cityIds)
+{
+    QHash<QString, WeatherSnapshot> result;
+    QStringList needLoad;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const QString &cityId : cityIds) {
+            auto it = m_snapshots.constFind(cityId);
+            if (it != m_snapshots.constEnd()) {
+                result.insert(cityId, it.value());
+            }
+            if (!m_forecastLoaded.contains(cityId)) {
+                needLoad.append(cityId);
+            }
+        }
+    }
+    
+    // 读出的预报只合并到返回值，不写回缓存
+    QHash<QString, WeatherSnapshot> loaded = loadForecasts(needLoad);
+    for (auto it = loaded.constBegin(); it != loaded.constEnd(); ++it) {
+        WeatherSnapshot &snapshot = result[it.key()];
+        if (snapshot.hourly.isEmpty()) {
+            snapshot.hourly = it->hourly;
+        }
+        if (snapshot.daily.isEmpty()) {
+            snapshot.daily = it->daily;
+        }
+    }
+    
+    result.removeIf([](const QHash<QString, WeatherSnapshot>::iterator it) {
+        return it.value().isEmpty();
+    });
+    return result;
+}
+
+void WeatherStore::storeForecasts(const QStringList &cityIds, const QHash<QString, WeatherSnapshot> &loaded)
+{
+    // 本次运行中已获取到更新的预报时不覆盖；数据写入后才标记为已读取，
+    // 并发的读取者不会在写入前看到空预报
+    for (const QString &cityId : cityIds) {
+        auto it = loaded.constFind(cityId);
+        if (it != loaded.constEnd()) {
+            WeatherSnapshot &snapshot = m_snapshots[cityId];
+            if (snapshot.hourly.isEmpty()) {
+                snapshot.hourly = it->hourly;
+            }
+            if (snapshot.daily.isEmpty()) {
+                snapshot.daily = it->daily;
+            }
+        }
+        m_forecastLoaded.insert(cityId);
+    }
+}
+
+QHash<QString, WeatherSnapshot> WeatherStore::loadForecasts(const QStringList &cityIds)
+{
+    QHash<QString, WeatherSnapshot> result;
+    if (cityIds.isEmpty()) {
+        return result;
+    }
+    
+    QDateTime now = QDateTime::currentDateTime();
+    QDate today = now.date();
+    int currentHour = now.time().hour();
+    
+    // 逐小时和每日预报在同一张表，每批城市一条查询同时读出，按行的 forecast_hour 区分
+    QSqlQuery query(DatabaseManager::instance().readOnlyDatabase());
+    for (int start = 0; start < cityIds.size(); start += FORECAST_BATCH_SIZE) {
+        const QStringList batch = cityIds.mid(start, FORECAST_BATCH_SIZE);
+        QStringList placeholders;
+        for (int i = 0; i < batch.size(); ++i) {
+            placeholders.append("?");
+        }
+        
+        query.prepare(QString(R"(
+            SELECT city_id, forecast_date, forecast_hour, temperature, high_temp, low_temp,
+                   humidity, weather_code_day, weather_desc_day, weather_icon_day,
+                   weather_code_night, weather_desc_night, weather_icon_night,
+                   wind_speed, wind_direction, precipitation_prob, precipitation,
+                   uv_index, sunrise_time, sunset_time
+            FROM weather_forecast
+            WHERE city_id IN (%1) AND forecast_date >= ?
+            ORDER BY city_id, forecast_date, forecast_hour
+        )").arg(placeholders.join(',')));
+        for (const QString &cityId : batch) {
+            query.addBindValue(cityId);
+        }
+        query.addBindValue(today.toString(DATE_FORMAT));
+        
+        if (!query.exec()) {
+            qWarning() << "Failed to load forecasts:" << query.lastError().text();
+            return result;
+        }
+        
+        while (query.next()) {
+            WeatherSnapshot &snapshot = result[query.value(0).toString()];
+            QDate date = QDate::fromString(query.value(1).toString(), DATE_FORMAT);
+            int hour = query.value(2).toInt();
+            
+            if (hour == DAILY_FORECAST_HOUR) {
+                if (snapshot.daily.size() >= DAILY_FORECAST_LIMIT) {
+                    continue;
+                }
+                DailyForecast d;
+                d.date = date;
+                d.highTemp = query.value(4).toDouble();
+                d.lowTemp = query.value(5).toDouble();
+                d.humidity = query.value(6).toInt();
+                d.weatherCodeDay = query.value(7).toString();
+                d.weatherDescDay = query.value(8).toString();
+                d.weatherIconDay = query.value(9).toString();
+                d.weatherCodeNight = query.value(10).toString();
+                d.weatherDescNight = query.value(11).toString();
+                d.weatherIconNight = query.value(12).toString();
+                d.windSpeed = query.value(13).toDouble();
+                d.windDirection = query.value(14).toString();
+                d.precipitationProb = query.value(15).toInt();
+                d.precipitation = query.value(16).toDouble();
+                d.uvIndex = query.value(17).toDouble();
+                d.sunriseTime = query.value(18).toString();
+                d.sunsetTime = query.value(19).toString();
+                snapshot.daily.append(d);
+                continue;
+            }
+            
+            // 只保留从当前小时开始的逐小时预报
+            if (hour < 0 || (date == today && hour < currentHour)
+                || snapshot.hourly.size() >= HOURLY_FORECAST_LIMIT) {
+                continue;
+            }
+            HourlyForecast h;
+            h.time = QDateTime(date, QTime(hour, 0));
+            h.temperature = query.value(3).toDouble();
+            h.humidity = query.value(6).toInt();
+            h.weatherCode = query.value(7).toString();
+            h.weatherDesc = query.value(8).toString();
+            h.weatherIcon = query.value(9).toString();
+            h.windSpeed = query.value(13).toDouble();
+            h.windDirection = query.value(14).toString();
+            h.precipitationProb = query.value(15).toInt();
+            h.precipitation = query.value(16).toDouble();
+            snapshot.hourly.append(h);
+        }
+        query.finish();
+    }
+    return result;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file weatherstore.h
+ * @brief 天气数据持久化服务
+ */
+
+#ifndef WEATHERSTORE_H
+#define WEATHERSTORE_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include "../models/weatherdata.h"
+
+/**
+ * @struct WeatherSnapshot
+ * @brief 单个城市最近一次获取的天气数据
+ */
+struct WeatherSnapshot {
+    CurrentWeather current;
+    QList<HourlyForecast> hourly;
+    QList<DailyForecast> daily;
+    
+    bool isEmpty() const { return !current.isValid() && hourly.isEmpty() && daily.isEmpty(); }
+};
+
+/**
+ * @class WeatherStore
+ * @brief 天气数据存储类
+ * 
+ * 把解析后的天气数据通过 DatabaseWriter 批量写入 weather_current / weather_forecast，
+ * 并在启动时恢复每个城市最近的快照，切换城市时无需等待网络即可显示
+ */
+class WeatherStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    static WeatherStore& instance();
+    
+    /**
+     * @brief 保存当前天气（可在任意线程调用）
+     * @param weather 当前天气数据
+     */
+    void saveCurrentWeather(const CurrentWeather &weather);
+    
+    /**
+     * @brief 保存逐小时预报（可在任意线程调用）
+     * @param cityId 城市ID
+     * @param forecast 预报列表
+     */
+    void saveHourlyForecast(const QString &cityId, const QList<HourlyForecast> &forecast);
+    
+    /**
+     * @brief 保存每日预报（可在任意线程调用）
+     * @param cityId 城市ID
+     * @param forecast 预报列表
+     */
+    void saveDailyForecast(const QString &cityId, const QList<DailyForecast> &forecast);
+    
+    /**
+     * @brief 从数据库恢复每个城市最近的实时天气
+     * @return 恢复的城市数量
+     */
+    int restoreSnapshots();
+    
+    /**
+     * @brief 获取城市的天气快照
+     * 
+     * 预报数据首次访问时从数据库读取（可在任意线程调用）
+     * @param cityId 城市ID
+     * @return 天气快照，没有数据时为空
+     */
+    WeatherSnapshot snapshot(const QString &cityId);
+    
+    /**
+     * @brief 批量获取多个城市的天气快照
+     * 
+     * 尚未读取过预报的城市按批一次查询补齐，只加锁两次（可在任意线程调用）
+     * @param cityIds 城市ID列表
+     * @return cityId → 天气快照，没有数据的城市不包含在结果中
+     */
+    QHash<QString, WeatherSnapshot> snapshots(const QStringList &cityIds);
+    
+    /**
+     * @brief 批量读取天气快照但不放入缓存
+     * 
+     * 供批量遍历大量城市的场景使用（如报表渲染），内存占用不随遍历过的城市数增长；
+     * 已在缓存中的预报直接使用（可在任意线程调用）
+     * @param cityIds 城市ID列表
+     * @return cityId → 天气快照，没有数据的城市不包含在结果中
+     */
+    QHash<QString, WeatherSnapshot> readSnapshots(const QStringList &cityIds);
+
+private:
+    explicit WeatherStore(QObject *parent = nullptr);
+    ~WeatherStore() = default;
+    
+    WeatherStore(const WeatherStore&) = delete;
+    WeatherStore& operator=(const WeatherStore&) = delete;
+    
+    /**
+     * @brief 生成 INSERT ... ON CONFLICT DO UPDATE 语句
+     * @param table 表名
+     * @param columns 插入的列
+     * @param conflictColumns 唯一约束列
+     */
+    static QString upsertSql(const QString &table, const QStringList &columns,
+                             const QStringList &conflictColumns);
+    
+    /**
+     * @brief 批量读取多个城市的逐小时和每日预报，每批城市只执行一次查询
+     * @return cityId → 只含预报的快照，没有预报的城市不包含在结果中
+     */
+    QHash<QString, WeatherSnapshot> loadForecasts(const QStringList &cityIds);
+    
+    /**
+     * @brief 写入读取到的预报并标记为已读取，调用方需持有 m_mutex
+     */
+    void storeForecasts(const QStringList &cityIds, const QHash<QString, WeatherSnapshot> &loaded);
+
+private:
+    QHash<QString, WeatherSnapshot> m_snapshots;
+    QSet<QString> m_forecastLoaded;  // 已从数据库读取过预报的城市
+    QMutex m_mutex;
+    
+    QString m_currentUpsertSql;
+    QString m_hourlyUpsertSql;
+    QString m_dailyUpsertSql;
+    
+    static const int DAILY_FORECAST_HOUR = -1;  // 每日预报行的 forecast_hour
+    static const int HOURLY_FORECAST_LIMIT = 24;
+    static const int DAILY_FORECAST_LIMIT = 7;
+    static const int FORECAST_BATCH_SIZE = 500; // 低于 SQLite 默认的绑定参数上限
+};
+
+#endif // WEATHERSTORE_H
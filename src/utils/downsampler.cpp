@@ -0,0 +1,125 @@
+/**
+ * @file downsampler.cpp
+ * @brief 时间序列降采样工具实现
+ */
+
+#include "downsampler.h"
+#include <algorithm>
+#include <cmath>
+
+QList<QPointF> Downsampler::lttb(const QList<QPointF> &points, int threshold)
+{
+    const qsizetype n = points.size();
+    if (threshold < 3 || n <= threshold) {
+        return points;
+    }
+    
+    QList<QPointF> result;
+    result.reserve(threshold);
+    result.append(points.first());
+    
+    // 首尾两点固定保留，中间的点均分到 threshold - 2 个桶
+    const double bucketSize = double(n - 2) / (threshold - 2);
+    qsizetype selected = 0;
+    
+    for (int bucket = 0; bucket < threshold - 2; ++bucket) {
+        qsizetype start = qsizetype(std::floor(bucket * bucketSize)) + 1;
+        qsizetype end = qsizetype(std::floor((bucket + 1) * bucketSize)) + 1;
+        end = qMin(end, n - 1);
+        
+        // 下一个桶的平均点作为三角形的第三个顶点，最后一个桶用终点
+        qsizetype nextStart = end;
+        qsizetype nextEnd = qMin(qsizetype(std::floor((bucket + 2) * bucketSize)) + 1, n);
+        if (bucket == threshold - 3) {
+            nextStart = n - 1;
+            nextEnd = n;
+        }
+        double avgX = 0;
+        double avgY = 0;
+        for (qsizetype i = nextStart; i < nextEnd; ++i) {
+            avgX += points[i].x();
+            avgY += points[i].y();
+        }
+        const qsizetype nextCount = qMax<qsizetype>(1, nextEnd - nextStart);
+        avgX /= nextCount;
+        avgY /= nextCount;
+        
+        const QPointF &a = points[selected];
+        double maxArea = -1;
+        qsizetype maxIndex = start;
+        for (qsizetype i = start; i < end; ++i) {
+            // 面积的两倍，只用于比较
+            double area = std::abs((a.x() - avgX) * (points[i].y() - a.y())
+                                   - (a.x() - points[i].x()) * (avgY - a.y()));
+            if (area > maxArea) {
+                maxArea = area;
+                maxIndex = i;
+            }
+        }
+        
+        result.append(points[maxIndex]);
+        selected = maxIndex;
+    }
+    
+    result.append(points.last());
+    return result;
+}
+
+void Downsampler::minMaxEnvelope(const QList<QPointF> &points, int buckets,
+                                 QList<QPointF> &upper, QList<QPointF> &lower)
+{
+    upper.clear();
+    lower.clear();
+    if (points.isEmpty() || buckets < 1) {
+        return;
+    }
+    
+    const double minX = points.first().x();
+    const double span = points.last().x() - minX;
+    upper.reserve(buckets);
+    lower.reserve(buckets);
+    
+    // 按 x 而不是点的序号分桶，数据有缺口时桶宽仍与像素对应
+    int current = -1;
+    double bucketMin = 0;
+    double bucketMax = 0;
+    double firstX = 0;
+    double lastX = 0;
+    auto flush = [&]() {
+        double x = (firstX + lastX) / 2;
+        upper.append(QPointF(x, bucketMax));
+        lower.append(QPointF(x, bucketMin));
+    };
+    
+    for (const QPointF &point : points) {
+        int bucket = span > 0 ? qMin(buckets - 1, int((point.x() - minX) / span * buckets)) : 0;
+        if (bucket != current) {
+            if (current >= 0) {
+                flush();
+            }
+            current = bucket;
+            bucketMin = bucketMax = point.y();
+            firstX = point.x();
+        } else {
+            bucketMin = qMin(bucketMin, point.y());
+            bucketMax = qMax(bucketMax, point.y());
+        }
+        lastX = point.x();
+    }
+    flush();
+}
+
+QList<QPointF> Downsampler::visibleRange(const QList<QPointF> &points, qreal minX, qreal maxX)
+{
+    auto lessX = [](const QPointF &point, qreal x) { return point.x() < x; };
+    auto first = std::lower_bound(points.cbegin(), points.cend(), minX, lessX);
+    auto last = std::lower_bound(first, points.cend(), maxX, lessX);
+    
+    if (first != points.cbegin()) {
+        --first;
+    }
+    if (last != points.cend()) {
+        ++last;
+    }
+    return QList<QPointF>(first, last);
+}
@@ -0,0 +1,53 @@
+/**
+ * @file downsampler.h
+ * @brief 时间序列降采样工具
+ */
+
+#ifndef DOWNSAMPLER_H
+#define DOWNSAMPLER_H
+
+#include <QList>
+#include <QPointF>
+
+/**
+ * @class Downsampler
+ * @brief 把长时间序列缩减到图表像素宽度
+ * 
+ * 输入的点按 x 升序排列。提供两种降采样：
+ * - LTTB（Largest-Triangle-Three-Buckets）：每个桶保留与前后点构成三角形面积最大的点，
+ *   折线形状和大部分峰谷得以保留
+ * - 最小/最大包络：每个桶保留最小值和最大值，用于在折线下方绘制范围，
+ *   保证降采样后任何极值都不会丢失
+ * 
+ * 点数不超过目标点数时原样返回。
+ */
+class Downsampler
+{
+public:
+    /**
+     * @brief LTTB 降采样
+     * @param points 按 x 升序排列的点
+     * @param threshold 目标点数，小于 3 时原样返回
+     */
+    static QList<QPointF> lttb(const QList<QPointF> &points, int threshold);
+    
+    /**
+     * @brief 按 x 等分桶计算最小/最大包络
+     * @param points 按 x 升序排列的点
+     * @param buckets 桶数
+     * @param upper 输出每个桶的最大值
+     * @param lower 输出每个桶的最小值，与 upper 的 x 一一对应
+     */
+    static void minMaxEnvelope(const QList<QPointF> &points, int buckets,
+                               QList<QPointF> &upper, QList<QPointF> &lower);
+    
+    /**
+     * @brief 截取 x 在 [minX, maxX] 内的点，两端各多保留一个点使折线延伸到边界
+     */
+    static QList<QPointF> visibleRange(const QList<QPointF> &points, qreal minX, qreal maxX);
+
+private:
+    Downsampler() = default;
+};
+
+#endif // DOWNSAMPLER_H
@@ -0,0 +1,165 @@
+/**
+ * @file fuzzymatcher.cpp
+ * @brief 模糊匹配打分工具实现
+ */
+
+#include "fuzzymatcher.h"
+#include <algorithm>
+
+namespace {
+const int PREFIX_BONUS = 300;
+const int EXACT_BONUS = 200;
+const int CONSECUTIVE_BONUS = 8;
+const int GAP_PENALTY = 10;
+const int EDIT_PENALTY = 150;
+}
+
+FuzzyMatcher::Tolerance FuzzyMatcher::tolerance(int keywordLength)
+{
+    if (keywordLength >= 8) {
+        return TwoEdits;
+    }
+    if (keywordLength >= 4) {
+        return OneEdit;
+    }
+    if (keywordLength >= 3) {
+        return Subsequence;
+    }
+    return SubstringOnly;
+}
+
+int FuzzyMatcher::score(QStringView text, QStringView keyword, bool allowEdits)
+{
+    if (keyword.isEmpty()) {
+        return 0;
+    }
+    if (text.isEmpty()) {
+        return NO_MATCH;
+    }
+    
+    qsizetype pos = text.indexOf(keyword);
+    if (pos >= 0) {
+        int result = SUBSTRING_SCORE - int(qMin<qsizetype>(pos, 100));
+        if (pos == 0) {
+            result += PREFIX_BONUS;
+            if (text.size() == keyword.size()) {
+                result += EXACT_BONUS;
+            }
+        }
+        return result;
+    }
+    
+    Tolerance level = tolerance(keyword.size());
+    if (level < Subsequence) {
+        return NO_MATCH;
+    }
+    
+    int result = subsequenceScore(text, keyword);
+    if (result != NO_MATCH || !allowEdits || level < OneEdit || !isLatin(keyword)) {
+        return result;
+    }
+    
+    int maxEdits = level == TwoEdits ? 2 : 1;
+    int distance = prefixEditDistance(text, keyword, maxEdits);
+    return distance <= maxEdits ? EDIT_SCORE - distance * EDIT_PENALTY : NO_MATCH;
+}
+
+int FuzzyMatcher::subsequenceScore(QStringView text, QStringView keyword)
+{
+    // 贪心地按顺序匹配每个字符，间隔越少、连续越多分数越高
+    const char16_t *t = text.utf16();
+    const char16_t *k = keyword.utf16();
+    const qsizetype n = text.size();
+    const qsizetype m = keyword.size();
+    
+    qsizetype ti = 0;
+    qsizetype last = -1;
+    int gaps = 0;
+    int consecutive = 0;
+    for (qsizetype ki = 0; ki < m; ++ki) {
+        const char16_t c = k[ki];
+        while (ti < n && t[ti] != c) {
+            ++ti;
+        }
+        if (ti == n) {
+            return NO_MATCH;
+        }
+        if (last >= 0) {
+            if (ti == last + 1) {
+                ++consecutive;
+            } else {
+                gaps += int(ti - last - 1);
+            }
+        } else {
+            gaps += int(ti);
+        }
+        last = ti++;
+    }
+    
+    // 保证子序列匹配始终低于子串、高于编辑距离匹配
+    int result = SUBSEQUENCE_SCORE + consecutive * CONSECUTIVE_BONUS - gaps * GAP_PENALTY;
+    return std::clamp(result, EDIT_SCORE + 1, SUBSTRING_SCORE - 101);
+}
+
+int FuzzyMatcher::prefixEditDistance(QStringView text, QStringView keyword, int maxEdits)
+{
+    const qsizetype m = keyword.size();
+    if (m == 0) {
+        return 0;
+    }
+    if (m > MAX_KEYWORD_LENGTH) {
+        return maxEdits + 1;
+    }
+    
+    // 比关键词长出 maxEdits 以上的前缀不可能更优
+    const qsizetype n = qMin<qsizetype>(text.size(), m + maxEdits);
+    const char16_t *t = text.utf16();
+    const char16_t *k = keyword.utf16();
+    
+    // 按文本逐列推进，三列滚动：prev2 用于相邻交换
+    // col[i] 为 keyword[0, i) 与 text[0, j) 的编辑距离
+    int prev2[MAX_KEYWORD_LENGTH + 1];
+    int prev[MAX_KEYWORD_LENGTH + 1];
+    int col[MAX_KEYWORD_LENGTH + 1];
+    for (qsizetype i = 0; i <= m; ++i) {
+        prev[i] = int(i);
+        prev2[i] = int(i);
+    }
+    
+    int best = prev[m];
+    for (qsizetype j = 1; j <= n; ++j) {
+        const char16_t tc = t[j - 1];
+        col[0] = int(j);
+        int columnMin = col[0];
+        for (qsizetype i = 1; i <= m; ++i) {
+            const char16_t kc = k[i - 1];
+            int cost = kc == tc ? 0 : 1;
+            int d = std::min({prev[i] + 1, col[i - 1] + 1, prev[i - 1] + cost});
+            if (i > 1 && j > 1 && kc == t[j - 2] && k[i - 2] == tc) {
+                d = std::min(d, prev2[i - 2] + 1);
+            }
+            col[i] = d;
+            columnMin = std::min(columnMin, d);
+        }
+        best = std::min(best, col[m]);
+        
+        // 整列都超过上限时后面的列只会更大
+        if (columnMin > maxEdits) {
+            break;
+        }
+        std::copy(prev, prev + m + 1, prev2);
+        std::copy(col, col + m + 1, prev);
+    }
+    
+    return best <= maxEdits ? best : maxEdits + 1;
+}
+
+bool FuzzyMatcher::isLatin(QStringView keyword)
+{
+    for (QChar ch : keyword) {
+        if (ch.unicode() >= 0x80) {
+            return false;
+        }
+    }
+    return true;
+}
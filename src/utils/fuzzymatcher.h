@@ -0,0 +1,75 @@
+/**
+ * @file fuzzymatcher.h
+ * @brief 模糊匹配打分工具
+ */
+
+#ifndef FUZZYMATCHER_H
+#define FUZZYMATCHER_H
+
+#include <QStringView>
+
+/**
+ * @class FuzzyMatcher
+ * @brief 带拼写容错的模糊匹配
+ * 
+ * 对已做大小写折叠的文本和关键词打分，分数越高越相关，不匹配返回 NO_MATCH。
+ * 按从严到宽的顺序尝试三种匹配：
+ * - 子串：前缀、全等另有加分，位置越靠前分数越高
+ * - 子序列：关键词的字符按顺序出现在文本中，如 bjng → beijing
+ * - 前缀编辑距离：关键词与文本某个前缀的编辑距离不超过容错次数，如 bejing → beijing
+ * 
+ * 容错程度随关键词长度增加（见 tolerance），关键词越短匹配越严格。
+ * 对同一文本，关键词追加字符后容错程度不变时，能匹配的文本只会减少，
+ * 调用方可据此只复查上一次的结果。
+ */
+class FuzzyMatcher
+{
+public:
+    static const int NO_MATCH = -1;
+    
+    /**
+     * @brief 匹配的容错程度
+     */
+    enum Tolerance {
+        SubstringOnly = 0,      // 只匹配子串
+        Subsequence = 1,        // 允许子序列
+        OneEdit = 2,            // 另允许 1 处拼写错误
+        TwoEdits = 3            // 另允许 2 处拼写错误
+    };
+    
+    /**
+     * @brief 关键词长度对应的容错程度
+     */
+    static Tolerance tolerance(int keywordLength);
+    
+    /**
+     * @brief 计算匹配分数
+     * @param text 已折叠大小写的文本
+     * @param keyword 已折叠大小写的关键词
+     * @param allowEdits 是否允许编辑距离匹配（只对拉丁字母/拼音有意义）
+     * @return 分数，不匹配时返回 NO_MATCH
+     */
+    static int score(QStringView text, QStringView keyword, bool allowEdits = true);
+    
+    /**
+     * @brief 关键词与文本任一前缀的最小编辑距离（插入、删除、替换、相邻交换）
+     * @param maxEdits 距离上限，超过时提前结束
+     * @return 编辑距离，超过上限时返回 maxEdits + 1
+     */
+    static int prefixEditDistance(QStringView text, QStringView keyword, int maxEdits);
+    
+    // 各类匹配的基础分
+    static const int SUBSTRING_SCORE = 1000;
+    static const int SUBSEQUENCE_SCORE = 600;
+    static const int EDIT_SCORE = 400;
+
+private:
+    FuzzyMatcher() = default;
+    
+    static int subsequenceScore(QStringView text, QStringView keyword);
+    static bool isLatin(QStringView keyword);
+    
+    static const int MAX_KEYWORD_LENGTH = 32;   // 编辑距离只对较短的关键词计算
+};
+
+#endif // FUZZYMATCHER_H
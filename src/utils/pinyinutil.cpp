@@ -0,0 +1,953 @@
+/**
+ * @file pinyinutil.cpp
+ * @brief 汉字拼音转换工具实现
+ */
+
+#include "pinyinutil.h"
+#include <QHash>
+#include <QStringList>
+#include <iterator>
+
+namespace {
+struct PinyinGroup {
+    const char *syllable;
+    const char16_t *characters;
+};
+
+// GB2312 一级汉字按拼音分组，每个汉字取其首个（最常用）读音
+const PinyinGroup PINYIN_TABLE[] = {
+    {"a", u"啊阿"},
+    {"ai", u"埃挨哎唉哀皑癌蔼矮艾碍爱隘"},
+    {"an", u"鞍氨安俺按暗岸胺案"},
+    {"ang", u"肮昂盎"},
+    {"ao", u"凹敖熬翱袄傲奥懊澳"},
+    {"ba", u"芭捌扒叭吧笆八疤巴拔跋靶把耙坝霸罢爸"},
+    {"bai", u"白柏百摆佰败拜稗"},
+    {"ban", u"斑班搬扳般颁板版扮拌伴瓣半办绊"},
+    {"bang", u"邦帮梆榜膀绑棒磅蚌镑傍谤"},
+    {"bao", u"苞胞包褒剥薄雹保堡饱宝抱报暴豹鲍爆"},
+    {"bei", u"杯碑悲卑北辈背贝钡倍狈备惫焙被"},
+    {"ben", u"奔苯本笨"},
+    {"beng", u"崩绷甭泵蹦迸"},
+    {"bi", u"逼鼻比鄙笔彼碧蓖蔽毕毙毖币庇痹闭敝弊必辟壁臂避陛"},
+    {"bian", u"鞭边编贬扁便变卞辨辩辫遍"},
+    {"biao", u"标彪膘表"},
+    {"bie", u"鳖憋别瘪"},
+    {"bin", u"彬斌濒滨宾摈"},
+    {"bing", u"兵冰柄丙秉饼炳病并"},
+    {"bo", u"玻菠播拨钵波博勃搏铂箔伯帛舶脖膊渤泊驳"},
+    {"bu", u"捕卜哺补埠不布步簿部怖"},
+    {"ca", u"擦"},
+    {"cai", u"猜裁材才财睬踩采彩菜蔡"},
+    {"can", u"餐参蚕残惭惨灿"},
+    {"cang", u"苍舱仓沧藏"},
+    {"cao", u"操糙槽曹草"},
+    {"ce", u"厕策侧册测"},
+    {"ceng", u"层蹭"},
+    {"cha", u"插叉茬茶查碴搽察岔差诧"},
+    {"chai", u"拆柴豺"},
+    {"chan", u"搀掺蝉馋谗缠铲产阐颤"},
+    {"chang", u"昌猖场尝常长偿肠厂敞畅唱倡"},
+    {"chao", u"超抄钞朝嘲潮巢吵炒"},
+    {"che", u"车扯撤掣彻澈"},
+    {"chen", u"郴臣辰尘晨忱沉陈趁衬"},
+    {"cheng", u"撑称城橙成呈乘程惩澄诚承逞骋秤"},
+    {"chi", u"吃痴持匙池迟弛驰耻齿侈尺赤翅斥炽"},
+    {"chong", u"充冲虫崇宠"},
+    {"chou", u"抽酬畴踌稠愁筹仇绸瞅丑臭"},
+    {"chu", u"初出橱厨躇锄雏滁除楚础储矗搐触处"},
+    {"chuai", u"揣"},
+    {"chuan", u"川穿椽传船喘串"},
+    {"chuang", u"疮窗幢床闯创"},
+    {"chui", u"吹炊捶锤垂"},
+    {"chun", u"春椿醇唇淳纯蠢"},
+    {"chuo", u"戳绰"},
+    {"ci", u"疵茨磁雌辞慈瓷词此刺赐次"},
+    {"cong", u"聪葱囱匆从丛"},
+    {"cou", u"凑"},
+    {"cu", u"粗醋簇促"},
+    {"cuan", u"蹿篡窜"},
+    {"cui", u"摧崔催脆瘁粹淬翠"},
+    {"cun", u"村存寸"},
+    {"cuo", u"磋撮搓措挫错"},
+    {"da", u"搭达答瘩打大"},
+    {"dai", u"呆歹傣戴带殆代贷袋待逮怠"},
+    {"dan", u"耽担丹单郸掸胆旦氮但惮淡诞弹蛋"},
+    {"dang", u"当挡党荡档"},
+    {"dao", u"刀捣蹈倒岛祷导到稻悼道盗"},
+    {"de", u"德得的"},
+    {"deng", u"蹬灯登等瞪凳邓"},
+    {"di", u"堤低滴迪敌笛狄涤翟嫡抵底地蒂第帝弟递缔"},
+    {"dian", u"颠掂滇碘点典靛垫电佃甸店惦奠淀殿"},
+    {"diao", u"碉叼雕凋刁掉吊钓调"},
+    {"die", u"跌爹碟蝶迭谍叠"},
+    {"ding", u"丁盯叮钉顶鼎锭定订"},
+    {"diu", u"丢"},
+    {"dong", u"东冬董懂动栋侗恫冻洞"},
+    {"dou", u"兜抖斗陡豆逗痘"},
+    {"du", u"都督毒犊独读堵睹赌杜镀肚度渡妒"},
+    {"duan", u"端短锻段断缎"},
+    {"dui", u"堆兑队对"},
+    {"dun", u"墩吨蹲敦顿囤钝盾遁"},
+    {"duo", u"掇哆多夺垛躲朵跺舵剁惰堕"},
+    {"e", u"蛾峨鹅俄额讹娥恶厄扼遏鄂饿"},
+    {"en", u"恩"},
+    {"er", u"而儿耳尔饵洱二贰"},
+    {"fa", u"发罚筏伐乏阀法珐"},
+    {"fan", u"藩帆番翻樊矾钒繁凡烦反返范贩犯饭泛"},
+    {"fang", u"坊芳方肪房防妨仿访纺放"},
+    {"fei", u"菲非啡飞肥匪诽吠肺废沸费"},
+    {"fen", u"芬酚吩氛分纷坟焚汾粉奋份忿愤粪"},
+    {"feng", u"丰封枫蜂峰锋风疯烽逢冯缝讽奉凤"},
+    {"fo", u"佛"},
+    {"fou", u"否"},
+    {"fu", u"夫敷肤孵扶拂辐幅氟符伏俘服浮涪福袱弗甫抚辅俯釜斧脯腑府腐赴副覆赋复傅付阜父腹负富讣附妇缚咐"},
+    {"ga", u"噶嘎"},
+    {"gai", u"该改概钙盖溉"},
+    {"gan", u"干甘杆柑竿肝赶感秆敢赣"},
+    {"gang", u"冈刚钢缸肛纲岗港杠"},
+    {"gao", u"篙皋高膏羔糕搞镐稿告"},
+    {"ge", u"哥歌搁戈鸽胳疙割革葛格蛤阁隔铬个各"},
+    {"gei", u"给"},
+    {"gen", u"根跟"},
+    {"geng", u"耕更庚羹埂耿梗"},
+    {"gong", u"工攻功恭龚供躬公宫弓巩汞拱贡共"},
+    {"gou", u"钩勾沟苟狗垢构购够"},
+    {"gu", u"辜菇咕箍估沽孤姑鼓古蛊骨谷股故顾固雇"},
+    {"gua", u"刮瓜剐寡挂褂"},
+    {"guai", u"乖拐怪"},
+    {"guan", u"棺关官冠观管馆罐惯灌贯"},
+    {"guang", u"光广逛"},
+    {"gui", u"瑰规圭硅归龟闺轨鬼诡癸桂柜跪贵刽"},
+    {"gun", u"辊滚棍"},
+    {"guo", u"锅郭国果裹过"},
+    {"ha", u"哈"},
+    {"hai", u"骸孩海氦亥害骇"},
+    {"han", u"酣憨邯韩含涵寒函喊罕翰撼捍旱憾悍焊汗汉"},
+    {"hang", u"夯杭航"},
+    {"hao", u"壕嚎豪毫郝好耗号浩"},
+    {"he", u"呵喝荷菏核禾和何合盒貉阂河涸赫褐鹤贺"},
+    {"hei", u"嘿黑"},
+    {"hen", u"痕很狠恨"},
+    {"heng", u"哼亨横衡恒"},
+    {"hong", u"轰哄烘虹鸿洪宏弘红"},
+    {"hou", u"喉侯猴吼厚候后"},
+    {"hu", u"呼乎忽瑚壶葫胡蝴狐糊湖弧虎唬护互沪户"},
+    {"hua", u"花哗华猾滑画划化话"},
+    {"huai", u"槐徊怀淮坏"},
+    {"huan", u"欢环桓还缓换患唤痪豢焕涣宦幻"},
+    {"huang", u"荒慌黄磺蝗簧皇凰惶煌晃幌恍谎"},
+    {"hui", u"灰挥辉徽恢蛔回毁悔慧卉惠晦贿秽会烩汇讳诲绘"},
+    {"hun", u"荤昏婚魂浑混"},
+    {"huo", u"豁活伙火获或惑霍货祸"},
+    {"ji", u"击圾基机畸稽积箕肌饥迹激讥鸡姬绩缉吉极棘辑籍集及急疾汲即嫉级挤几脊己蓟技冀季伎祭剂悸济寄寂计记既忌际妓继纪"},
+    {"jia", u"嘉枷夹佳家加荚颊贾甲钾假稼价架驾嫁"},
+    {"jian", u"歼监坚尖笺间煎兼肩艰奸缄茧检柬碱硷拣捡简俭剪减荐槛鉴践贱见键箭件健舰剑饯渐溅涧建"},
+    {"jiang", u"僵姜将浆江疆蒋桨奖讲匠酱降"},
+    {"jiao", u"蕉椒礁焦胶交郊浇骄娇嚼搅铰矫侥脚狡角饺缴绞剿教酵轿较叫窖"},
+    {"jie", u"揭接皆秸街阶截劫节桔杰捷睫竭洁结解姐戒藉芥界借介疥诫届"},
+    {"jin", u"巾筋斤金今津襟紧锦仅谨进靳晋禁近烬浸尽劲"},
+    {"jing", u"荆兢茎睛晶鲸京惊精粳经井警景颈静境敬镜径痉靖竟竞净"},
+    {"jiong", u"炯窘"},
+    {"jiu", u"揪究纠玖韭久灸九酒厩救旧臼舅咎就疚"},
+    {"ju", u"鞠拘狙疽居驹菊局咀矩举沮聚拒据巨具距踞锯俱句惧炬剧"},
+    {"juan", u"捐鹃娟倦眷卷绢"},
+    {"jue", u"撅攫抉掘倔爵觉决诀绝"},
+    {"jun", u"均菌钧军君峻俊竣浚郡骏"},
+    {"ka", u"喀咖卡咯"},
+    {"kai", u"开揩楷凯慨"},
+    {"kan", u"刊堪勘坎砍看"},
+    {"kang", u"康慷糠扛抗亢炕"},
+    {"kao", u"考拷烤靠"},
+    {"ke", u"坷苛柯棵磕颗科壳咳可渴克刻客课"},
+    {"ken", u"肯啃垦恳"},
+    {"keng", u"坑吭"},
+    {"kong", u"空恐孔控"},
+    {"kou", u"抠口扣寇"},
+    {"ku", u"枯哭窟苦酷库裤"},
+    {"kua", u"夸垮挎跨胯"},
+    {"kuai", u"块筷侩快"},
+    {"kuan", u"宽款"},
+    {"kuang", u"匡筐狂框矿眶旷况"},
+    {"kui", u"亏盔岿窥葵奎魁傀馈愧溃"},
+    {"kun", u"坤昆捆困"},
+    {"kuo", u"括扩廓阔"},
+    {"la", u"垃拉喇蜡腊辣啦"},
+    {"lai", u"莱来赖"},
+    {"lan", u"蓝婪栏拦篮阑兰澜谰揽览懒缆烂滥"},
+    {"lang", u"琅榔狼廊郎朗浪"},
+    {"lao", u"捞劳牢老佬姥酪烙涝"},
+    {"le", u"勒乐"},
+    {"lei", u"雷镭蕾磊累儡垒擂肋类泪"},
+    {"leng", u"棱楞冷"},
+    {"li", u"厘梨犁黎篱狸离漓理李里鲤礼莉荔吏栗丽厉励砾历利傈例俐痢立粒沥隶力璃哩"},
+    {"lia", u"俩"},
+    {"lian", u"联莲连镰廉怜涟帘敛脸链恋炼练"},
+    {"liang", u"粮凉梁粱良两辆量晾亮谅"},
+    {"liao", u"撩聊僚疗燎寥辽潦了撂镣廖料"},
+    {"lie", u"列裂烈劣猎"},
+    {"lin", u"琳林磷霖临邻鳞淋凛赁吝拎"},
+    {"ling", u"玲菱零龄铃伶羚凌灵陵岭领另令"},
+    {"liu", u"溜琉榴硫馏留刘瘤流柳六"},
+    {"long", u"龙聋咙笼窿隆垄拢陇"},
+    {"lou", u"楼娄搂篓漏陋"},
+    {"lu", u"芦卢颅庐炉掳卤虏鲁麓碌露路赂鹿潞禄录陆戮"},
+    {"lv", u"驴吕铝侣旅履屡缕虑氯律率滤绿"},
+    {"luan", u"峦挛孪滦卵乱"},
+    {"lve", u"掠略"},
+    {"lun", u"抡轮伦仑沦纶论"},
+    {"luo", u"萝螺罗逻锣箩骡裸落洛骆络"},
+    {"ma", u"妈麻玛码蚂马骂嘛吗"},
+    {"mai", u"埋买麦卖迈脉"},
+    {"man", u"瞒馒蛮满蔓曼慢漫谩"},
+    {"mang", u"芒茫盲氓忙莽"},
+    {"mao", u"猫茅锚毛矛铆卯茂冒帽貌贸"},
+    {"me", u"么"},
+    {"mei", u"玫枚梅酶霉煤没眉媒镁每美昧寐妹媚"},
+    {"men", u"门闷们"},
+    {"meng", u"萌蒙檬盟锰猛梦孟"},
+    {"mi", u"眯醚靡糜迷谜弥米秘觅泌蜜密幂"},
+    {"mian", u"棉眠绵冕免勉娩缅面"},
+    {"miao", u"苗描瞄藐秒渺庙妙"},
+    {"mie", u"蔑灭"},
+    {"min", u"民抿皿敏悯闽"},
+    {"ming", u"明螟鸣铭名命"},
+    {"miu", u"谬"},
+    {"mo", u"摸摹蘑模膜磨摩魔抹末莫墨默沫漠寞陌"},
+    {"mou", u"谋牟某"},
+    {"mu", u"拇牡亩姆母墓暮幕募慕木目睦牧穆"},
+    {"na", u"拿哪呐钠那娜纳"},
+    {"nai", u"氖乃奶耐奈"},
+    {"nan", u"南男难"},
+    {"nang", u"囊"},
+    {"nao", u"挠脑恼闹淖"},
+    {"ne", u"呢"},
+    {"nei", u"馁内"},
+    {"nen", u"嫩"},
+    {"neng", u"能"},
+    {"ni", u"妮霓倪泥尼拟你匿腻逆溺"},
+    {"nian", u"蔫拈年碾撵捻念"},
+    {"niang", u"娘酿"},
+    {"niao", u"鸟尿"},
+    {"nie", u"捏聂孽啮镊镍涅"},
+    {"nin", u"您"},
+    {"ning", u"柠狞凝宁拧泞"},
+    {"niu", u"牛扭钮纽"},
+    {"nong", u"脓浓农弄"},
+    {"nu", u"奴努怒"},
+    {"nv", u"女"},
+    {"nuan", u"暖"},
+    {"nve", u"虐疟"},
+    {"nuo", u"挪懦糯诺"},
+    {"o", u"哦"},
+    {"ou", u"欧鸥殴藕呕偶沤"},
+    {"pa", u"啪趴爬帕怕琶"},
+    {"pai", u"拍排牌徘湃派"},
+    {"pan", u"攀潘盘磐盼畔判叛"},
+    {"pang", u"乓庞旁耪胖"},
+    {"pao", u"抛咆刨炮袍跑泡"},
+    {"pei", u"呸胚培裴赔陪配佩沛"},
+    {"pen", u"喷盆"},
+    {"peng", u"砰抨烹澎彭蓬棚硼篷膨朋鹏捧碰"},
+    {"pi", u"坯砒霹批披劈琵毗啤脾疲皮匹痞僻屁譬"},
+    {"pian", u"篇偏片骗"},
+    {"piao", u"飘漂瓢票"},
+    {"pie", u"撇瞥"},
+    {"pin", u"拼频贫品聘"},
+    {"ping", u"乒坪苹萍平凭瓶评屏"},
+    {"po", u"坡泼颇婆破魄迫粕"},
+    {"pou", u"剖"},
+    {"pu", u"扑铺仆莆葡菩蒲埔朴圃普浦谱曝瀑"},
+    {"qi", u"期欺栖戚妻七凄漆柒沏其棋奇歧畦崎脐齐旗祈祁骑起岂乞企启契砌器气迄弃汽泣讫"},
+    {"qia", u"掐恰洽"},
+    {"qian", u"牵扦钎铅千迁签仟谦乾黔钱钳前潜遣浅谴堑嵌欠歉"},
+    {"qiang", u"枪呛腔羌墙蔷强抢"},
+    {"qiao", u"橇锹敲悄桥瞧乔侨巧鞘撬翘峭俏窍"},
+    {"qie", u"切茄且怯窃"},
+    {"qin", u"钦侵亲秦琴勤芹擒禽寝沁"},
+    {"qing", u"青轻氢倾卿清擎晴氰情顷请庆"},
+    {"qiong", u"琼穷"},
+    {"qiu", u"秋丘邱球求囚酋泅"},
+    {"qu", u"趋区蛆曲躯屈驱渠取娶龋趣去"},
+    {"quan", u"圈颧权醛泉全痊拳犬券劝"},
+    {"que", u"缺炔瘸却鹊榷确雀"},
+    {"qun", u"裙群"},
+    {"ran", u"然燃冉染"},
+    {"rang", u"瓤壤攘嚷让"},
+    {"rao", u"饶扰绕"},
+    {"re", u"惹热"},
+    {"ren", u"壬仁人忍韧任认刃妊纫"},
+    {"reng", u"扔仍"},
+    {"ri", u"日"},
+    {"rong", u"戎茸蓉荣融熔溶容绒冗"},
+    {"rou", u"揉柔肉"},
+    {"ru", u"茹蠕儒孺如辱乳汝入褥"},
+    {"ruan", u"软阮"},
+    {"rui", u"蕊瑞锐"},
+    {"run", u"闰润"},
+    {"ruo", u"若弱"},
+    {"sa", u"撒洒萨"},
+    {"sai", u"腮鳃塞赛"},
+    {"san", u"三叁伞散"},
+    {"sang", u"桑嗓丧"},
+    {"sao", u"搔骚扫嫂"},
+    {"se", u"瑟色涩"},
+    {"sen", u"森"},
+    {"seng", u"僧"},
+    {"sha", u"莎砂杀刹沙纱傻啥煞"},
+    {"shai", u"筛晒"},
+    {"shan", u"珊苫杉山删煽衫闪陕擅赡膳善汕扇缮"},
+    {"shang", u"墒伤商赏晌上尚裳"},
+    {"shao", u"梢捎稍烧芍勺韶少哨邵绍"},
+    {"she", u"奢赊蛇舌舍赦摄射慑涉社设"},
+    {"shen", u"砷申呻伸身深娠绅神沈审婶甚肾慎渗"},
+    {"sheng", u"声生甥牲升绳省盛剩胜圣"},
+    {"shi", u"师失狮施湿诗尸虱十石拾时什食蚀实识史矢使屎驶始式示士世柿事拭誓逝势是嗜噬适仕侍释饰氏市恃室视试"},
+    {"shou", u"收手首守寿授售受瘦兽"},
+    {"shu", u"蔬枢梳殊抒输叔舒淑疏书赎孰熟薯暑曙署蜀黍鼠属术述树束戍竖墅庶数漱恕"},
+    {"shua", u"刷耍"},
+    {"shuai", u"摔衰甩帅"},
+    {"shuan", u"栓拴"},
+    {"shuang", u"霜双爽"},
+    {"shui", u"谁水睡税"},
+    {"shun", u"吮瞬顺舜"},
+    {"shuo", u"说硕朔烁"},
+    {"si", u"斯撕嘶思私司丝死肆寺嗣四伺似饲巳"},
+    {"song", u"松耸怂颂送宋讼诵"},
+    {"sou", u"搜艘擞嗽"},
+    {"su", u"苏酥俗素速粟僳塑溯宿诉肃"},
+    {"suan", u"酸蒜算"},
+    {"sui", u"虽隋随绥髓碎岁穗遂隧祟"},
+    {"sun", u"孙损笋"},
+    {"suo", u"蓑梭唆缩琐索锁所"},
+    {"ta", u"塌他它她塔獭挞蹋踏"},
+    {"tai", u"胎苔抬台泰酞太态汰"},
+    {"tan", u"坍摊贪瘫滩坛檀痰潭谭谈坦毯袒碳探叹炭"},
+    {"tang", u"汤塘搪堂棠膛唐糖倘躺淌趟烫"},
+    {"tao", u"掏涛滔绦萄桃逃淘陶讨套"},
+    {"te", u"特"},
+    {"teng", u"藤腾疼誊"},
+    {"ti", u"梯剔踢锑提题蹄啼体替嚏惕涕剃屉"},
+    {"tian", u"天添填田甜恬舔腆"},
+    {"tiao", u"挑条迢眺跳"},
+    {"tie", u"贴铁帖"},
+    {"ting", u"厅听烃汀廷停亭庭挺艇"},
+    {"tong", u"通桐酮瞳同铜彤童桶捅筒统痛"},
+    {"tou", u"偷投头透"},
+    {"tu", u"凸秃突图徒途涂屠土吐兔"},
+    {"tuan", u"湍团"},
+    {"tui", u"推颓腿蜕褪退"},
+    {"tun", u"吞屯臀"},
+    {"tuo", u"拖托脱鸵陀驮驼椭妥拓唾"},
+    {"wa", u"挖哇蛙洼娃瓦袜"},
+    {"wai", u"歪外"},
+    {"wan", u"豌弯湾玩顽丸烷完碗挽晚皖惋宛婉万腕"},
+    {"wang", u"汪王亡枉网往旺望忘妄"},
+    {"wei", u"威巍微危韦违桅围唯惟为潍维苇萎委伟伪尾纬未蔚味畏胃喂魏位渭谓尉慰卫"},
+    {"wen", u"瘟温蚊文闻纹吻稳紊问"},
+    {"weng", u"嗡翁瓮"},
+    {"wo", u"挝蜗涡窝我斡卧握沃"},
+    {"wu", u"巫呜钨乌污诬屋无芜梧吾吴毋武五捂午舞伍侮坞戊雾晤物勿务悟误"},
+    {"xi", u"昔熙析西硒矽晰嘻吸锡牺稀息希悉膝夕惜熄烯溪汐犀檄袭席习媳喜铣洗系隙戏细"},
+    {"xia", u"瞎虾匣霞辖暇峡侠狭下厦夏吓"},
+    {"xian", u"掀锨先仙鲜纤咸贤衔舷闲涎弦嫌显险现献县腺馅羡宪陷限线"},
+    {"xiang", u"相厢镶香箱襄湘乡翔祥详想响享项巷橡像向象"},
+    {"xiao", u"萧硝霄削哮嚣销消宵淆晓小孝校肖啸笑效"},
+    {"xie", u"楔些歇蝎鞋协挟携邪斜胁谐写械卸蟹懈泄泻谢屑"},
+    {"xin", u"薪芯锌欣辛新忻心信衅"},
+    {"xing", u"星腥猩惺兴刑型形邢行醒幸杏性姓"},
+    {"xiong", u"兄凶胸匈汹雄熊"},
+    {"xiu", u"休修羞朽嗅锈秀袖绣"},
+    {"xu", u"墟戌需虚嘘须徐许蓄酗叙旭序畜恤絮婿绪续"},
+    {"xuan", u"轩喧宣悬旋玄选癣眩绚"},
+    {"xue", u"靴薛学穴雪血"},
+    {"xun", u"勋熏循旬询寻驯巡殉汛训讯逊迅"},
+    {"ya", u"压押鸦鸭呀丫芽牙蚜崖衙涯雅哑亚讶"},
+    {"yan", u"焉咽阉烟淹盐严研蜒岩延言颜阎炎沿奄掩眼衍演艳堰燕厌砚雁唁彦焰宴谚验"},
+    {"yang", u"殃央鸯秧杨扬佯疡羊洋阳氧仰痒养样漾"},
+    {"yao", u"邀腰妖瑶摇尧遥窑谣姚咬舀药要耀"},
+    {"ye", u"椰噎耶爷野冶也页掖业叶曳腋夜液"},
+    {"yi", u"一壹医揖铱依伊衣颐夷遗移仪胰疑沂宜姨彝椅蚁倚已乙矣以艺抑易邑屹亿役臆逸肄疫亦裔意毅忆义益溢诣议谊译异翼翌绎"},
+    {"yin", u"茵荫因殷音阴姻吟银淫寅饮尹引隐印"},
+    {"ying", u"英樱婴鹰应缨莹萤营荧蝇迎赢盈影颖硬映"},
+    {"yo", u"哟"},
+    {"yong", u"拥佣臃痈庸雍踊蛹咏泳涌永恿勇用"},
+    {"you", u"幽优悠忧尤由邮铀犹油游酉有友右佑釉诱又幼"},
+    {"yu", u"迂淤于盂榆虞愚舆余俞逾鱼愉渝渔隅予娱雨与屿禹宇语羽玉域芋郁吁遇喻峪御愈欲狱育誉浴寓裕预豫驭"},
+    {"yuan", u"鸳渊冤元垣袁原援辕园员圆猿源缘远苑愿怨院"},
+    {"yue", u"曰约越跃钥岳粤月悦阅"},
+    {"yun", u"耘云郧匀陨允运蕴酝晕韵孕"},
+    {"za", u"匝砸杂"},
+    {"zai", u"栽哉灾宰载再在"},
+    {"zan", u"咱攒暂赞"},
+    {"zang", u"赃脏葬"},
+    {"zao", u"遭糟凿藻枣早澡蚤躁噪造皂灶燥"},
+    {"ze", u"责择则泽"},
+    {"zei", u"贼"},
+    {"zen", u"怎"},
+    {"zeng", u"增憎曾赠"},
+    {"zha", u"扎喳渣札轧铡闸眨栅榨咋乍炸诈"},
+    {"zhai", u"摘斋宅窄债寨"},
+    {"zhan", u"瞻毡詹粘沾盏斩辗崭展蘸栈占战站湛绽"},
+    {"zhang", u"樟章彰漳张掌涨杖丈帐账仗胀瘴障"},
+    {"zhao", u"招昭找沼赵照罩兆肇召"},
+    {"zhe", u"遮折哲蛰辙者锗蔗这浙"},
+    {"zhen", u"珍斟真甄砧臻贞针侦枕疹诊震振镇阵"},
+    {"zheng", u"蒸挣睁征狰争怔整拯正政帧症郑证"},
+    {"zhi", u"芝枝支吱蜘知肢脂汁之织职直植殖执值侄址指止趾只旨纸志挚掷至致置帜峙制智秩稚质炙痔滞治窒"},
+    {"zhong", u"中盅忠钟衷终种肿重仲众"},
+    {"zhou", u"舟周州洲诌粥轴肘帚咒皱宙昼骤"},
+    {"zhu", u"珠株蛛朱猪诸诛逐竹烛煮拄瞩嘱主著柱助蛀贮铸筑住注祝驻"},
+    {"zhua", u"抓爪"},
+    {"zhuai", u"拽"},
+    {"zhuan", u"专砖转撰赚篆"},
+    {"zhuang", u"桩庄装妆撞壮状"},
+    {"zhui", u"椎锥追赘坠缀"},
+    {"zhun", u"谆准"},
+    {"zhuo", u"捉拙卓桌琢茁酌啄着灼浊"},
+    {"zi", u"兹咨资姿滋淄孜紫仔籽滓子自渍字"},
+    {"zong", u"鬃棕踪宗综总纵"},
+    {"zou", u"邹走奏揍"},
+    {"zu", u"租足卒族祖诅阻组"},
+    {"zuan", u"钻纂"},
+    {"zui", u"嘴醉最罪"},
+    {"zun", u"尊遵"},
+    {"zuo", u"昨左佐柞做作坐座"},
+};
+
+// GB2312 二级汉字（多为地名、人名用字，如 衢、泸、濮、漯），同样取首个读音
+const PinyinGroup PINYIN_TABLE_LEVEL2[] = {
+    {"a", u"嗄锕"},
+    {"ai", u"捱嗳嗌嫒瑷暧砹锿霭"},
+    {"an", u"谙埯揞犴庵桉铵鹌黯"},
+    {"ao", u"坳拗嗷岙廒遨媪骜獒聱螯鏊鳌鏖"},
+    {"ba", u"茇菝岜灞钯粑鲅魃"},
+    {"bai", u"捭掰擘"},
+    {"ban", u"阪坂钣瘢癍舨"},
+    {"bang", u"蒡浜"},
+    {"bao", u"勹葆孢煲鸨褓趵龅"},
+    {"bei", u"孛陂邶蓓呗悖碚鹎褙鐾鞴"},
+    {"ben", u"畚坌贲锛"},
+    {"beng", u"嘣甏"},
+    {"bi", u"匕俾荜荸萆薜吡哔狴庳愎滗濞弼妣婢嬖璧畀铋秕裨筚箅篦舭襞跸髀"},
+    {"bian", u"匾弁苄忭汴缏煸砭碥窆褊蝙笾鳊"},
+    {"biao", u"婊骠杓飑飙飚灬镖镳瘭裱鳔髟"},
+    {"bie", u"蹩"},
+    {"bin", u"傧豳缤玢槟殡膑镔髌鬓"},
+    {"bing", u"禀冫邴摒"},
+    {"bo", u"亳啵饽檗礴钹鹁簸跛踣"},
+    {"bu", u"卟逋瓿晡钚钸醭"},
+    {"ca", u"嚓礤"},
+    {"can", u"孱骖璨粲黪"},
+    {"cang", u"伧"},
+    {"cao", u"艹嘈漕螬艚"},
+    {"ce", u"恻"},
+    {"cen", u"岑涔"},
+    {"ceng", u"噌"},
+    {"cha", u"猹馇汊姹杈槎檫锸镲衩"},
+    {"chai", u"侪钗瘥虿"},
+    {"chan", u"冁谄蒇廛忏潺澶羼婵骣觇禅镡蟾躔"},
+    {"chang", u"伥鬯苌菖徜怅惝阊娼嫦昶氅鲳"},
+    {"chao", u"怊晁焯耖"},
+    {"che", u"坼屮砗"},
+    {"chen", u"谌谶抻嗔宸琛榇碜龀"},
+    {"cheng", u"丞埕枨柽晟塍瞠铖裎蛏酲"},
+    {"chi", u"傺坻墀茌叱哧啻嗤彳饬媸敕眵鸱瘛褫蚩螭笞篪踟魑"},
+    {"chong", u"茺忡憧铳舂艟"},
+    {"chou", u"俦帱惆瘳雠"},
+    {"chu", u"亍刍怵憷绌杵楮樗褚蜍蹰黜"},
+    {"chuai", u"搋啜嘬膪踹"},
+    {"chuan", u"舛遄巛氚钏舡"},
+    {"chuang", u"怆"},
+    {"chui", u"陲棰槌"},
+    {"chun", u"莼鹑蝽"},
+    {"chuo", u"辶辍踔龊"},
+    {"ci", u"茈呲祠鹚糍"},
+    {"cong", u"苁淙骢琮璁枞"},
+    {"cou", u"辏腠"},
+    {"cu", u"蔟徂猝殂酢蹙蹴"},
+    {"cuan", u"汆撺爨镩"},
+    {"cui", u"萃啐悴璀榱毳"},
+    {"cun", u"忖皴"},
+    {"cuo", u"厝嵯脞锉矬痤鹾蹉"},
+    {"da", u"耷哒嗒怛妲沓褡笪靼鞑"},
+    {"dai", u"埭甙呔岱迨骀绐玳黛"},
+    {"dan", u"儋萏啖澹殚赕眈疸瘅聃箪"},
+    {"dang", u"谠凼菪宕砀铛裆"},
+    {"dao", u"刂叨忉氘焘纛"},
+    {"de", u"锝"},
+    {"deng", u"噔嶝戥磴镫簦"},
+    {"di", u"氐籴诋谛邸荻嘀娣柢棣觌砥碲睇镝羝骶"},
+    {"dian", u"阽坫巅玷钿癜癫簟踮"},
+    {"diao", u"铞铫貂鲷"},
+    {"die", u"垤堞揲喋嗲牒瓞耋蹀鲽"},
+    {"ding", u"仃啶玎腚碇铤疔耵酊"},
+    {"diu", u"铥"},
+    {"dong", u"垌咚岽峒氡胨胴硐鸫"},
+    {"dou", u"蔸窦蚪篼"},
+    {"du", u"芏嘟渎椟牍碡蠹笃髑黩"},
+    {"duan", u"椴煅簖"},
+    {"dui", u"怼憝碓镦"},
+    {"dun", u"沌炖砘礅盹趸"},
+    {"duo", u"咄哚缍柁铎裰踱"},
+    {"e", u"噩谔垩苊莪萼呃愕阏屙婀轭腭锇锷鹗颚鳄"},
+    {"ei", u"诶"},
+    {"en", u"蒽摁"},
+    {"er", u"佴迩珥铒鸸鲕"},
+    {"fa", u"垡砝"},
+    {"fan", u"蕃蘩幡梵燔畈蹯"},
+    {"fang", u"匚邡彷枋钫舫鲂"},
+    {"fei", u"芾狒悱淝妃绯榧腓斐扉镄痱蜚篚翡霏鲱"},
+    {"fen", u"偾瀵棼鲼鼢"},
+    {"feng", u"俸酆葑唪沣砜"},
+    {"fou", u"缶"},
+    {"fu", u"匐凫阝郛芙苻茯莩菔拊呋呒幞怫滏艴孚驸绂绋桴赙祓砩黻黼罘稃馥蚨蜉蝠蝮麸趺跗鲋鳆"},
+    {"ga", u"尬呷尕尜旮钆"},
+    {"gai", u"丐陔垓戤赅"},
+    {"gan", u"坩苷尴擀泔淦澉绀橄旰矸疳酐"},
+    {"gang", u"戆罡筻"},
+    {"gao", u"睾诰郜藁缟槔槁杲锆"},
+    {"ge", u"鬲仡哿圪塥嗝纥搿膈硌镉袼虼舸骼"},
+    {"gen", u"亘茛哏艮"},
+    {"geng", u"哽赓绠鲠"},
+    {"gong", u"廾珙肱蚣觥"},
+    {"gou", u"佝诟岣遘媾缑枸觏彀笱篝鞲"},
+    {"gu", u"嘏诂菰呱崮汩梏轱牯牿臌毂瞽罟钴锢鸪鹄痼蛄酤觚鲴鹘"},
+    {"gua", u"卦诖栝胍鸹聒"},
+    {"guai", u"掴"},
+    {"guan", u"倌莞掼涫盥鹳鳏"},
+    {"guang", u"咣犷桄胱"},
+    {"gui", u"匦刿庋宄妫桧晷皈簋鲑鳜"},
+    {"gun", u"丨衮绲磙鲧"},
+    {"guo", u"馘埚呙帼崞猓椁虢蜾蝈"},
+    {"ha", u"铪"},
+    {"hai", u"嗨胲醢"},
+    {"han", u"邗菡撖阚瀚晗焓顸颔蚶鼾"},
+    {"hang", u"沆绗珩颃"},
+    {"hao", u"蒿薅嗥嚆濠灏昊皓颢蚝"},
+    {"he", u"诃劾壑嗬阖曷盍颌蚵翮"},
+    {"heng", u"蘅桁"},
+    {"hong", u"黉訇讧荭蕻薨闳泓"},
+    {"hou", u"堠後逅瘊篌糇鲎骺"},
+    {"hu", u"冱唿囫岵猢怙惚浒滹琥槲轷觳烀煳戽扈祜瓠鹕鹱虍笏醐斛"},
+    {"hua", u"骅桦铧"},
+    {"huai", u"踝"},
+    {"huan", u"郇奂萑擐圜獾洹浣漶寰逭缳锾鲩鬟"},
+    {"huang", u"隍徨湟潢遑璜肓癀蟥篁鳇"},
+    {"hui", u"诙茴荟蕙咴哕喙隳洄浍彗缋珲晖恚虺蟪麾"},
+    {"hun", u"诨馄阍溷"},
+    {"huo", u"劐藿攉嚯夥砉钬锪镬耠蠖"},
+    {"ji", u"丌亟乩剞佶偈诘墼芨芰荠蒺蕺掎叽咭哜唧岌嵴洎彐屐骥畿玑楫殛戟戢赍觊犄齑矶羁嵇稷瘠虮笈笄暨跻跽霁鲚鲫髻麂"},
+    {"jia", u"伽郏葭岬浃迦珈戛胛恝铗镓痂瘕蛱笳袈跏"},
+    {"jian", u"僭谏谫菅蒹搛囝湔蹇謇缣枧楗戋戬牮犍毽腱睑锏鹣裥笕翦趼踺鲣鞯"},
+    {"jiang", u"茳洚绛缰犟礓耩糨豇"},
+    {"jiao", u"佼僬艽茭挢噍峤徼湫姣敫皎鹪蛟醮跤鲛"},
+    {"jie", u"讦卩拮喈嗟婕孑桀碣疖颉蚧羯鲒骱"},
+    {"jin", u"卺荩堇噤馑廑妗缙瑾槿赆觐钅衿矜"},
+    {"jing", u"刭儆阱菁獍憬泾迳弪婧肼胫腈旌靓"},
+    {"jiong", u"冂迥炅扃"},
+    {"jiu", u"僦啾阄柩桕鸠鹫赳鬏"},
+    {"ju", u"倨讵苣苴莒菹掬遽屦琚椐榘榉橘犋飓钜锔窭裾趄醵踽龃雎鞫"},
+    {"juan", u"鄄狷涓桊蠲锩镌隽"},
+    {"jue", u"厥劂谲矍蕨噘噱崛獗孓珏桷橛爝镢蹶觖"},
+    {"jun", u"捃皲麇"},
+    {"ka", u"佧咔胩"},
+    {"kai", u"剀垲蒈忾恺铠锎锴"},
+    {"kan", u"侃莰戡龛瞰"},
+    {"kang", u"伉闶钪"},
+    {"kao", u"尻栲犒铐"},
+    {"ke", u"嗑岢恪溘骒缂珂轲氪瞌钶锞稞疴窠颏蝌髁"},
+    {"ken", u"裉龈"},
+    {"keng", u"铿"},
+    {"kong", u"倥崆箜"},
+    {"kou", u"芤蔻叩眍筘"},
+    {"ku", u"刳堀喾绔骷"},
+    {"kua", u"侉"},
+    {"kuai", u"蒯郐哙狯脍"},
+    {"kuan", u"髋"},
+    {"kuang", u"诓诳邝圹夼哐纩贶"},
+    {"kui", u"馗匮夔隗蒉揆喹喟悝愦逵暌睽聩蝰篑跬"},
+    {"kun", u"悃阃琨锟醌鲲髡"},
+    {"kuo", u"蛞"},
+    {"la", u"剌邋旯砬瘌"},
+    {"lai", u"崃徕涞濑赉睐铼癞籁"},
+    {"lan", u"岚漤榄斓罱镧褴"},
+    {"lang", u"莨蒗啷阆锒稂螂"},
+    {"lao", u"唠崂栳铑铹痨耢醪"},
+    {"le", u"仂叻泐鳓"},
+    {"lei", u"羸诔嘞嫘缧檑耒酹"},
+    {"leng", u"塄愣"},
+    {"li", u"俪俚郦坜苈莅蓠藜呖唳喱猁溧澧逦娌嫠骊缡枥栎轹戾砺詈罹锂鹂疠疬蛎蜊蠡笠篥粝醴跞雳鲡鳢黧"},
+    {"lian", u"蔹奁潋濂琏楝殓臁裢裣蠊鲢"},
+    {"liang", u"墚椋踉魉"},
+    {"liao", u"蓼尥嘹獠寮缭钌鹩"},
+    {"lie", u"冽埒捩咧洌趔躐鬣"},
+    {"lin", u"蔺啉嶙廪懔遴檩辚膦瞵粼躏麟"},
+    {"ling", u"酃苓呤囹泠绫柃棂瓴聆蛉翎鲮"},
+    {"liu", u"浏遛骝绺旒熘锍镏鹨鎏"},
+    {"long", u"垅茏泷珑栊胧砻癃"},
+    {"lou", u"偻蒌喽嵝镂瘘耧蝼髅"},
+    {"lu", u"垆撸噜泸渌漉逯璐栌橹轳辂辘氇胪镥鸬鹭簏舻鲈"},
+    {"luan", u"脔娈栾鸾銮"},
+    {"lun", u"囵"},
+    {"luo", u"倮蠃荦摞猡泺漯珞椤脶镙瘰雒"},
+    {"lv", u"捋闾榈膂稆褛"},
+    {"lve", u"锊"},
+    {"ma", u"唛犸嬷杩蟆"},
+    {"mai", u"劢荬霾"},
+    {"man", u"墁幔缦熳镘颟螨蹒鳗鞔"},
+    {"mang", u"邙漭硭蟒"},
+    {"mao", u"袤茆峁泖瑁昴牦耄旄懋瞀蝥蟊髦"},
+    {"mei", u"莓嵋猸浼湄楣镅鹛袂魅"},
+    {"men", u"扪焖懑钔"},
+    {"meng", u"勐甍瞢懵朦礞虻蜢蠓艋艨"},
+    {"mi", u"芈冖谧蘼咪嘧猕汨宓弭脒祢敉糸縻麋"},
+    {"mian", u"沔渑湎宀腼眄黾"},
+    {"miao", u"喵邈缈杪淼眇鹋"},
+    {"mie", u"乜咩蠛篾"},
+    {"min", u"苠岷闵泯缗珉愍鳘"},
+    {"ming", u"冥茗溟暝瞑酩"},
+    {"mo", u"谟茉蓦馍嫫殁镆秣瘼耱貊貘麽"},
+    {"mou", u"侔哞缪眸蛑鍪"},
+    {"mu", u"仫坶苜沐毪钼"},
+    {"n", u"嗯"},
+    {"na", u"捺肭镎衲"},
+    {"nai", u"鼐艿萘柰"},
+    {"nan", u"喃囡楠腩蝻赧"},
+    {"nang", u"攮囔馕曩"},
+    {"nao", u"孬垴呶猱瑙硇铙蛲"},
+    {"ne", u"讷疒"},
+    {"nen", u"恁"},
+    {"ni", u"伲坭猊怩昵旎睨铌鲵"},
+    {"nian", u"廿埝辇黏鲇鲶"},
+    {"niao", u"茑嬲脲袅"},
+    {"nie", u"陧蘖嗫颞臬蹑"},
+    {"ning", u"佞咛甯聍"},
+    {"niu", u"狃忸妞"},
+    {"nong", u"侬哝"},
+    {"nou", u"耨"},
+    {"nu", u"弩胬孥驽"},
+    {"nuo", u"傩搦喏锘"},
+    {"nv", u"恧钕衄"},
+    {"o", u"喔噢"},
+    {"ou", u"讴怄瓯耦"},
+    {"pa", u"葩杷筢"},
+    {"pai", u"俳蒎哌"},
+    {"pan", u"拚爿泮袢襻蟠"},
+    {"pang", u"滂逄螃"},
+    {"pao", u"匏狍庖脬疱"},
+    {"pei", u"辔帔旆锫醅霈"},
+    {"pen", u"湓"},
+    {"peng", u"堋嘭怦蟛"},
+    {"pi", u"丕仳陴邳郫圮埤鼙芘擗噼庀淠媲纰枇甓睥罴铍癖疋蚍蜱貔"},
+    {"pian", u"谝骈犏胼翩蹁"},
+    {"piao", u"剽嘌嫖缥殍瞟螵"},
+    {"pie", u"丿苤氕"},
+    {"pin", u"姘嫔榀牝颦"},
+    {"ping", u"俜娉枰鲆"},
+    {"po", u"叵鄱珀钋钷皤笸"},
+    {"pou", u"裒掊"},
+    {"pu", u"匍噗溥濮璞攴氆攵镤镨蹼"},
+    {"qi", u"亓俟圻芑芪萁萋葺蕲嘁屺岐汔淇骐绮琪琦杞桤槭耆祺憩碛颀蛴蜞綦綮蹊鳍麒"},
+    {"qia", u"葜袷髂"},
+    {"qian", u"倩佥阡凵芊芡茜掮岍悭慊骞搴褰缱椠肷愆钤虔箝"},
+    {"qiang", u"丬戕嫱樯戗炝锖锵镪襁蜣羟跄"},
+    {"qiao", u"劁诮谯荞愀憔缲樵硗跷鞒"},
+    {"qie", u"郄惬妾挈锲箧"},
+    {"qin", u"芩揿吣嗪噙溱檎锓螓衾"},
+    {"qing", u"苘圊檠磬蜻罄箐謦鲭黥"},
+    {"qiong", u"邛芎茕穹蛩筇跫銎"},
+    {"qiu", u"俅巯犰逑遒楸赇虬蚯蝤裘糗鳅鼽"},
+    {"qu", u"诎劬蕖蘧岖衢阒璩觑氍朐祛磲鸲癯蛐蠼麴瞿黢"},
+    {"quan", u"诠荃犭悛绻辁畎铨蜷筌鬈"},
+    {"que", u"阕阙悫"},
+    {"qun", u"逡"},
+    {"ran", u"苒蚺髯"},
+    {"rang", u"禳穰"},
+    {"rao", u"荛娆桡"},
+    {"ren", u"亻仞荏葚饪轫稔衽"},
+    {"rong", u"嵘狨榕肜蝾"},
+    {"rou", u"糅蹂鞣"},
+    {"ru", u"蓐薷嚅洳溽濡缛铷襦颥"},
+    {"ruan", u"朊"},
+    {"rui", u"芮蕤枘睿蚋"},
+    {"ruo", u"偌箬"},
+    {"sa", u"卅仨挲脎飒"},
+    {"sai", u"噻"},
+    {"san", u"馓毵糁"},
+    {"sang", u"搡磉颡"},
+    {"sao", u"埽缫臊瘙鳋"},
+    {"se", u"啬铯穑"},
+    {"sha", u"唼歃铩痧裟霎鲨"},
+    {"shai", u"酾"},
+    {"shan", u"剡讪鄯埏芟彡潸姗嬗骟膻钐疝蟮舢跚鳝"},
+    {"shang", u"垧绱殇熵觞"},
+    {"shao", u"劭苕潲蛸筲艄"},
+    {"she", u"厍佘猞滠歙畲麝"},
+    {"shen", u"诜谂莘哂渖椹胂矧蜃"},
+    {"sheng", u"嵊眚笙"},
+    {"shi", u"谥埘莳蓍弑饣轼贳炻礻铈螫舐筮豉豕鲥鲺"},
+    {"shou", u"扌狩绶艏"},
+    {"shu", u"倏塾菽摅沭澍姝纾毹腧殳秫"},
+    {"shua", u"唰"},
+    {"shuai", u"蟀"},
+    {"shuan", u"闩涮"},
+    {"shuang", u"孀"},
+    {"shui", u"氵"},
+    {"shuo", u"蒴搠妁槊铄"},
+    {"si", u"厮兕厶咝汜泗澌姒驷纟缌祀锶鸶耜蛳笥"},
+    {"song", u"凇菘崧嵩忪悚淞竦"},
+    {"sou", u"叟薮嗖嗾馊溲飕瞍锼螋"},
+    {"su", u"夙谡蔌嗉愫涑簌觫稣"},
+    {"suan", u"狻"},
+    {"sui", u"谇荽濉邃燧眭睢"},
+    {"sun", u"荪狲飧榫隼"},
+    {"suo", u"唢嗦嗍娑桫睃羧"},
+    {"ta", u"闼溻遢榻铊趿鳎"},
+    {"tai", u"邰薹肽炱钛跆鲐"},
+    {"tan", u"郯昙忐钽锬覃"},
+    {"tang", u"傥帑饧溏瑭樘铴镗耥螗螳羰醣"},
+    {"tao", u"鼗啕洮韬饕"},
+    {"te", u"忒忑慝铽"},
+    {"teng", u"滕"},
+    {"ti", u"倜荑悌逖绨缇鹈裼醍"},
+    {"tian", u"掭忝阗殄畋"},
+    {"tiao", u"佻祧窕蜩笤粜龆鲦髫"},
+    {"tie", u"萜餮"},
+    {"ting", u"莛葶婷梃町蜓霆"},
+    {"tong", u"佟僮仝茼嗵恸潼砼"},
+    {"tou", u"亠钭骰"},
+    {"tu", u"堍荼菟钍酴"},
+    {"tuan", u"抟彖疃"},
+    {"tui", u"煺"},
+    {"tun", u"氽饨暾豚"},
+    {"tuo", u"乇佗坨庹沲沱柝橐砣箨酡跎鼍"},
+    {"wa", u"佤娲腽"},
+    {"wai", u"崴"},
+    {"wan", u"剜芄菀纨绾琬脘畹蜿"},
+    {"wang", u"罔惘辋魍"},
+    {"wei", u"偎诿隈圩葳薇囗帏帷嵬猥猬闱沩洧涠逶娓玮韪軎炜煨痿艉鲔"},
+    {"wen", u"刎阌汶玟璺雯"},
+    {"weng", u"蓊蕹"},
+    {"wo", u"倭莴幄渥肟硪龌"},
+    {"wu", u"兀仵阢邬圬芴唔庑怃忤浯寤迕妩婺骛杌牾焐鹉鹜痦蜈鋈鼯"},
+    {"xi", u"僖兮隰郗菥葸蓰奚唏徙饩阋浠淅屣嬉玺樨曦觋欷熹禊禧皙穸蜥螅蟋舄舾羲粞翕醯鼷"},
+    {"xia", u"狎遐瑕柙硖罅黠"},
+    {"xian", u"冼苋莶藓岘猃暹娴氙燹祆鹇痫蚬筅籼酰跣跹霰"},
+    {"xiang", u"芗葙饷庠骧缃蟓鲞飨"},
+    {"xiao", u"哓崤潇逍骁绡枭枵筱箫魈"},
+    {"xie", u"偕亵勰燮薤撷獬廨渫瀣邂绁缬榭榍躞"},
+    {"xin", u"囟馨忄昕歆鑫"},
+    {"xing", u"陉荇荥擤悻硎"},
+    {"xiu", u"咻岫馐庥溴鸺貅髹"},
+    {"xu", u"诩勖蓿洫溆顼栩煦盱胥糈醑"},
+    {"xuan", u"儇谖萱揎泫渲漩璇楦暄炫煊碹铉镟痃"},
+    {"xue", u"谑泶踅鳕"},
+    {"xun", u"巽埙荀荨蕈薰峋徇獯恂洵浔曛窨醺鲟"},
+    {"ya", u"伢垭揠吖岈迓娅琊桠氩砑睚痖"},
+    {"yan", u"厣赝俨偃兖讠谳郾鄢芫菸崦恹闫湮滟妍嫣琰檐晏胭腌焱罨筵酽魇餍鼹"},
+    {"yang", u"徉怏泱炀烊恙蛘鞅"},
+    {"yao", u"夭爻吆崾徭幺珧杳轺曜肴鹞窈繇鳐"},
+    {"ye", u"靥谒邺揶晔烨铘"},
+    {"yi", u"刈劓佚佾诒圯埸懿苡薏弈奕挹弋呓咦咿噫峄嶷猗饴怿怡悒漪迤驿缢殪轶贻欹旖熠眙钇镒镱痍瘗癔翊衤蜴舣羿翳酏黟"},
+    {"yin", u"胤鄞廴垠堙茚吲喑狺夤洇氤铟瘾蚓霪"},
+    {"ying", u"嬴郢茔莺萦蓥撄嘤膺滢潆瀛瑛璎楹媵鹦瘿颍罂"},
+    {"yo", u"唷"},
+    {"yong", u"俑壅墉喁慵邕镛甬鳙饔"},
+    {"you", u"卣攸侑莠莜莸尢呦囿宥柚猷牖铕疣蚰蚴蝣鱿黝鼬"},
+    {"yu", u"禺毓伛俣谀谕萸蓣揄圄圉嵛狳饫馀庾阈鬻妪妤纡瑜昱觎腴欤於煜燠肀聿钰鹆鹬瘐瘀窬窳蜮蝓竽臾舁雩龉"},
+    {"yuan", u"垸塬掾沅媛瑗橼爰眢鸢螈箢鼋"},
+    {"yue", u"龠瀹樾刖钺"},
+    {"yun", u"郓芸狁恽愠纭韫殒昀氲熨筠"},
+    {"za", u"拶咂"},
+    {"zai", u"崽甾"},
+    {"zan", u"瓒昝簪糌趱錾"},
+    {"zang", u"奘驵臧"},
+    {"zao", u"唣"},
+    {"ze", u"仄赜啧帻迮昃笮箦舴"},
+    {"zen", u"谮"},
+    {"zeng", u"缯甑罾锃"},
+    {"zha", u"揸吒咤哳楂砟痄蚱齄"},
+    {"zhai", u"砦瘵"},
+    {"zhan", u"谵搌旃"},
+    {"zhang", u"仉鄣幛嶂獐嫜璋蟑"},
+    {"zhao", u"诏啁棹钊笊"},
+    {"zhe", u"谪摺柘辄磔鹧褶蜇赭"},
+    {"zhen", u"圳蓁浈缜桢榛轸赈胗朕祯畛稹鸩箴"},
+    {"zheng", u"诤峥钲铮筝"},
+    {"zhi", u"卮陟郅埴芷摭帙徵夂忮彘咫骘栉枳栀桎轵轾贽胝膣祉祗黹雉鸷痣蛭絷酯跖踬踯豸觯"},
+    {"zhong", u"冢锺螽舯踵"},
+    {"zhou", u"荮妯纣绉胄籀酎"},
+    {"zhu", u"丶伫侏邾苎茱洙渚潴杼槠橥炷铢疰瘃竺箸舳翥躅麈"},
+    {"zhuan", u"啭馔颛"},
+    {"zhui", u"惴骓缒隹"},
+    {"zhun", u"肫窀"},
+    {"zhuo", u"倬诼擢浞涿濯禚斫镯"},
+    {"zi", u"谘嵫姊孳缁梓辎赀恣眦锱秭耔笫粢趑觜訾龇鲻髭"},
+    {"zong", u"偬腙粽"},
+    {"zou", u"诹陬鄹驺楱鲰"},
+    {"zu", u"俎镞"},
+    {"zuan", u"攥缵躜"},
+    {"zui", u"蕞"},
+    {"zun", u"撙樽鳟"},
+    {"zuo", u"阼唑怍胙祚"},
+};
+
+// 地名中常用读音与首个读音不同的多音字
+const PinyinGroup PLACE_NAME_OVERRIDES[] = {
+    {"chong", u"重"},   // 重庆
+    {"zang", u"藏"},    // 西藏
+};
+
+// 读音取决于整个地名的多音字，逐字转换前先按地名匹配
+struct PlaceNamePhrase {
+    const char16_t *name;
+    const char *syllables;  // 空格分隔，与 name 逐字对应
+};
+
+const PlaceNamePhrase PLACE_NAME_PHRASES[] = {
+    {u"蚌埠", "beng bu"},
+    {u"六安", "lu an"},
+    {u"六合", "lu he"},
+    {u"乐清", "yue qing"},
+    {u"乐亭", "lao ting"},
+    {u"番禺", "pan yu"},
+    {u"铅山", "yan shan"},
+    {u"尉犁", "yu li"},
+    {u"洪洞", "hong tong"},
+    {u"单县", "shan xian"},
+    {u"东阿", "dong e"},
+    {u"蔚县", "yu xian"},
+    {u"牟平", "mu ping"},
+    {u"莘县", "shen xian"},
+    {u"亳州", "bo zhou"},
+    {u"枞阳", "zong yang"},
+    {u"涡阳", "guo yang"},
+    {u"荥阳", "xing yang"},
+    {u"阆中", "lang zhong"},
+    {u"瑷珲", "ai hui"},
+    {u"鄱阳", "po yang"},
+    {u"歙县", "she xian"},
+    {u"黟县", "yi xian"},
+    {u"睢宁", "sui ning"},
+    {u"睢县", "sui xian"},
+    {u"黄陂", "huang pi"},
+    {u"筠连", "jun lian"},
+    {u"会稽", "kuai ji"},
+};
+
+struct PlaceName {
+    QString name;
+    QStringList syllables;
+};
+
+// 首字 → 以该字开头的地名
+const QHash<QChar, QList<PlaceName>> &placeNameTable()
+{
+    static const QHash<QChar, QList<PlaceName>> table = [] {
+        QHash<QChar, QList<PlaceName>> result;
+        for (const PlaceNamePhrase &phrase : PLACE_NAME_PHRASES) {
+            PlaceName placeName;
+            placeName.name = QString::fromUtf16(phrase.name);
+            placeName.syllables = QString::fromLatin1(phrase.syllables).split(' ');
+            result[placeName.name.at(0)].append(placeName);
+        }
+        return result;
+    }();
+    return table;
+}
+
+const QHash<QChar, QString> &pinyinTable()
+{
+    static const QHash<QChar, QString> table = [] {
+        QHash<QChar, QString> result;
+        result.reserve(6800);
+        auto addGroups = [&result](const PinyinGroup *begin, const PinyinGroup *end) {
+            for (const PinyinGroup *group = begin; group != end; ++group) {
+                QString syllable = QString::fromLatin1(group->syllable);
+                for (const char16_t *ch = group->characters; *ch; ++ch) {
+                    result.insert(QChar(*ch), syllable);
+                }
+            }
+        };
+        addGroups(std::begin(PINYIN_TABLE), std::end(PINYIN_TABLE));
+        addGroups(std::begin(PINYIN_TABLE_LEVEL2), std::end(PINYIN_TABLE_LEVEL2));
+        for (const PinyinGroup &group : PLACE_NAME_OVERRIDES) {
+            result.insert(QChar(group.characters[0]), QString::fromLatin1(group.syllable));
+        }
+        return result;
+    }();
+    return table;
+}
+}
+
+QString PinyinUtil::syllable(QChar ch)
+{
+    return pinyinTable().value(ch);
+}
+
+QStringList PinyinUtil::syllables(const QString &text)
+{
+    QStringList result;
+    result.reserve(text.size());
+    const QHash<QChar, QList<PlaceName>> &placeNames = placeNameTable();
+    
+    for (int i = 0; i < text.size(); ++i) {
+        const QChar ch = text.at(i);
+        if (ch.isLetterOrNumber() && ch.unicode() < 0x80) {
+            result.append(QString(ch.toLower()));
+            continue;
+        }
+        
+        auto it = placeNames.constFind(ch);
+        const PlaceName *matched = nullptr;
+        if (it != placeNames.constEnd()) {
+            for (const PlaceName &placeName : *it) {
+                if (QStringView(text).mid(i).startsWith(placeName.name)) {
+                    matched = &placeName;
+                    break;
+                }
+            }
+        }
+        if (matched) {
+            result.append(matched->syllables);
+            i += matched->name.size() - 1;
+        } else {
+            result.append(syllable(ch));
+        }
+    }
+    return result;
+}
+
+QStringList PinyinUtil::placeNames()
+{
+    QStringList result;
+    for (const PlaceNamePhrase &phrase : PLACE_NAME_PHRASES) {
+        result.append(QString::fromUtf16(phrase.name));
+    }
+    return result;
+}
+
+int PinyinUtil::tableVersion()
+{
+    // 2: 加入 GB2312 二级汉字
+    return 2;
+}
+
+QString PinyinUtil::fullPinyin(const QString &text)
+{
+    return syllables(text).join(QString());
+}
+
+QString PinyinUtil::initials(const QString &text)
+{
+    QString result;
+    const QStringList parts = syllables(text);
+    result.reserve(parts.size());
+    for (const QString &part : parts) {
+        if (!part.isEmpty()) {
+            result.append(part.at(0));
+        }
+    }
+    return result;
+}
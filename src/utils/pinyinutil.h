@@ -0,0 +1,61 @@
+/**
+ * @file pinyinutil.h
+ * @brief 汉字拼音转换工具
+ */
+
+#ifndef PINYINUTIL_H
+#define PINYINUTIL_H
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * @class PinyinUtil
+ * @brief 汉字转拼音工具
+ * 
+ * 覆盖 GB2312 的一、二级汉字（共 6763 个），用于城市名的拼音检索：
+ * - 全拼: 北京 → beijing
+ * - 首字母: 北京 → bj
+ * 
+ * ASCII 字母和数字转为小写保留，其余字符（空格、标点、未收录的汉字）忽略
+ */
+class PinyinUtil
+{
+public:
+    /**
+     * @brief 单个汉字的拼音（不带声调），未收录时返回空字符串
+     */
+    static QString syllable(QChar ch);
+    
+    /**
+     * @brief 逐字的拼音，地名中的多音字按整个地名取读音（如 蚌埠 → beng bu）
+     * 
+     * 与 text 逐字对应，ASCII 字母数字转为小写，其他字符和未收录的汉字对应空字符串
+     */
+    static QStringList syllables(const QString &text);
+    
+    /**
+     * @brief 按整个地名确定读音的地名列表，读音表更新后用于找出需要重算拼音的城市
+     */
+    static QStringList placeNames();
+    
+    /**
+     * @brief 读音表的版本，字表扩充或读音修改时递增，数据库据此重算所有城市的拼音
+     */
+    static int tableVersion();
+    
+    /**
+     * @brief 全拼
+     */
+    static QString fullPinyin(const QString &text);
+    
+    /**
+     * @brief 拼音首字母
+     */
+    static QString initials(const QString &text);
+
+private:
+    PinyinUtil() = default;
+};
+
+#endif // PINYINUTIL_H
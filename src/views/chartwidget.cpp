@@ -6,8 +6,15 @@
 #include "chartwidget.h"
 #include "ui_chartwidget.h"
 #include "../config/configmanager.h"
+#include "../utils/downsampler.h"
+#include "../services/historytileloader.h"
+#include "../services/asyncdataservice.h"
+#include "../services/citydirectory.h"
 #include <QtCharts/QBarSet>
 #include <QDateTime>
+#include <QtCharts/QLegendMarker>
+#include <QWheelEvent>
+#include <QMouseEvent>
 
 ChartWidget::ChartWidget(QWidget *parent)
     : QWidget(parent)
@@ -16,6 +23,37 @@ ChartWidget::ChartWidget(QWidget *parent)
     , m_dailyChartView(nullptr)
     , m_hourlyChart(nullptr)
     , m_dailyChart(nullptr)
+    , m_hourlySeries(nullptr)
+    , m_hourlyUpperSeries(nullptr)
+    , m_hourlyLowerSeries(nullptr)
+    , m_hourlyEnvelope(nullptr)
+    , m_hourlyAxisX(nullptr)
+    , m_hourlyAxisY(nullptr)
+    , m_hourlyPlotWidth(0)
+    , m_hourlyUpdating(false)
+    , m_dailySeries(nullptr)
+    , m_dailyHighSeries(nullptr)
+    , m_dailyLowSeries(nullptr)
+    , m_dailyAreaSeries(nullptr)
+    , m_dailyAxisX(nullptr)
+    , m_dailyAxisY(nullptr)
+    , m_historyChartView(nullptr)
+    , m_historyChart(nullptr)
+    , m_historySeries(nullptr)
+    , m_historyUpperSeries(nullptr)
+    , m_historyLowerSeries(nullptr)
+    , m_historyEnvelope(nullptr)
+    , m_historyAxisX(nullptr)
+    , m_historyAxisY(nullptr)
+    , m_historyLoader(nullptr)
+    , m_historyPlotWidth(0)
+    , m_historyUpdating(false)
+    , m_historyPanning(false)
+    , m_historyPanX(0)
+    , m_compareChartView(nullptr)
+    , m_compareChart(nullptr)
+    , m_compareAxisX(nullptr)
+    , m_compareAxisY(nullptr)
     , m_currentChartType(Temperature)
 {
     ui->setupUi(this);
@@ -34,6 +72,12 @@ void ChartWidget::setupConnections()
             this, &ChartWidget::onRefreshClicked);
     connect(ui->chartTypeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &ChartWidget::onChartTypeChanged);
+    connect(ui->compareAddBtn, &QPushButton::clicked,
+            this, &ChartWidget::onCompareAddClicked);
+    connect(ui->compareFavoritesBtn, &QPushButton::clicked,
+            this, &ChartWidget::onCompareFavoritesClicked);
+    connect(ui->compareClearBtn, &QPushButton::clicked,
+            this, &ChartWidget::onCompareClearClicked);
 }
 
 void ChartWidget::setupCharts()
@@ -44,19 +88,160 @@ void ChartWidget::setupCharts()
     m_hourlyChart->legend()->setVisible(true);
     m_hourlyChart->legend()->setAlignment(Qt::AlignBottom);
     
+    // 降采样时在折线下方显示每个像素桶的最小/最大范围，避免峰值被丢掉
+    m_hourlyUpperSeries = new QLineSeries();
+    m_hourlyLowerSeries = new QLineSeries();
+    m_hourlyEnvelope = new QAreaSeries(m_hourlyUpperSeries, m_hourlyLowerSeries);
+    m_hourlyEnvelope->setOpacity(0.3);
+    m_hourlyChart->addSeries(m_hourlyEnvelope);
+    
+    m_hourlySeries = new QLineSeries();
+    m_hourlyChart->addSeries(m_hourlySeries);
+    
+    // X轴 - 时间
+    m_hourlyAxisX = new QDateTimeAxis();
+    m_hourlyAxisX->setFormat("HH:mm");
+    m_hourlyAxisX->setTitleText(tr("时间"));
+    m_hourlyChart->addAxis(m_hourlyAxisX, Qt::AlignBottom);
+    
+    m_hourlyAxisY = new QValueAxis();
+    m_hourlyChart->addAxis(m_hourlyAxisY, Qt::AlignLeft);
+    for (QAbstractSeries *series : m_hourlyChart->series()) {
+        series->attachAxis(m_hourlyAxisX);
+        series->attachAxis(m_hourlyAxisY);
+    }
+    
     m_hourlyChartView = new QChartView(m_hourlyChart);
     m_hourlyChartView->setRenderHint(QPainter::Antialiasing);
+    m_hourlyChartView->setRubberBand(QChartView::HorizontalRubberBand);
     ui->hourlyChartLayout->addWidget(m_hourlyChartView);
     
+    // 缩放和窗口大小变化后按新的可见范围和宽度重新降采样
+    connect(m_hourlyAxisX, &QDateTimeAxis::rangeChanged, this, [this]() {
+        if (!m_hourlyUpdating) {
+            resampleHourlySeries();
+        }
+    });
+    connect(m_hourlyChart, &QChart::plotAreaChanged, this, [this](const QRectF &plotArea) {
+        if (qRound(plotArea.width()) != m_hourlyPlotWidth) {
+            resampleHourlySeries();
+        }
+    });
+    
     // 创建日图表
     m_dailyChart = new QChart();
     m_dailyChart->setAnimationOptions(QChart::SeriesAnimations);
     m_dailyChart->legend()->setVisible(true);
     m_dailyChart->legend()->setAlignment(Qt::AlignBottom);
     
+    // 温度使用区域图显示高低温范围，其他类型使用单条折线
+    m_dailyHighSeries = new QLineSeries();
+    m_dailyLowSeries = new QLineSeries();
+    m_dailyHighSeries->setName(tr("最高温"));
+    m_dailyLowSeries->setName(tr("最低温"));
+    
+    m_dailyAreaSeries = new QAreaSeries(m_dailyHighSeries, m_dailyLowSeries);
+    m_dailyAreaSeries->setName(tr("温度范围"));
+    m_dailyAreaSeries->setOpacity(0.3);
+    
+    m_dailySeries = new QLineSeries();
+    
+    m_dailyChart->addSeries(m_dailyAreaSeries);
+    m_dailyChart->addSeries(m_dailyHighSeries);
+    m_dailyChart->addSeries(m_dailyLowSeries);
+    m_dailyChart->addSeries(m_dailySeries);
+    
+    m_dailyAxisX = new QBarCategoryAxis();
+    m_dailyAxisY = new QValueAxis();
+    m_dailyChart->addAxis(m_dailyAxisX, Qt::AlignBottom);
+    m_dailyChart->addAxis(m_dailyAxisY, Qt::AlignLeft);
+    for (QAbstractSeries *series : m_dailyChart->series()) {
+        series->attachAxis(m_dailyAxisX);
+        series->attachAxis(m_dailyAxisY);
+    }
+    
     m_dailyChartView = new QChartView(m_dailyChart);
     m_dailyChartView->setRenderHint(QPainter::Antialiasing);
     ui->dailyChartLayout->addWidget(m_dailyChartView);
+    
+    setupHistoryChart();
+    setupComparisonChart();
+    
+    updateHourlyChart();
+    updateDailyChart();
+}
+
+void ChartWidget::setupHistoryChart()
+{
+    // 历史图表的点数已限制在绘图区宽度以内，平移缩放时不使用动画
+    m_historyChart = new QChart();
+    m_historyChart->setAnimationOptions(QChart::NoAnimation);
+    m_historyChart->legend()->setVisible(true);
+    m_historyChart->legend()->setAlignment(Qt::AlignBottom);
+    
+    m_historyUpperSeries = new QLineSeries();
+    m_historyLowerSeries = new QLineSeries();
+    m_historyEnvelope = new QAreaSeries(m_historyUpperSeries, m_historyLowerSeries);
+    m_historyEnvelope->setOpacity(0.3);
+    m_historyChart->addSeries(m_historyEnvelope);
+    
+    m_historySeries = new QLineSeries();
+    m_historyChart->addSeries(m_historySeries);
+    
+    m_historyAxisX = new QDateTimeAxis();
+    m_historyAxisX->setTitleText(tr("时间"));
+    m_historyAxisY = new QValueAxis();
+    m_historyChart->addAxis(m_historyAxisX, Qt::AlignBottom);
+    m_historyChart->addAxis(m_historyAxisY, Qt::AlignLeft);
+    for (QAbstractSeries *series : m_historyChart->series()) {
+        series->attachAxis(m_historyAxisX);
+        series->attachAxis(m_historyAxisY);
+    }
+    
+    m_historyChartView = new QChartView(m_historyChart);
+    m_historyChartView->setRenderHint(QPainter::Antialiasing);
+    m_historyChartView->viewport()->installEventFilter(this);
+    ui->historyChartLayout->addWidget(m_historyChartView);
+    
+    m_historyLoader = new HistoryTileLoader(this);
+    connect(m_historyLoader, &HistoryTileLoader::tilesLoaded,
+            this, &ChartWidget::showHistoryPoints);
+    
+    connect(m_historyAxisX, &QDateTimeAxis::rangeChanged, this, [this]() {
+        if (!m_historyUpdating) {
+            updateHistoryView();
+        }
+    });
+    connect(m_historyChart, &QChart::plotAreaChanged, this, [this](const QRectF &plotArea) {
+        if (qRound(plotArea.width()) != m_historyPlotWidth) {
+            updateHistoryView();
+        }
+    });
+    
+    m_historyChart->setTitle(tr("暂无数据"));
+    resetHistoryRange();
+}
+
+void ChartWidget::setupComparisonChart()
+{
+    m_compareChart = new QChart();
+    m_compareChart->setAnimationOptions(QChart::NoAnimation);
+    m_compareChart->legend()->setVisible(true);
+    m_compareChart->legend()->setAlignment(Qt::AlignRight);
+    
+    // 所有城市共享同一组坐标轴
+    m_compareAxisX = new QDateTimeAxis();
+    m_compareAxisX->setFormat("HH:mm");
+    m_compareAxisX->setTitleText(tr("时间"));
+    m_compareAxisY = new QValueAxis();
+    m_compareChart->addAxis(m_compareAxisX, Qt::AlignBottom);
+    m_compareChart->addAxis(m_compareAxisY, Qt::AlignLeft);
+    
+    m_compareChartView = new QChartView(m_compareChart);
+    m_compareChartView->setRenderHint(QPainter::Antialiasing);
+    ui->compareChartLayout->addWidget(m_compareChartView);
+    
+    updateComparisonChart();
 }
 
 void ChartWidget::setCity(const QString &cityId, const QString &cityName)
@@ -64,6 +249,7 @@ void ChartWidget::setCity(const QString &cityId, const QString &cityName)
     m_currentCityId = cityId;
     m_currentCityName = cityName;
     ui->cityLabel->setText(cityName);
+    m_historyLoader->setCity(cityId);
     clear();
 }
 
@@ -71,6 +257,19 @@ void ChartWidget::updateHourlyData(const QList<HourlyForecast> &forecast)
 {
     m_hourlyData = forecast;
     updateHourlyChart();
+    
+    // 对比中的城市收到新数据时同步更新
+    if (m_compareCityIds.contains(m_currentCityId)) {
+        m_compareData.insert(m_currentCityId, forecast);
+        updateComparisonChart();
+    }
+}
+
+void ChartWidget::setComparisonCities(const QStringList &cityIds)
+{
+    m_compareCityIds = cityIds.mid(0, MAX_COMPARISON_CITIES);
+    m_compareCityIds.removeDuplicates();
+    loadComparisonData();
 }
 
 void ChartWidget::updateDailyData(const QList<DailyForecast> &forecast)
@@ -83,16 +282,13 @@ void ChartWidget::clear()
 {
     m_hourlyData.clear();
     m_dailyData.clear();
-    m_hourlyChart->removeAllSeries();
-    m_dailyChart->removeAllSeries();
+    updateHourlyChart();
+    updateDailyChart();
     
-    // 清除坐标轴
-    for (QAbstractAxis *axis : m_hourlyChart->axes()) {
-        m_hourlyChart->removeAxis(axis);
-    }
-    for (QAbstractAxis *axis : m_dailyChart->axes()) {
-        m_dailyChart->removeAxis(axis);
-    }
+    m_historySeries->clear();
+    m_historyUpperSeries->clear();
+    m_historyLowerSeries->clear();
+    resetHistoryRange();
 }
 
 void ChartWidget::onRefreshClicked()
@@ -107,267 +303,610 @@ void ChartWidget::onChartTypeChanged(int index)
     m_currentChartType = static_cast<ChartType>(index);
     updateHourlyChart();
     updateDailyChart();
+    updateHistoryView();
+    updateComparisonChart();
 }
 
-void ChartWidget::updateHourlyChart()
+void ChartWidget::onCompareAddClicked()
 {
-    m_hourlyChart->removeAllSeries();
-    for (QAbstractAxis *axis : m_hourlyChart->axes()) {
-        m_hourlyChart->removeAxis(axis);
+    if (m_currentCityId.isEmpty() || m_compareCityIds.contains(m_currentCityId)) {
+        return;
     }
-    
-    if (m_hourlyData.isEmpty()) {
-        m_hourlyChart->setTitle(tr("暂无数据"));
+    if (m_compareCityIds.size() >= MAX_COMPARISON_CITIES) {
+        ui->compareStatusLabel->setText(tr("最多对比 %1 个城市").arg(MAX_COMPARISON_CITIES));
         return;
     }
     
-    switch (m_currentChartType) {
-        case Temperature:
-            createTemperatureChart(m_hourlyChart, true);
-            break;
-        case Humidity:
-            createHumidityChart(m_hourlyChart, true);
-            break;
-        case WindSpeed:
-            createWindSpeedChart(m_hourlyChart, true);
-            break;
-        case Pressure:
-            createPressureChart(m_hourlyChart, true);
-            break;
+    m_compareNames.insert(m_currentCityId, m_currentCityName);
+    if (!m_hourlyData.isEmpty()) {
+        m_compareData.insert(m_currentCityId, m_hourlyData);
     }
+    setComparisonCities(m_compareCityIds + QStringList{m_currentCityId});
 }
 
-void ChartWidget::updateDailyChart()
+void ChartWidget::onCompareFavoritesClicked()
 {
-    m_dailyChart->removeAllSeries();
-    for (QAbstractAxis *axis : m_dailyChart->axes()) {
-        m_dailyChart->removeAxis(axis);
-    }
+    AsyncDataService::instance().getFavoriteCities().then(this, [this](const QList<CityInfo> &cities) {
+        QStringList cityIds;
+        for (const CityInfo &city : cities) {
+            m_compareNames.insert(city.cityId, city.name);
+            cityIds.append(city.cityId);
+        }
+        setComparisonCities(cityIds);
+    });
+}
+
+void ChartWidget::onCompareClearClicked()
+{
+    // 同时丢弃缓存的数据，下次对比时重新读取
+    m_compareData.clear();
+    setComparisonCities(QStringList());
+}
+
+void ChartWidget::updateHourlyChart()
+{
+    bool hasData = !m_hourlyData.isEmpty();
+    setSeriesVisible(m_hourlyChart, m_hourlySeries, hasData);
+    m_hourlyAxisX->setVisible(hasData);
+    m_hourlyAxisY->setVisible(hasData);
     
-    if (m_dailyData.isEmpty()) {
-        m_dailyChart->setTitle(tr("暂无数据"));
+    if (!hasData) {
+        m_hourlyPoints.clear();
+        m_hourlySeries->clear();
+        m_hourlyUpperSeries->clear();
+        m_hourlyLowerSeries->clear();
+        setSeriesVisible(m_hourlyChart, m_hourlyEnvelope, false);
+        m_hourlyChart->setTitle(tr("暂无数据"));
         return;
     }
     
+    QList<QPointF> points;
+    points.reserve(m_hourlyData.size());
+    qreal minValue = 0, maxValue = 0;
+    for (const HourlyForecast &h : std::as_const(m_hourlyData)) {
+        qreal value = hourlyValue(h);
+        if (points.isEmpty()) {
+            minValue = maxValue = value;
+        } else {
+            minValue = qMin(minValue, value);
+            maxValue = qMax(maxValue, value);
+        }
+        points.append(QPointF(h.time.toMSecsSinceEpoch(), value));
+    }
+    
+    m_hourlyPoints = points;
+    m_hourlySeries->setName(seriesName());
+    m_hourlyEnvelope->setName(tr("%1范围").arg(seriesName()));
+    
+    // 新数据显示全部时间范围，范围变化引起的重新降采样合并到最后一次
+    m_hourlyUpdating = true;
+    m_hourlyAxisX->setRange(m_hourlyData.first().time, m_hourlyData.last().time);
+    
+    setValueAxis(m_hourlyAxisY, minValue, maxValue);
     switch (m_currentChartType) {
         case Temperature:
-            createTemperatureChart(m_dailyChart, false);
+            m_hourlyChart->setTitle(tr("24小时温度趋势"));
             break;
         case Humidity:
-            createHumidityChart(m_dailyChart, false);
+            m_hourlyChart->setTitle(tr("24小时湿度变化"));
             break;
         case WindSpeed:
-            createWindSpeedChart(m_dailyChart, false);
+            m_hourlyChart->setTitle(tr("24小时风速变化"));
             break;
         case Pressure:
-            createPressureChart(m_dailyChart, false);
+            m_hourlyChart->setTitle(tr("24小时气压变化"));
             break;
     }
+    
+    m_hourlyUpdating = false;
+    
+    resampleHourlySeries();
 }
 
-void ChartWidget::createTemperatureChart(QChart *chart, bool isHourly)
+void ChartWidget::resampleHourlySeries()
 {
-    chart->setTitle(isHourly ? tr("24小时温度趋势") : tr("7日温度趋势"));
+    if (m_hourlyPoints.isEmpty()) {
+        return;
+    }
     
-    if (isHourly) {
-        QLineSeries *series = new QLineSeries();
-        series->setName(tr("温度"));
-        
-        qreal minTemp = 100, maxTemp = -100;
-        for (const HourlyForecast &h : m_hourlyData) {
-            series->append(h.time.toMSecsSinceEpoch(), h.temperature);
-            minTemp = qMin(minTemp, h.temperature);
-            maxTemp = qMax(maxTemp, h.temperature);
-        }
-        
-        chart->addSeries(series);
-        
-        // X轴 - 时间
-        QDateTimeAxis *axisX = new QDateTimeAxis();
-        axisX->setFormat("HH:mm");
-        axisX->setTitleText(tr("时间"));
-        chart->addAxis(axisX, Qt::AlignBottom);
-        series->attachAxis(axisX);
-        
-        // Y轴 - 温度
-        QValueAxis *axisY = new QValueAxis();
-        axisY->setRange(minTemp - 2, maxTemp + 2);
-        axisY->setTitleText(tr("温度 (°C)"));
-        chart->addAxis(axisY, Qt::AlignLeft);
-        series->attachAxis(axisY);
-        
+    m_hourlyPlotWidth = qRound(m_hourlyChart->plotArea().width());
+    int targetPoints = m_hourlyPlotWidth > 0 ? m_hourlyPlotWidth : DEFAULT_PLOT_WIDTH;
+    
+    QList<QPointF> visible = Downsampler::visibleRange(m_hourlyPoints,
+                                                       m_hourlyAxisX->min().toMSecsSinceEpoch(),
+                                                       m_hourlyAxisX->max().toMSecsSinceEpoch());
+    int visibleCount = visible.size();
+    bool downsampled = visibleCount > targetPoints;
+    updateAnimation(m_hourlyChart, visibleCount);
+    
+    if (downsampled) {
+        QList<QPointF> upper;
+        QList<QPointF> lower;
+        Downsampler::minMaxEnvelope(visible, targetPoints, upper, lower);
+        m_hourlyUpperSeries->replace(upper);
+        m_hourlyLowerSeries->replace(lower);
+        visible = Downsampler::lttb(visible, targetPoints);
     } else {
-        // 日数据 - 使用区域图显示高低温范围
-        QLineSeries *highSeries = new QLineSeries();
-        QLineSeries *lowSeries = new QLineSeries();
-        highSeries->setName(tr("最高温"));
-        lowSeries->setName(tr("最低温"));
-        
-        qreal minTemp = 100, maxTemp = -100;
-        QStringList categories;
+        m_hourlyUpperSeries->clear();
+        m_hourlyLowerSeries->clear();
+    }
+    
+    m_hourlySeries->replace(visible);
+    setSeriesVisible(m_hourlyChart, m_hourlyEnvelope, downsampled);
+}
+
+void ChartWidget::updateDailyChart()
+{
+    bool hasData = !m_dailyData.isEmpty();
+    bool isTemperature = m_currentChartType == Temperature;
+    setSeriesVisible(m_dailyChart, m_dailyAreaSeries, hasData && isTemperature);
+    setSeriesVisible(m_dailyChart, m_dailyHighSeries, hasData && isTemperature);
+    setSeriesVisible(m_dailyChart, m_dailyLowSeries, hasData && isTemperature);
+    setSeriesVisible(m_dailyChart, m_dailySeries, hasData && !isTemperature);
+    m_dailyAxisX->setVisible(hasData);
+    m_dailyAxisY->setVisible(hasData);
+    
+    if (!hasData) {
+        m_dailySeries->clear();
+        m_dailyHighSeries->clear();
+        m_dailyLowSeries->clear();
+        m_dailyChart->setTitle(tr("暂无数据"));
+        return;
+    }
+    
+    QStringList categories;
+    categories.reserve(m_dailyData.size());
+    for (const DailyForecast &d : std::as_const(m_dailyData)) {
+        categories << d.date.toString("MM/dd");
+    }
+    
+    updateAnimation(m_dailyChart, m_dailyData.size());
+    m_dailyAxisX->setCategories(categories);
+    
+    if (isTemperature) {
+        QList<QPointF> highPoints;
+        QList<QPointF> lowPoints;
+        highPoints.reserve(m_dailyData.size());
+        lowPoints.reserve(m_dailyData.size());
         
+        qreal minTemp = m_dailyData.first().lowTemp;
+        qreal maxTemp = m_dailyData.first().highTemp;
         for (int i = 0; i < m_dailyData.size(); ++i) {
             const DailyForecast &d = m_dailyData[i];
-            highSeries->append(i, d.highTemp);
-            lowSeries->append(i, d.lowTemp);
+            highPoints.append(QPointF(i, d.highTemp));
+            lowPoints.append(QPointF(i, d.lowTemp));
             minTemp = qMin(minTemp, d.lowTemp);
             maxTemp = qMax(maxTemp, d.highTemp);
-            categories << d.date.toString("MM/dd");
         }
         
-        // 创建区域图
-        QAreaSeries *areaSeries = new QAreaSeries(highSeries, lowSeries);
-        areaSeries->setName(tr("温度范围"));
-        areaSeries->setOpacity(0.3);
+        // 区域图跟随上下边界序列更新
+        m_dailyHighSeries->replace(highPoints);
+        m_dailyLowSeries->replace(lowPoints);
         
-        chart->addSeries(areaSeries);
-        chart->addSeries(highSeries);
-        chart->addSeries(lowSeries);
+        m_dailyChart->setTitle(tr("7日温度趋势"));
+        m_dailyAxisY->setRange(minTemp - 3, maxTemp + 3);
+        m_dailyAxisY->setTitleText(tr("温度 (°C)"));
+    } else {
+        QList<QPointF> points;
+        points.reserve(m_dailyData.size());
+        qreal maxValue = 0;
+        for (int i = 0; i < m_dailyData.size(); ++i) {
+            qreal value = dailyValue(m_dailyData[i]);
+            points.append(QPointF(i, value));
+            maxValue = qMax(maxValue, value);
+        }
         
-        // X轴
-        QBarCategoryAxis *axisX = new QBarCategoryAxis();
-        axisX->append(categories);
-        chart->addAxis(axisX, Qt::AlignBottom);
-        areaSeries->attachAxis(axisX);
-        highSeries->attachAxis(axisX);
-        lowSeries->attachAxis(axisX);
+        m_dailySeries->setName(seriesName());
+        m_dailySeries->replace(points);
         
-        // Y轴
-        QValueAxis *axisY = new QValueAxis();
-        axisY->setRange(minTemp - 3, maxTemp + 3);
-        axisY->setTitleText(tr("温度 (°C)"));
-        chart->addAxis(axisY, Qt::AlignLeft);
-        areaSeries->attachAxis(axisY);
-        highSeries->attachAxis(axisY);
-        lowSeries->attachAxis(axisY);
+        switch (m_currentChartType) {
+            case Humidity:
+                m_dailyChart->setTitle(tr("7日湿度变化"));
+                m_dailyAxisY->setRange(0, 100);
+                m_dailyAxisY->setTitleText(tr("湿度 (%)"));
+                break;
+            case WindSpeed:
+                m_dailyChart->setTitle(tr("7日风速变化"));
+                m_dailyAxisY->setRange(0, maxValue + 5);
+                m_dailyAxisY->setTitleText(tr("风速 (km/h)"));
+                break;
+            case Pressure:
+                m_dailyChart->setTitle(tr("7日气压变化"));
+                m_dailyAxisY->setRange(990, 1030);
+                m_dailyAxisY->setTitleText(tr("气压 (hPa)"));
+                break;
+            default:
+                break;
+        }
     }
 }
 
-void ChartWidget::createHumidityChart(QChart *chart, bool isHourly)
+void ChartWidget::resetHistoryRange()
 {
-    chart->setTitle(isHourly ? tr("24小时湿度变化") : tr("7日湿度变化"));
+    QDateTime now = QDateTime::currentDateTime();
     
-    QLineSeries *series = new QLineSeries();
-    series->setName(tr("湿度"));
+    m_historyUpdating = true;
+    m_historyAxisX->setRange(now.addDays(-HISTORY_DEFAULT_DAYS), now);
+    m_historyUpdating = false;
     
-    if (isHourly) {
-        for (const HourlyForecast &h : m_hourlyData) {
-            series->append(h.time.toMSecsSinceEpoch(), h.humidity);
-        }
-        
-        chart->addSeries(series);
-        
-        QDateTimeAxis *axisX = new QDateTimeAxis();
-        axisX->setFormat("HH:mm");
-        chart->addAxis(axisX, Qt::AlignBottom);
-        series->attachAxis(axisX);
-        
-    } else {
-        QStringList categories;
-        for (int i = 0; i < m_dailyData.size(); ++i) {
-            series->append(i, m_dailyData[i].humidity);
-            categories << m_dailyData[i].date.toString("MM/dd");
+    updateHistoryView();
+}
+
+void ChartWidget::updateHistoryView()
+{
+    if (m_currentCityId.isEmpty()) {
+        return;
+    }
+    
+    m_historyPlotWidth = qRound(m_historyChart->plotArea().width());
+    int maxPoints = m_historyPlotWidth > 0 ? m_historyPlotWidth : DEFAULT_PLOT_WIDTH;
+    m_historyLoader->setView(metricName(), m_historyAxisX->min(), m_historyAxisX->max(), maxPoints);
+    showHistoryPoints();
+}
+
+void ChartWidget::showHistoryPoints()
+{
+    // 新分辨率的数据还在读取时保留原来的曲线，避免闪烁
+    QList<RollupPoint> rollups = m_historyLoader->visiblePoints();
+    if (rollups.isEmpty() && !m_historyLoader->isComplete()) {
+        return;
+    }
+    
+    WeatherRollup::Resolution resolution = m_historyLoader->resolution();
+    switch (resolution) {
+        case WeatherRollup::Hour:
+            m_historyAxisX->setFormat("MM-dd HH:mm");
+            break;
+        case WeatherRollup::Day:
+            m_historyAxisX->setFormat("yyyy-MM-dd");
+            break;
+        default:
+            m_historyAxisX->setFormat("yyyy-MM");
+            break;
+    }
+    
+    QList<QPointF> average;
+    QList<QPointF> upper;
+    QList<QPointF> lower;
+    average.reserve(rollups.size());
+    upper.reserve(rollups.size());
+    lower.reserve(rollups.size());
+    
+    qreal minValue = 0, maxValue = 0;
+    for (const RollupPoint &point : std::as_const(rollups)) {
+        qreal x = point.bucketStart.toMSecsSinceEpoch();
+        average.append(QPointF(x, point.average()));
+        upper.append(QPointF(x, point.maxValue));
+        lower.append(QPointF(x, point.minValue));
+        if (average.size() == 1) {
+            minValue = point.minValue;
+            maxValue = point.maxValue;
+        } else {
+            minValue = qMin(minValue, point.minValue);
+            maxValue = qMax(maxValue, point.maxValue);
         }
-        
-        chart->addSeries(series);
-        
-        QBarCategoryAxis *axisX = new QBarCategoryAxis();
-        axisX->append(categories);
-        chart->addAxis(axisX, Qt::AlignBottom);
-        series->attachAxis(axisX);
     }
     
-    QValueAxis *axisY = new QValueAxis();
-    axisY->setRange(0, 100);
-    axisY->setTitleText(tr("湿度 (%)"));
-    chart->addAxis(axisY, Qt::AlignLeft);
-    series->attachAxis(axisY);
+    m_historySeries->setName(tr("%1均值").arg(seriesName()));
+    m_historyEnvelope->setName(tr("%1范围").arg(seriesName()));
+    m_historySeries->replace(average);
+    m_historyUpperSeries->replace(upper);
+    m_historyLowerSeries->replace(lower);
+    
+    if (rollups.isEmpty()) {
+        m_historyChart->setTitle(tr("暂无历史数据"));
+        return;
+    }
+    
+    qreal margin = qMax<qreal>(1, (maxValue - minValue) * 0.1);
+    m_historyAxisY->setRange(minValue - margin, maxValue + margin);
+    m_historyChart->setTitle(tr("%1历史（%2）").arg(seriesName(), WeatherRollup::resolutionName(resolution)));
 }
 
-void ChartWidget::createWindSpeedChart(QChart *chart, bool isHourly)
+void ChartWidget::zoomHistory(const QPointF &viewportPos, double factor)
 {
-    chart->setTitle(isHourly ? tr("24小时风速变化") : tr("7日风速变化"));
+    // 以光标所在时间为中心缩放
+    QPointF chartPos = m_historyChart->mapFromScene(m_historyChartView->mapToScene(viewportPos.toPoint()));
+    qint64 minMs = m_historyAxisX->min().toMSecsSinceEpoch();
+    qint64 maxMs = m_historyAxisX->max().toMSecsSinceEpoch();
+    qint64 anchor = qBound(minMs, qint64(m_historyChart->mapToValue(chartPos, m_historySeries).x()), maxMs);
     
-    QLineSeries *series = new QLineSeries();
-    series->setName(tr("风速"));
+    qint64 newMin = anchor - qint64((anchor - minMs) * factor);
+    qint64 newMax = anchor + qint64((maxMs - anchor) * factor);
+    qint64 spanSecs = (newMax - newMin) / 1000;
+    if (spanSecs < HISTORY_MIN_SPAN_SECS || spanSecs > HISTORY_MAX_SPAN_SECS) {
+        return;
+    }
     
-    qreal maxWind = 0;
+    m_historyAxisX->setRange(QDateTime::fromMSecsSinceEpoch(newMin), QDateTime::fromMSecsSinceEpoch(newMax));
+}
+
+bool ChartWidget::eventFilter(QObject *watched, QEvent *event)
+{
+    if (!m_historyChartView || watched != m_historyChartView->viewport()) {
+        return QWidget::eventFilter(watched, event);
+    }
     
-    if (isHourly) {
-        for (const HourlyForecast &h : m_hourlyData) {
-            series->append(h.time.toMSecsSinceEpoch(), h.windSpeed);
-            maxWind = qMax(maxWind, h.windSpeed);
+    switch (event->type()) {
+        case QEvent::Wheel: {
+            QWheelEvent *wheel = static_cast<QWheelEvent*>(event);
+            if (wheel->angleDelta().y() != 0) {
+                zoomHistory(wheel->position(), wheel->angleDelta().y() > 0 ? 0.8 : 1.25);
+            }
+            return true;
         }
-        
-        chart->addSeries(series);
-        
-        QDateTimeAxis *axisX = new QDateTimeAxis();
-        axisX->setFormat("HH:mm");
-        chart->addAxis(axisX, Qt::AlignBottom);
-        series->attachAxis(axisX);
-        
-    } else {
-        QStringList categories;
-        for (int i = 0; i < m_dailyData.size(); ++i) {
-            series->append(i, m_dailyData[i].windSpeed);
-            maxWind = qMax(maxWind, m_dailyData[i].windSpeed);
-            categories << m_dailyData[i].date.toString("MM/dd");
+        case QEvent::MouseButtonPress: {
+            QMouseEvent *mouse = static_cast<QMouseEvent*>(event);
+            if (mouse->button() == Qt::LeftButton) {
+                m_historyPanning = true;
+                m_historyPanX = mouse->position().x();
+                return true;
+            }
+            break;
         }
-        
-        chart->addSeries(series);
-        
-        QBarCategoryAxis *axisX = new QBarCategoryAxis();
-        axisX->append(categories);
-        chart->addAxis(axisX, Qt::AlignBottom);
-        series->attachAxis(axisX);
+        case QEvent::MouseMove: {
+            QMouseEvent *mouse = static_cast<QMouseEvent*>(event);
+            if (m_historyPanning) {
+                // 向右拖动显示更早的数据
+                qreal dx = mouse->position().x() - m_historyPanX;
+                m_historyPanX = mouse->position().x();
+                m_historyChart->scroll(-dx, 0);
+                return true;
+            }
+            break;
+        }
+        case QEvent::MouseButtonRelease:
+            if (m_historyPanning) {
+                m_historyPanning = false;
+                return true;
+            }
+            break;
+        case QEvent::MouseButtonDblClick:
+            resetHistoryRange();
+            return true;
+        default:
+            break;
     }
-    
-    QValueAxis *axisY = new QValueAxis();
-    axisY->setRange(0, maxWind + 5);
-    axisY->setTitleText(tr("风速 (km/h)"));
-    chart->addAxis(axisY, Qt::AlignLeft);
-    series->attachAxis(axisY);
+    return QWidget::eventFilter(watched, event);
 }
 
-void ChartWidget::createPressureChart(QChart *chart, bool isHourly)
+void ChartWidget::loadComparisonData()
 {
-    chart->setTitle(isHourly ? tr("24小时气压变化") : tr("7日气压变化"));
+    QStringList missing;
+    for (const QString &cityId : std::as_const(m_compareCityIds)) {
+        if (!m_compareData.contains(cityId)) {
+            missing.append(cityId);
+        }
+    }
     
-    QLineSeries *series = new QLineSeries();
-    series->setName(tr("气压"));
+    updateComparisonChart();
+    if (missing.isEmpty()) {
+        return;
+    }
     
-    // 气压数据只在小时预报中有
-    if (isHourly) {
-        for (const HourlyForecast &h : m_hourlyData) {
-            // 假设有气压数据，这里用湿度代替演示
-            series->append(h.time.toMSecsSinceEpoch(), 1013 + (h.humidity - 50) * 0.5);
+    // 缺少的城市在数据库线程的一个任务中读取
+    AsyncDataService::instance().weatherSnapshots(missing)
+        .then(this, [this, missing](const QHash<QString, WeatherSnapshot> &snapshots) {
+            for (const QString &cityId : missing) {
+                const WeatherSnapshot snapshot = snapshots.value(cityId);
+                if (!m_compareData.contains(cityId)) {
+                    m_compareData.insert(cityId, snapshot.hourly);
+                }
+                if (!m_compareNames.contains(cityId) && !snapshot.current.cityName.isEmpty()) {
+                    m_compareNames.insert(cityId, snapshot.current.cityName);
+                }
+            }
+            updateComparisonChart();
+        });
+}
+
+void ChartWidget::updateComparisonChart()
+{
+    // 删除已移出对比的城市
+    for (auto it = m_compareSeries.begin(); it != m_compareSeries.end(); ) {
+        if (m_compareCityIds.contains(it.key())) {
+            ++it;
+            continue;
         }
+        m_compareChart->removeSeries(it.value());
+        delete it.value();
+        it = m_compareSeries.erase(it);
+    }
+    
+    // 城市越多每条序列的点数越少，总点数有上限
+    int width = qRound(m_compareChart->plotArea().width());
+    int seriesPoints = qMax(MIN_SERIES_POINTS, COMPARISON_POINT_BUDGET / qMax(1, int(m_compareCityIds.size())));
+    if (width > 0) {
+        seriesPoints = qMin(seriesPoints, width);
+    }
+    
+    int shown = 0;
+    int pending = 0;
+    qreal minX = 0, maxX = 0, minValue = 0, maxValue = 0;
+    for (int i = 0; i < m_compareCityIds.size(); ++i) {
+        const QString &cityId = m_compareCityIds[i];
+        QLineSeries *series = m_compareSeries.value(cityId);
         
-        chart->addSeries(series);
-        
-        QDateTimeAxis *axisX = new QDateTimeAxis();
-        axisX->setFormat("HH:mm");
-        chart->addAxis(axisX, Qt::AlignBottom);
-        series->attachAxis(axisX);
+        auto data = m_compareData.constFind(cityId);
+        if (data == m_compareData.constEnd() || data->isEmpty()) {
+            if (data == m_compareData.constEnd()) {
+                ++pending;
+            }
+            if (series) {
+                setSeriesVisible(m_compareChart, series, false);
+            }
+            continue;
+        }
         
-    } else {
-        QStringList categories;
-        for (int i = 0; i < m_dailyData.size(); ++i) {
-            series->append(i, 1013 + (m_dailyData[i].humidity - 50) * 0.5);
-            categories << m_dailyData[i].date.toString("MM/dd");
+        QList<QPointF> points;
+        points.reserve(data->size());
+        for (const HourlyForecast &h : *data) {
+            qreal value = hourlyValue(h);
+            qreal x = h.time.toMSecsSinceEpoch();
+            if (shown == 0 && points.isEmpty()) {
+                minX = maxX = x;
+                minValue = maxValue = value;
+            } else {
+                minX = qMin(minX, x);
+                maxX = qMax(maxX, x);
+                minValue = qMin(minValue, value);
+                maxValue = qMax(maxValue, value);
+            }
+            points.append(QPointF(x, value));
         }
         
-        chart->addSeries(series);
+        if (!series) {
+            series = new QLineSeries();
+            m_compareChart->addSeries(series);
+            series->attachAxis(m_compareAxisX);
+            series->attachAxis(m_compareAxisY);
+            m_compareSeries.insert(cityId, series);
+        }
         
-        QBarCategoryAxis *axisX = new QBarCategoryAxis();
-        axisX->append(categories);
-        chart->addAxis(axisX, Qt::AlignBottom);
-        series->attachAxis(axisX);
+        // 按城市在列表中的位置均匀分配色相，城市多时颜色也能区分
+        QPen pen = series->pen();
+        pen.setColor(QColor::fromHsv(i * 360 / m_compareCityIds.size(), 200, 210));
+        pen.setWidthF(1.5);
+        series->setPen(pen);
+        series->setName(comparisonCityName(cityId));
+        series->replace(Downsampler::lttb(points, seriesPoints));
+        setSeriesVisible(m_compareChart, series, true);
+        ++shown;
+    }
+    
+    m_compareAxisX->setVisible(shown > 0);
+    m_compareAxisY->setVisible(shown > 0);
+    
+    int empty = m_compareCityIds.size() - shown - pending;
+    QString status = tr("%1 个城市").arg(m_compareCityIds.size());
+    if (empty > 0) {
+        status += tr("，%1 个暂无数据").arg(empty);
     }
+    ui->compareStatusLabel->setText(pending > 0
+        ? tr("正在读取 %1 个城市的数据...").arg(pending) : status);
     
-    QValueAxis *axisY = new QValueAxis();
-    axisY->setRange(990, 1030);
-    axisY->setTitleText(tr("气压 (hPa)"));
-    chart->addAxis(axisY, Qt::AlignLeft);
-    series->attachAxis(axisY);
+    if (shown == 0) {
+        m_compareChart->setTitle(m_compareCityIds.isEmpty() ? tr("请添加要对比的城市") : tr("暂无数据"));
+        return;
+    }
+    
+    m_compareAxisX->setRange(QDateTime::fromMSecsSinceEpoch(qint64(minX)),
+                             QDateTime::fromMSecsSinceEpoch(qint64(maxX)));
+    setValueAxis(m_compareAxisY, minValue, maxValue);
+    m_compareChart->setTitle(tr("多城市%1对比").arg(seriesName()));
+}
+
+QString ChartWidget::comparisonCityName(const QString &cityId) const
+{
+    QString name = m_compareNames.value(cityId);
+    if (!name.isEmpty()) {
+        return name;
+    }
+    
+    // 只查目录缓存，不在主线程访问数据库
+    CityInfo city;
+    if (CityDirectory::instance().lookup(cityId, city)) {
+        return city.name;
+    }
+    return cityId;
+}
+
+void ChartWidget::updateAnimation(QChart *chart, int pointCount)
+{
+    QChart::AnimationOptions options = pointCount > ANIMATION_POINT_LIMIT
+        ? QChart::NoAnimation : QChart::SeriesAnimations;
+    if (chart->animationOptions() != options) {
+        chart->setAnimationOptions(options);
+    }
+}
+
+void ChartWidget::setSeriesVisible(QChart *chart, QAbstractSeries *series, bool visible)
+{
+    series->setVisible(visible);
+    for (QLegendMarker *marker : chart->legend()->markers(series)) {
+        marker->setVisible(visible);
+    }
+}
+
+void ChartWidget::setValueAxis(QValueAxis *axis, qreal minValue, qreal maxValue) const
+{
+    switch (m_currentChartType) {
+        case Temperature:
+            axis->setRange(minValue - 2, maxValue + 2);
+            axis->setTitleText(tr("温度 (°C)"));
+            break;
+        case Humidity:
+            axis->setRange(0, 100);
+            axis->setTitleText(tr("湿度 (%)"));
+            break;
+        case WindSpeed:
+            axis->setRange(0, qMax<qreal>(maxValue, 0) + 5);
+            axis->setTitleText(tr("风速 (km/h)"));
+            break;
+        case Pressure:
+            axis->setRange(990, 1030);
+            axis->setTitleText(tr("气压 (hPa)"));
+            break;
+    }
+}
+
+qreal ChartWidget::hourlyValue(const HourlyForecast &h) const
+{
+    switch (m_currentChartType) {
+        case Temperature:
+            return h.temperature;
+        case Humidity:
+            return h.humidity;
+        case WindSpeed:
+            return h.windSpeed;
+        case Pressure:
+            // 假设有气压数据，这里用湿度代替演示
+            return 1013 + (h.humidity - 50) * 0.5;
+    }
+    return 0;
+}
+
+qreal ChartWidget::dailyValue(const DailyForecast &d) const
+{
+    switch (m_currentChartType) {
+        case Temperature:
+            return (d.highTemp + d.lowTemp) / 2;
+        case Humidity:
+            return d.humidity;
+        case WindSpeed:
+            return d.windSpeed;
+        case Pressure:
+            return 1013 + (d.humidity - 50) * 0.5;
+    }
+    return 0;
+}
+
+QString ChartWidget::metricName() const
+{
+    switch (m_currentChartType) {
+        case Temperature:
+            return "temperature";
+        case Humidity:
+            return "humidity";
+        case WindSpeed:
+            return "wind_speed";
+        case Pressure:
+            return "pressure";
+    }
+    return QString();
+}
+
+QString ChartWidget::seriesName() const
+{
+    switch (m_currentChartType) {
+        case Temperature:
+            return tr("温度");
+        case Humidity:
+            return tr("湿度");
+        case WindSpeed:
+            return tr("风速");
+        case Pressure:
+            return tr("气压");
+    }
+    return QString();
 }
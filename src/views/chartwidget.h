@@ -20,11 +20,15 @@ namespace Ui {
 class ChartWidget;
 }
 
+class HistoryTileLoader;
+
 /**
  * @class ChartWidget
  * @brief 天气数据可视化图表
  * 
- * 使用Qt Charts展示温度趋势、湿度变化等
+ * 使用Qt Charts展示温度趋势、湿度变化等。
+ * 历史页按可见范围从多分辨率汇总中分块读取，滚轮缩放、拖动平移，双击回到最近一年。
+ * 对比页在共享坐标轴上叠加最多 MAX_COMPARISON_CITIES 个城市的逐小时数据。
  */
 class ChartWidget : public QWidget
 {
@@ -37,7 +41,7 @@ public:
         WindSpeed,
         Pressure
     };
-
+    
     explicit ChartWidget(QWidget *parent = nullptr);
     ~ChartWidget();
     
@@ -45,13 +49,24 @@ public:
     void updateHourlyData(const QList<HourlyForecast> &forecast);
     void updateDailyData(const QList<DailyForecast> &forecast);
     void clear();
+    
+    /**
+     * @brief 设置对比的城市，超出上限的部分忽略
+     */
+    void setComparisonCities(const QStringList &cityIds);
 
 signals:
     void refreshRequested(const QString &cityId);
 
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private slots:
     void onRefreshClicked();
     void onChartTypeChanged(int index);
+    void onCompareAddClicked();
+    void onCompareFavoritesClicked();
+    void onCompareClearClicked();
 
 private:
     void setupConnections();
@@ -59,11 +74,58 @@ private:
     void updateHourlyChart();
     void updateDailyChart();
     
-    // 图表创建方法
-    void createTemperatureChart(QChart *chart, bool isHourly);
-    void createHumidityChart(QChart *chart, bool isHourly);
-    void createWindSpeedChart(QChart *chart, bool isHourly);
-    void createPressureChart(QChart *chart, bool isHourly);
+    /**
+     * @brief 把小时数据中当前可见的范围降采样到绘图区宽度后显示
+     * 
+     * 数据、绘图区宽度或可见范围（缩放）变化时重新执行
+     */
+    void resampleHourlySeries();
+    
+    // 历史图表
+    void setupHistoryChart();
+    
+    /**
+     * @brief 回到默认的时间范围（最近一年）
+     */
+    void resetHistoryRange();
+    
+    /**
+     * @brief 按当前可见范围和绘图区宽度请求数据并刷新显示
+     */
+    void updateHistoryView();
+    void showHistoryPoints();
+    void zoomHistory(const QPointF &viewportPos, double factor);
+    
+    // 对比图表
+    void setupComparisonChart();
+    
+    /**
+     * @brief 一次批量读取尚未缓存的城市快照，完成后刷新对比图表
+     */
+    void loadComparisonData();
+    void updateComparisonChart();
+    QString comparisonCityName(const QString &cityId) const;
+    
+    /**
+     * @brief 按数据点数决定是否开启动画，点数多时逐点动画会明显卡顿
+     */
+    void updateAnimation(QChart *chart, int pointCount);
+    
+    /**
+     * @brief 显示或隐藏序列及其图例
+     */
+    void setSeriesVisible(QChart *chart, QAbstractSeries *series, bool visible);
+    
+    /**
+     * @brief 按当前图表类型设置纵轴范围和标题
+     */
+    void setValueAxis(QValueAxis *axis, qreal minValue, qreal maxValue) const;
+    
+    // 当前图表类型下每个数据点的取值
+    qreal hourlyValue(const HourlyForecast &h) const;
+    qreal dailyValue(const DailyForecast &d) const;
+    QString seriesName() const;
+    QString metricName() const;
 
 private:
     Ui::ChartWidget *ui;
@@ -75,10 +137,60 @@ private:
     QChart *m_hourlyChart;
     QChart *m_dailyChart;
     
+    // 序列和坐标轴只创建一次，数据更新时用 replace 整体替换点
+    QLineSeries *m_hourlySeries;
+    QLineSeries *m_hourlyUpperSeries;   // 降采样时每个像素桶的最大值
+    QLineSeries *m_hourlyLowerSeries;   // 降采样时每个像素桶的最小值
+    QAreaSeries *m_hourlyEnvelope;
+    QDateTimeAxis *m_hourlyAxisX;
+    QValueAxis *m_hourlyAxisY;
+    QList<QPointF> m_hourlyPoints;      // 当前图表类型的全部数据点
+    int m_hourlyPlotWidth;
+    bool m_hourlyUpdating;
+    
+    QLineSeries *m_dailySeries;         // 湿度、风速、气压
+    QLineSeries *m_dailyHighSeries;     // 温度：最高温
+    QLineSeries *m_dailyLowSeries;      // 温度：最低温
+    QAreaSeries *m_dailyAreaSeries;     // 温度：高低温范围
+    QBarCategoryAxis *m_dailyAxisX;
+    QValueAxis *m_dailyAxisY;
+    
+    QChartView *m_historyChartView;
+    QChart *m_historyChart;
+    QLineSeries *m_historySeries;       // 时间桶均值
+    QLineSeries *m_historyUpperSeries;  // 时间桶最大值
+    QLineSeries *m_historyLowerSeries;  // 时间桶最小值
+    QAreaSeries *m_historyEnvelope;
+    QDateTimeAxis *m_historyAxisX;
+    QValueAxis *m_historyAxisY;
+    HistoryTileLoader *m_historyLoader;
+    int m_historyPlotWidth;
+    bool m_historyUpdating;
+    bool m_historyPanning;
+    qreal m_historyPanX;
+    
+    QChartView *m_compareChartView;
+    QChart *m_compareChart;
+    QDateTimeAxis *m_compareAxisX;
+    QValueAxis *m_compareAxisY;
+    QHash<QString, QLineSeries*> m_compareSeries;           // cityId → 序列，城市移出对比时删除
+    QStringList m_compareCityIds;
+    QHash<QString, QList<HourlyForecast>> m_compareData;    // 已读取的逐小时数据，没有数据为空列表
+    QHash<QString, QString> m_compareNames;
+    
     QList<HourlyForecast> m_hourlyData;
     QList<DailyForecast> m_dailyData;
     
     ChartType m_currentChartType;
+    
+    static const int ANIMATION_POINT_LIMIT = 100;
+    static const int DEFAULT_PLOT_WIDTH = 800;  // 图表尚未布局时的目标点数
+    static const int HISTORY_DEFAULT_DAYS = 365;
+    static const int MAX_COMPARISON_CITIES = 50;
+    static const int COMPARISON_POINT_BUDGET = 4000;    // 对比图表所有序列的总点数上限
+    static const int MIN_SERIES_POINTS = 16;
+    static const qint64 HISTORY_MIN_SPAN_SECS = 6 * 3600;
+    static const qint64 HISTORY_MAX_SPAN_SECS = 30LL * 365 * 86400;
 };
 
 #endif // CHARTWIDGET_H
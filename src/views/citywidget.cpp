@@ -5,10 +5,14 @@
 
 #include "citywidget.h"
 #include "ui_citywidget.h"
-#include "../services/cityservice.h"
+#include "../services/asyncdataservice.h"
+#include "../workers/cityprefetcher.h"
+#include "../workers/cityimporter.h"
 #include <QMessageBox>
 #include <QInputDialog>
+#include <QFileDialog>
 #include <QDateTime>
+#include <QEvent>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QJsonDocument>
@@ -19,16 +23,21 @@
 CityWidget::CityWidget(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::CityWidget)
+    , m_pageModel(new CityPageModel(this))
     , m_cityModel(new CityModel(this))
     , m_filterModel(new CityFilterModel(this))
 {
     ui->setupUi(this);
     
-    // 设置模型
+    // 设置模型：平时显示分页模型，输入关键词后切换到搜索结果
     m_filterModel->setSourceModel(m_cityModel);
-    ui->cityListView->setModel(m_filterModel);
+    ui->cityListView->setUniformItemSizes(true);
+    ui->cityListView->setModel(m_pageModel);
     ui->cityListView->setModelColumn(CityModel::ColName);
     
+    // 搜索结果按匹配分数排序
+    m_filterModel->sort(CityModel::ColName);
+    
     setupConnections();
     loadCities();
 }
@@ -43,9 +52,31 @@ void CityWidget::setupConnections()
     connect(ui->searchEdit, &QLineEdit::textChanged,
             this, &CityWidget::onSearchTextChanged);
     
+    connect(m_pageModel, &CityPageModel::totalCountChanged, this, [this](int count) {
+        // 首次运行时写入默认城市后重新加载
+        if (count == 0 && !m_defaultCitiesAdded) {
+            m_defaultCitiesAdded = true;
+            addDefaultCities();
+            loadCities(m_pendingStatus);
+            return;
+        }
+        
+        if (ui->searchEdit->text().trimmed().isEmpty()) {
+            ui->statusLabel->setText(m_pendingStatus.isEmpty() ? tr("共 %1 个城市").arg(count)
+                                                               : m_pendingStatus);
+        }
+        m_pendingStatus.clear();
+    });
+    
     connect(ui->cityListView, &QListView::clicked,
             this, &CityWidget::onCityClicked);
     
+    // 鼠标悬停时预取天气数据，双击切换时可直接命中缓存
+    ui->cityListView->setMouseTracking(true);
+    connect(ui->cityListView, &QListView::entered,
+            this, &CityWidget::onCityHovered);
+    ui->cityListView->viewport()->installEventFilter(this);
+    
     connect(ui->cityListView, &QListView::doubleClicked,
             this, &CityWidget::onCityDoubleClicked);
     
@@ -60,19 +91,28 @@ void CityWidget::setupConnections()
     
     connect(ui->refreshBtn, &QPushButton::clicked,
             this, &CityWidget::onRefreshClicked);
+    
+    connect(ui->importBtn, &QPushButton::clicked,
+            this, &CityWidget::onImportClicked);
+    
+    connect(&CityImporter::instance(), &CityImporter::progressChanged,
+            this, &CityWidget::onImportProgress);
+    
+    connect(&CityImporter::instance(), &CityImporter::finished,
+            this, &CityWidget::onImportFinished);
 }
 
-void CityWidget::loadCities()
+void CityWidget::loadCities(const QString &statusMessage)
 {
-    QList<CityInfo> cities = CityService::instance().getAllCities();
+    m_pendingStatus = statusMessage;
+    m_pageModel->reload();
     
-    if (cities.isEmpty()) {
-        addDefaultCities();
-        cities = CityService::instance().getAllCities();
+    // 搜索中时按当前关键词重新读取候选
+    QString keyword = ui->searchEdit->text().trimmed();
+    if (!keyword.isEmpty()) {
+        m_searchQuery.clear();
+        searchCandidates(keyword);
     }
-    
-    m_cityModel->setCities(cities);
-    ui->statusLabel->setText(tr("共 %1 个城市").arg(cities.count()));
 }
 
 void CityWidget::addDefaultCities()
@@ -93,42 +133,122 @@ void CityWidget::addDefaultCities()
         {0, "101110101", "西安", "陕西", "CN", 34.3416, 108.9398, false, 0},
     };
     
-    for (const CityInfo &city : defaultCities) {
-        CityService::instance().addCity(city);
-    }
+    // 与随后的读取在同一数据库线程按顺序执行
+    AsyncDataService::instance().addCities(defaultCities);
 }
 
 void CityWidget::onSearchTextChanged(const QString &text)
 {
-    m_filterModel->setSearchKeyword(text);
+    QString keyword = text.trimmed();
+    m_filterModel->setSearchKeyword(keyword);
     
-    int visibleCount = m_filterModel->rowCount();
-    int totalCount = m_cityModel->rowCount();
+    if (keyword.isEmpty()) {
+        if (ui->cityListView->model() != m_pageModel) {
+            ui->cityListView->setModel(m_pageModel);
+            ui->cityListView->setModelColumn(CityModel::ColName);
+        }
+        m_searchQuery.clear();
+        ++m_searchRequest;
+        ui->statusLabel->setText(tr("共 %1 个城市").arg(qMax(0, m_pageModel->totalCount())));
+        return;
+    }
     
-    if (text.isEmpty()) {
-        ui->statusLabel->setText(tr("共 %1 个城市").arg(totalCount));
-    } else {
-        ui->statusLabel->setText(tr("找到 %1 个城市（共 %2 个）").arg(visibleCount).arg(totalCount));
+    if (ui->cityListView->model() != m_filterModel) {
+        ui->cityListView->setModel(m_filterModel);
+        ui->cityListView->setModelColumn(CityModel::ColName);
     }
+    searchCandidates(keyword);
+    updateSearchStatus();
+}
+
+void CityWidget::searchCandidates(const QString &keyword)
+{
+    // 按关键词前缀从数据库取候选，继续输入时只在候选中模糊打分，
+    // 拼错的后续字母仍能通过编辑距离命中；候选达到上限时说明不完整，
+    // 关键词变长后改用完整关键词重新查询
+    QString folded = keyword.toCaseFolded();
+    QString searchQuery = folded.left(SEARCH_PREFIX_LENGTH);
+    if (!m_searchQuery.isEmpty() && folded.startsWith(m_searchQuery)) {
+        if (!m_searchTruncated || folded == m_searchQuery) {
+            return;
+        }
+        searchQuery = folded;
+    }
+    m_searchQuery = searchQuery;
+    m_searchTruncated = false;
+    
+    int request = ++m_searchRequest;
+    AsyncDataService::instance().searchCities(searchQuery, SEARCH_CANDIDATE_LIMIT)
+        .then(this, [this, request](const QList<CityInfo> &cities) {
+        if (request != m_searchRequest) {
+            return;
+        }
+        m_searchTruncated = cities.size() >= SEARCH_CANDIDATE_LIMIT;
+        m_cityModel->setCities(cities);
+        
+        // 等待结果期间关键词可能已经变长，候选不完整时立即补查
+        QString keyword = ui->searchEdit->text().trimmed();
+        m_filterModel->setSearchKeyword(keyword);
+        if (m_searchTruncated && !keyword.isEmpty()) {
+            searchCandidates(keyword);
+        }
+        updateSearchStatus();
+    });
+}
+
+void CityWidget::updateSearchStatus()
+{
+    ui->statusLabel->setText(tr("找到 %1 个城市（共 %2 个）")
+                             .arg(m_filterModel->rowCount())
+                             .arg(qMax(0, m_pageModel->totalCount())));
+}
+
+CityInfo CityWidget::cityAt(const QModelIndex &index) const
+{
+    if (index.model() == m_filterModel) {
+        return m_cityModel->cityAt(m_filterModel->mapToSource(index).row());
+    }
+    return m_pageModel->cityAt(index.row());
 }
 
 void CityWidget::onCityClicked(const QModelIndex &index)
 {
     if (!index.isValid()) return;
     
-    QModelIndex sourceIndex = m_filterModel->mapToSource(index);
-    CityInfo city = m_cityModel->cityAt(sourceIndex.row());
+    CityInfo city = cityAt(index);
+    if (city.cityId.isEmpty()) return;
     
     QString favText = city.isFavorite ? tr("⭐") : "";
     ui->statusLabel->setText(tr("已选择: %1 %2 (%3)").arg(favText).arg(city.name).arg(city.province));
+    
+    CityPrefetcher::instance().prefetchCity(city.cityId);
+}
+
+void CityWidget::onCityHovered(const QModelIndex &index)
+{
+    if (!index.isValid()) return;
+    
+    CityInfo city = cityAt(index);
+    if (city.cityId.isEmpty()) return;
+    
+    CityPrefetcher::instance().hoverCity(city.cityId);
+}
+
+bool CityWidget::eventFilter(QObject *watched, QEvent *event)
+{
+    // 鼠标离开列表时取消尚未触发的悬停预取
+    if (watched == ui->cityListView->viewport() && event->type() == QEvent::Leave) {
+        CityPrefetcher::instance().hoverCity(QString());
+    }
+    return QWidget::eventFilter(watched, event);
 }
 
 void CityWidget::onCityDoubleClicked(const QModelIndex &index)
 {
     if (!index.isValid()) return;
     
-    QModelIndex sourceIndex = m_filterModel->mapToSource(index);
-    CityInfo city = m_cityModel->cityAt(sourceIndex.row());
+    CityInfo city = cityAt(index);
+    if (city.cityId.isEmpty()) return;
     
     emit citySelected(city.cityId);
 }
@@ -177,21 +297,25 @@ void CityWidget::onAddCityClicked()
             city.isFavorite = false;
             
             // 检查城市是否已存在
-            if (CityService::instance().cityExists(city.cityId)) {
-                QMessageBox::information(this, tr("提示"), tr("城市 %1 已存在").arg(city.name));
-                return;
-            }
-            
-            if (CityService::instance().addCity(city)) {
-                loadCities();
-                QMessageBox::information(this, tr("成功"), 
-                    tr("城市 %1 已添加\n经度: %2, 纬度: %3")
-                    .arg(city.name)
-                    .arg(city.longitude, 0, 'f', 4)
-                    .arg(city.latitude, 0, 'f', 4));
-            } else {
-                QMessageBox::warning(this, tr("错误"), tr("添加城市失败"));
-            }
+            AsyncDataService::instance().cityExists(city.cityId).then(this, [this, city](bool exists) {
+                if (exists) {
+                    QMessageBox::information(this, tr("提示"), tr("城市 %1 已存在").arg(city.name));
+                    return;
+                }
+                
+                AsyncDataService::instance().addCity(city).then(this, [this, city](bool added) {
+                    // 列表由 cityAdded 信号逐行更新
+                    if (added) {
+                        QMessageBox::information(this, tr("成功"), 
+                            tr("城市 %1 已添加\n经度: %2, 纬度: %3")
+                            .arg(city.name)
+                            .arg(city.longitude, 0, 'f', 4)
+                            .arg(city.latitude, 0, 'f', 4));
+                    } else {
+                        QMessageBox::warning(this, tr("错误"), tr("添加城市失败"));
+                    }
+                });
+            });
         });
     }
 }
@@ -204,18 +328,19 @@ void CityWidget::onRemoveCityClicked()
         return;
     }
     
-    QModelIndex sourceIndex = m_filterModel->mapToSource(index);
-    CityInfo city = m_cityModel->cityAt(sourceIndex.row());
+    CityInfo city = cityAt(index);
+    if (city.cityId.isEmpty()) return;
     
     int ret = QMessageBox::question(this, tr("确认移除"),
                                      tr("确定要移除城市 %1 吗？").arg(city.name),
                                      QMessageBox::Yes | QMessageBox::No);
     
     if (ret == QMessageBox::Yes) {
-        if (CityService::instance().deleteCity(city.cityId)) {
-            loadCities();
-            ui->statusLabel->setText(tr("城市 %1 已移除").arg(city.name));
-        }
+        AsyncDataService::instance().deleteCity(city.cityId).then(this, [this, city](bool removed) {
+            if (removed) {
+                ui->statusLabel->setText(tr("城市 %1 已移除").arg(city.name));
+            }
+        });
     }
 }
 
@@ -227,20 +352,72 @@ void CityWidget::onFavoriteClicked()
         return;
     }
     
-    QModelIndex sourceIndex = m_filterModel->mapToSource(index);
-    CityInfo city = m_cityModel->cityAt(sourceIndex.row());
+    CityInfo city = cityAt(index);
+    if (city.cityId.isEmpty()) return;
     
     bool newFavorite = !city.isFavorite;
-    if (CityService::instance().setFavorite(city.cityId, newFavorite)) {
-        loadCities();
-        QString msg = newFavorite ? tr("已收藏 %1").arg(city.name) : tr("已取消收藏 %1").arg(city.name);
-        ui->statusLabel->setText(msg);
-    }
+    AsyncDataService::instance().setFavorite(city.cityId, newFavorite).then(this, [this, city, newFavorite](bool changed) {
+        if (changed) {
+            QString msg = newFavorite ? tr("已收藏 %1").arg(city.name) : tr("已取消收藏 %1").arg(city.name);
+            ui->statusLabel->setText(msg);
+        }
+    });
 }
 
 void CityWidget::onRefreshClicked()
 {
-    loadCities();
     ui->searchEdit->clear();
-    ui->statusLabel->setText(tr("列表已刷新"));
+    loadCities(tr("列表已刷新"));
+}
+
+void CityWidget::onImportClicked()
+{
+    if (CityImporter::instance().isRunning()) {
+        int ret = QMessageBox::question(this, tr("导入中"), tr("正在导入城市数据，是否取消？"),
+                                        QMessageBox::Yes | QMessageBox::No);
+        if (ret == QMessageBox::Yes) {
+            CityImporter::instance().cancel();
+        }
+        return;
+    }
+    
+    QString filePath = QFileDialog::getOpenFileName(this, tr("导入城市数据"), QString(),
+                                                    tr("城市数据 (*.txt *.tsv *.csv);;所有文件 (*)"));
+    if (filePath.isEmpty()) {
+        return;
+    }
+    
+    if (CityImporter::instance().start(filePath)) {
+        ui->importBtn->setText(tr("⏹ 取消导入"));
+        ui->statusLabel->setText(tr("正在导入..."));
+    }
+}
+
+void CityWidget::onImportProgress(const CityImportProgress &progress)
+{
+    ui->statusLabel->setText(tr("正在导入 %1% | 已导入 %2 个城市 | %3 行/秒")
+                             .arg(progress.percent())
+                             .arg(progress.rows)
+                             .arg(int(progress.rowsPerSecond)));
+}
+
+void CityWidget::onImportFinished(const CityImportResult &result)
+{
+    ui->importBtn->setText(tr("📥 导入"));
+    
+    if (!result.success) {
+        QMessageBox::warning(this, tr("导入失败"), result.error);
+        return;
+    }
+    
+    // 整个导入完成后只刷新一次列表
+    QString summary = tr("导入 %1 个城市，跳过 %2 行，用时 %3 秒（%4 行/秒）")
+                      .arg(result.rows)
+                      .arg(result.skipped)
+                      .arg(result.elapsedMs / 1000.0, 0, 'f', 1)
+                      .arg(int(result.rowsPerSecond));
+    if (result.cancelled) {
+        summary = tr("导入已取消，") + summary;
+    }
+    loadCities(summary);
 }
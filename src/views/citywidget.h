@@ -8,7 +8,9 @@
 
 #include <QWidget>
 #include "../models/citymodel.h"
+#include "../models/citypagemodel.h"
 #include "../models/cityfiltermodel.h"
+#include "../workers/cityimporter.h"
 
 namespace Ui {
 class CityWidget;
@@ -29,24 +31,56 @@ public:
 signals:
     void citySelected(const QString &cityId);
 
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private slots:
     void onSearchTextChanged(const QString &text);
     void onCityClicked(const QModelIndex &index);
+    void onCityHovered(const QModelIndex &index);
     void onCityDoubleClicked(const QModelIndex &index);
     void onAddCityClicked();
     void onRemoveCityClicked();
     void onFavoriteClicked();
     void onRefreshClicked();
+    void onImportClicked();
+    void onImportProgress(const CityImportProgress &progress);
+    void onImportFinished(const CityImportResult &result);
 
 private:
     void setupConnections();
-    void loadCities();
+    
+    /**
+     * @brief 重新分页加载城市列表，有搜索关键词时同时刷新搜索结果
+     * @param statusMessage 加载完成后显示的状态，为空时显示城市数量
+     */
+    void loadCities(const QString &statusMessage = QString());
     void addDefaultCities();
+    
+    /**
+     * @brief 从数据库读取搜索候选，关键词前缀不变且候选完整时复用已读取的候选
+     */
+    void searchCandidates(const QString &keyword);
+    void updateSearchStatus();
+    
+    /**
+     * @brief 视图索引对应的城市，分页模型中数据不在内存时返回空的 CityInfo
+     */
+    CityInfo cityAt(const QModelIndex &index) const;
 
 private:
     Ui::CityWidget *ui;
-    CityModel *m_cityModel;
-    CityFilterModel *m_filterModel;
+    CityPageModel *m_pageModel;         // 浏览：分页加载全部城市
+    CityModel *m_cityModel;             // 搜索：数据库返回的候选城市
+    CityFilterModel *m_filterModel;     // 搜索：对候选模糊打分排序
+    QString m_pendingStatus;
+    QString m_searchQuery;              // 当前候选对应的查询关键词
+    bool m_searchTruncated = false;     // 当前候选达到数量上限，可能不完整
+    int m_searchRequest = 0;
+    bool m_defaultCitiesAdded = false;
+    
+    static const int SEARCH_PREFIX_LENGTH = 2;
+    static const int SEARCH_CANDIDATE_LIMIT = 2000;
 };
 
 #endif // CITYWIDGET_H
@@ -6,10 +6,12 @@
 #include "historywidget.h"
 #include "ui_historywidget.h"
 #include "../utils/dataexporter.h"
+#include "../services/asyncdataservice.h"
 #include <QDate>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QRandomGenerator>
+#include <QMap>
 
 HistoryWidget::HistoryWidget(QWidget *parent)
     : QWidget(parent)
@@ -40,8 +42,7 @@ void HistoryWidget::setCity(const QString &cityId, const QString &cityName)
     m_cityName = cityName;
     ui->cityLabel->setText(QString("当前城市：%1").arg(cityName));
     
-    // 加载模拟数据
-    loadMockData();
+    loadHistory();
 }
 
 void HistoryWidget::addHistoryRecord(const CurrentWeather &weather)
@@ -116,10 +117,90 @@ void HistoryWidget::loadMockData()
     updateRecordCount();
 }
 
+void HistoryWidget::loadHistory()
+{
+    QDateTime from(ui->startDateEdit->date(), QTime(0, 0));
+    QDateTime to(ui->endDateEdit->date().addDays(1), QTime(0, 0));
+    
+    // 按时间跨度自动选择汇总分辨率，长时间范围只读取少量汇总行
+    WeatherRollup::Resolution resolution = WeatherRollup::chooseResolution(from, to);
+    
+    // 在数据库线程读取，只显示最后一次查询的结果
+    int request = ++m_historyRequest;
+    AsyncDataService::instance().rollups(m_cityId, WeatherRollup::metrics(), from, to, resolution)
+        .then(this, [this, request, resolution](const QHash<QString, QList<RollupPoint>> &rollups) {
+            if (request == m_historyRequest) {
+                showHistory(resolution, rollups);
+            }
+        });
+}
+
+void HistoryWidget::showHistory(WeatherRollup::Resolution resolution,
+                                const QHash<QString, QList<RollupPoint>> &rollups)
+{
+    QMap<QDateTime, CurrentWeather> buckets;
+    QMap<QDateTime, RollupPoint> temperatures;
+    for (auto rollup = rollups.constBegin(); rollup != rollups.constEnd(); ++rollup) {
+        const QString &metric = rollup.key();
+        for (const RollupPoint &point : rollup.value()) {
+            CurrentWeather &weather = buckets[point.bucketStart];
+            weather.cityId = m_cityId;
+            weather.cityName = m_cityName;
+            weather.updateTime = point.bucketStart;
+            if (metric == "temperature") {
+                weather.temperature = point.average();
+                temperatures.insert(point.bucketStart, point);
+            } else if (metric == "humidity") {
+                weather.humidity = qRound(point.average());
+            } else if (metric == "pressure") {
+                weather.pressure = qRound(point.average());
+            } else if (metric == "wind_speed") {
+                weather.windSpeed = point.average();
+            }
+        }
+    }
+    
+    // 还没有保存过观测数据时使用模拟数据
+    if (buckets.isEmpty()) {
+        loadMockData();
+        return;
+    }
+    
+    ui->historyTable->setRowCount(0);
+    m_historyData.clear();
+    
+    QString type = QString("%1均值").arg(WeatherRollup::resolutionName(resolution));
+    QString timeFormat = resolution == WeatherRollup::Hour ? "yyyy-MM-dd HH:mm" : "yyyy-MM-dd";
+    
+    // 最新的在前
+    for (auto it = buckets.constEnd(); it != buckets.constBegin(); ) {
+        --it;
+        const CurrentWeather &weather = it.value();
+        m_historyData.append(weather);
+        
+        QString tempText = QString("%1°C").arg(weather.temperature, 0, 'f', 1);
+        if (temperatures.contains(it.key())) {
+            const RollupPoint &t = temperatures[it.key()];
+            tempText += QString(" (%1~%2)").arg(t.minValue, 0, 'f', 1).arg(t.maxValue, 0, 'f', 1);
+        }
+        
+        int row = ui->historyTable->rowCount();
+        ui->historyTable->insertRow(row);
+        ui->historyTable->setItem(row, 0, new QTableWidgetItem(weather.updateTime.toString(timeFormat)));
+        ui->historyTable->setItem(row, 1, new QTableWidgetItem(type));
+        ui->historyTable->setItem(row, 2, new QTableWidgetItem(tempText));
+        ui->historyTable->setItem(row, 3, new QTableWidgetItem("--"));
+        ui->historyTable->setItem(row, 4, new QTableWidgetItem(QString("%1%").arg(weather.humidity)));
+        ui->historyTable->setItem(row, 5, new QTableWidgetItem(QString("%1 km/h").arg(weather.windSpeed, 0, 'f', 1)));
+        ui->historyTable->setItem(row, 6, new QTableWidgetItem(QString("%1 hPa").arg(weather.pressure)));
+    }
+    
+    updateRecordCount();
+}
+
 void HistoryWidget::onQueryClicked()
 {
-    // 重新加载数据（模拟查询）
-    loadMockData();
+    loadHistory();
     QMessageBox::information(this, "查询完成", 
         QString("已查询 %1 到 %2 的历史数据")
             .arg(ui->startDateEdit->date().toString("yyyy-MM-dd"))
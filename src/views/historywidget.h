@@ -8,7 +8,9 @@
 
 #include <QWidget>
 #include <QList>
+#include <QHash>
 #include "../models/weatherdata.h"
+#include "../services/weatherrollup.h"
 
 namespace Ui {
 class HistoryWidget;
@@ -49,6 +51,9 @@ private slots:
 
 private:
     void initTable();
+    void loadHistory();
+    void showHistory(WeatherRollup::Resolution resolution,
+                     const QHash<QString, QList<RollupPoint>> &rollups);
     void loadMockData();
     void updateRecordCount();
 
@@ -57,6 +62,7 @@ private:
     QString m_cityId;
     QString m_cityName;
     QList<CurrentWeather> m_historyData;
+    int m_historyRequest = 0;  // 最近一次查询的序号，丢弃过期的结果
 };
 
 #endif // HISTORYWIDGET_H
@@ -0,0 +1,561 @@
+/**
+ * @file benchmarkrunner.cpp
+ * @brief 命令行性能基准测试实现
+ */
+
+#include "benchmarkrunner.h"
+#include "../database/databasemanager.h"
+#include "../services/cityservice.h"
+#include "../utils/pinyinutil.h"
+#include "../models/cityfiltermodel.h"
+#include "../views/chartwidget.h"
+#include "reportrenderer.h"
+#include "cityimporter.h"
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QRandomGenerator>
+#include <QElapsedTimer>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QApplication>
+#include <QThread>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <functional>
+
+namespace {
+// 合成城市名使用的常见地名用字，拼音均在 PinyinUtil 的字表中
+const QString NAME_CHARACTERS = QStringLiteral(
+    "北京上海广州深圳天津重庆杭南武汉成都长沙西安宁波苏无锡合肥福厦门济青岛郑大连沈阳"
+    "哈尔滨石家庄太原呼和浩特昆明贵阳兰银川乌鲁木齐拉萨口昌徐州温台金华绍兴嘉湖洛开封");
+}
+
+BenchmarkRunner::BenchmarkRunner(int cityCount)
+    : m_cityCount(cityCount)
+{
+}
+
+bool BenchmarkRunner::isRequested(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--bench") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int BenchmarkRunner::run(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QObject::tr("数据库、搜索和图表性能基准测试"));
+    parser.addHelpOption();
+    parser.addOption({"bench", QObject::tr("不显示界面，运行基准测试后退出")});
+    parser.addOption({"cities", QObject::tr("合成的城市数量"), "count", "150000"});
+    parser.process(arguments);
+    
+    QTextStream out(stdout);
+    int cityCount = parser.value("cities").toInt();
+    if (cityCount <= 0) {
+        out << "Invalid city count: " << parser.value("cities") << Qt::endl;
+        return 1;
+    }
+    
+    // 基准数据写入临时目录，不接触用户数据库
+    QTemporaryDir workDir;
+    if (!workDir.isValid()) {
+        out << "Failed to create a temporary directory" << Qt::endl;
+        return 1;
+    }
+    
+    BenchmarkRunner runner(cityCount);
+    return runner.runAll(workDir.path(), out) ? 0 : 1;
+}
+
+bool BenchmarkRunner::runAll(const QString &workDir, QTextStream &out)
+{
+    if (!DatabaseManager::instance().initialize(workDir + "/bench.db")) {
+        out << "Failed to open database" << Qt::endl;
+        return false;
+    }
+    
+    m_cities = makeCities(m_cityCount);
+    
+    if (!benchStorageProfile(workDir, out) || !writeCities(out)) {
+        return false;
+    }
+    benchCityLookup(out);
+    benchCitySearch(out);
+    benchSpatialQueries(out);
+    benchCityModel(out);
+    benchFuzzySearch(out);
+    benchChartRedraw(out);
+    benchReportRendering(workDir, out);
+    
+    // 导入会让城市表翻倍，放在查询类测试之后
+    if (!benchCityImport(workDir, out)) {
+        return false;
+    }
+    
+    DatabaseManager::instance().close();
+    return true;
+}
+
+BenchmarkRunner::Latency BenchmarkRunner::latency(QList<qint64> nanoseconds)
+{
+    Latency result;
+    if (nanoseconds.isEmpty()) {
+        return result;
+    }
+    
+    std::sort(nanoseconds.begin(), nanoseconds.end());
+    qint64 total = 0;
+    for (qint64 ns : std::as_const(nanoseconds)) {
+        total += ns;
+    }
+    result.averageMs = total / 1e6 / nanoseconds.size();
+    result.p95Ms = nanoseconds.at(qMin(nanoseconds.size() - 1, nanoseconds.size() * 95 / 100)) / 1e6;
+    return result;
+}
+
+QString BenchmarkRunner::formatLatency(const Latency &latency)
+{
+    return QString("avg %1 ms, p95 %2 ms").arg(latency.averageMs, 0, 'f', 3).arg(latency.p95Ms, 0, 'f', 3);
+}
+
+QList<CityInfo> BenchmarkRunner::makeCities(int count) const
+{
+    QRandomGenerator random(RANDOM_SEED);
+    QList<CityInfo> cities;
+    cities.reserve(count);
+    
+    for (int i = 0; i < count; ++i) {
+        CityInfo city;
+        city.cityId = QString("B%1").arg(i, 7, 10, QChar('0'));
+        
+        int length = 2 + random.bounded(2);
+        for (int c = 0; c < length; ++c) {
+            city.name.append(NAME_CHARACTERS.at(random.bounded(int(NAME_CHARACTERS.size()))));
+        }
+        city.province = NAME_CHARACTERS.mid(random.bounded(int(NAME_CHARACTERS.size()) - 1), 2);
+        city.latitude = random.bounded(130.0) - 60.0;
+        city.longitude = random.bounded(360.0) - 180.0;
+        cities.append(city);
+    }
+    return cities;
+}
+
+bool BenchmarkRunner::benchStorageProfile(const QString &workDir, QTextStream &out)
+{
+    // 同样的写入和查询分别在默认参数和当前性能配置下各跑一次
+    const DatabaseProfile profile = DatabaseManager::instance().performanceProfile();
+    const QList<bool> tunedRuns = {false, true};
+    
+    for (bool tuned : tunedRuns) {
+        const QString name = tuned ? "bench_tuned" : "bench_baseline";
+        {
+            QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", name);
+            db.setDatabaseName(QString("%1/%2.db").arg(workDir, name));
+            if (!db.open()) {
+                out << "Failed to open " << name << ": " << db.lastError().text() << Qt::endl;
+                return false;
+            }
+            
+            QSqlQuery query(db);
+            if (tuned) {
+                query.exec(QString("PRAGMA journal_mode = %1").arg(profile.journalMode));
+                DatabaseManager::instance().configureConnection(db);
+            } else {
+                query.exec("PRAGMA journal_mode = DELETE");
+                query.exec("PRAGMA synchronous = FULL");
+            }
+            query.exec("CREATE TABLE bench (id INTEGER PRIMARY KEY, city_id TEXT, value REAL, update_time TEXT)");
+            query.exec("CREATE INDEX idx_bench_city ON bench(city_id)");
+            
+            QSqlQuery insert(db);
+            insert.prepare("INSERT INTO bench (city_id, value, update_time) VALUES (?, ?, ?)");
+            const QString now = QDateTime::currentDateTime().toString(Qt::ISODate);
+            auto insertRow = [&](int i) {
+                insert.addBindValue(m_cities.at(i % m_cities.size()).cityId);
+                insert.addBindValue(i * 0.5);
+                insert.addBindValue(now);
+                insert.exec();
+            };
+            
+            // 每行单独提交：日志模式和同步级别的差别主要体现在这里
+            QElapsedTimer timer;
+            timer.start();
+            for (int i = 0; i < STORAGE_AUTOCOMMIT_ROWS; ++i) {
+                insertRow(i);
+            }
+            double autocommitRate = STORAGE_AUTOCOMMIT_ROWS * 1e9 / qMax<qint64>(1, timer.nsecsElapsed());
+            
+            timer.restart();
+            db.transaction();
+            for (int i = 0; i < STORAGE_BATCH_ROWS; ++i) {
+                insertRow(i);
+            }
+            db.commit();
+            double batchRate = STORAGE_BATCH_ROWS * 1e9 / qMax<qint64>(1, timer.nsecsElapsed());
+            
+            QSqlQuery select(db);
+            select.prepare("SELECT value FROM bench WHERE city_id = ?");
+            timer.restart();
+            for (int i = 0; i < LOOKUP_COUNT; ++i) {
+                select.addBindValue(m_cities.at(i % m_cities.size()).cityId);
+                select.exec();
+                while (select.next()) {}
+            }
+            select.finish();
+            double queryRate = LOOKUP_COUNT * 1e9 / qMax<qint64>(1, timer.nsecsElapsed());
+            
+            out << QString("Storage (%1): %2 autocommit inserts/s, %3 batched inserts/s, %4 queries/s")
+                       .arg(tuned ? profile.journalMode + "/" + profile.synchronous : QString("DELETE/FULL"))
+                       .arg(autocommitRate, 0, 'f', 0).arg(batchRate, 0, 'f', 0).arg(queryRate, 0, 'f', 0)
+                << Qt::endl;
+        }
+        // 连接和查询对象都已销毁，移除时关闭连接
+        QSqlDatabase::removeDatabase(name);
+    }
+    return true;
+}
+
+bool BenchmarkRunner::writeCities(QTextStream &out)
+{
+    CityService &service = CityService::instance();
+    for (int start = 0; start < m_cities.size(); start += WRITE_CHUNK) {
+        if (!service.addCities(m_cities.mid(start, WRITE_CHUNK))) {
+            out << "Failed to write benchmark cities" << Qt::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void BenchmarkRunner::benchCityLookup(QTextStream &out)
+{
+    CityService &service = CityService::instance();
+    QRandomGenerator random(RANDOM_SEED);
+    
+    QElapsedTimer timer;
+    timer.start();
+    int found = 0;
+    for (int i = 0; i < LOOKUP_COUNT; ++i) {
+        const CityInfo city = service.getCity(m_cities.at(random.bounded(int(m_cities.size()))).cityId);
+        if (!city.cityId.isEmpty()) {
+            ++found;
+        }
+    }
+    qint64 elapsed = timer.nsecsElapsed();
+    
+    out << QString("City lookup by ID: %1 lookups/s (%2 of %3 found)")
+               .arg(LOOKUP_COUNT * 1e9 / qMax<qint64>(1, elapsed), 0, 'f', 0).arg(found).arg(LOOKUP_COUNT)
+        << Qt::endl;
+}
+
+void BenchmarkRunner::benchCitySearch(QTextStream &out)
+{
+    // 汉字前缀、全拼前缀、拼音首字母、城市名中间的字和全拼中间的片段各占一部分
+    QRandomGenerator random(RANDOM_SEED);
+    QStringList keywords;
+    for (int i = 0; i < QUERY_SAMPLES; ++i) {
+        const QString name = m_cities.at(random.bounded(int(m_cities.size()))).name;
+        switch (i % 5) {
+            case 0: keywords.append(name.left(2)); break;
+            case 1: keywords.append(PinyinUtil::fullPinyin(name).left(4)); break;
+            case 2: keywords.append(PinyinUtil::initials(name)); break;
+            case 3: keywords.append(name.mid(1, 1)); break;
+            default: keywords.append(PinyinUtil::fullPinyin(name).mid(2, 4)); break;
+        }
+    }
+    
+    CityService &service = CityService::instance();
+    QList<qint64> samples;
+    int results = 0;
+    for (const QString &keyword : std::as_const(keywords)) {
+        QElapsedTimer timer;
+        timer.start();
+        results += service.searchCities(keyword).size();
+        samples.append(timer.nsecsElapsed());
+    }
+    
+    const DatabaseManager &db = DatabaseManager::instance();
+    out << QString("City search (%1 cities, FTS %2, trigram %3): %4, %5 results per query")
+               .arg(m_cities.size())
+               .arg(db.hasFullTextSearch() ? "on" : "off")
+               .arg(db.hasSubstringSearch() ? "on" : "off")
+               .arg(formatLatency(latency(samples)))
+               .arg(results / qMax(1, int(keywords.size())))
+        << Qt::endl;
+}
+
+void BenchmarkRunner::benchSpatialQueries(QTextStream &out)
+{
+    CityService &service = CityService::instance();
+    QRandomGenerator random(RANDOM_SEED);
+    
+    QList<qint64> nearest;
+    QList<qint64> boxes;
+    for (int i = 0; i < QUERY_SAMPLES; ++i) {
+        double latitude = random.bounded(130.0) - 60.0;
+        double longitude = random.bounded(360.0) - 180.0;
+        
+        QElapsedTimer timer;
+        timer.start();
+        service.nearestCities(latitude, longitude, 5);
+        nearest.append(timer.nsecsElapsed());
+        
+        timer.restart();
+        service.citiesInBoundingBox(latitude - 1.0, longitude - 1.0, latitude + 1.0, longitude + 1.0);
+        boxes.append(timer.nsecsElapsed());
+    }
+    
+    out << QString("Nearest 5 cities (R*Tree %1): %2")
+               .arg(DatabaseManager::instance().hasSpatialIndex() ? "on" : "off")
+               .arg(formatLatency(latency(nearest)))
+        << Qt::endl;
+    out << QString("Cities in 2x2 degree box: %1").arg(formatLatency(latency(boxes))) << Qt::endl;
+}
+
+void BenchmarkRunner::benchCityModel(QTextStream &out)
+{
+    QList<CityInfo> cities = m_cities.mid(0, MODEL_ROWS);
+    for (int i = 0; i < cities.size(); i += 100) {
+        cities[i].isFavorite = true;
+        cities[i].favoriteOrder = i / 100 + 1;
+    }
+    
+    CityModel model;
+    QElapsedTimer timer;
+    timer.start();
+    model.setCities(cities);
+    qint64 loadMs = timer.elapsed();
+    
+    QRandomGenerator random(RANDOM_SEED);
+    timer.restart();
+    int found = 0;
+    for (int i = 0; i < LOOKUP_COUNT; ++i) {
+        if (model.findRowByCityId(cities.at(random.bounded(int(cities.size()))).cityId) >= 0) {
+            ++found;
+        }
+    }
+    double lookupRate = LOOKUP_COUNT * 1e9 / qMax<qint64>(1, timer.nsecsElapsed());
+    
+    timer.restart();
+    const int favoriteCalls = 100;
+    for (int i = 0; i < favoriteCalls; ++i) {
+        model.favoriteCities();
+    }
+    double favoritesMs = timer.nsecsElapsed() / 1e6 / favoriteCalls;
+    
+    // 在中间位置反复删除再追加，覆盖索引的增量维护
+    timer.restart();
+    const int edits = 1000;
+    for (int i = 0; i < edits; ++i) {
+        int row = cities.size() / 2;
+        CityInfo city = model.cityAt(row);
+        model.removeCity(row);
+        model.addCity(city);
+    }
+    double editMs = timer.nsecsElapsed() / 1e6 / edits;
+    
+    out << QString("City model (%1 rows): load %2 ms, %3 lookups/s (%4 found), favorites %5 ms, "
+                   "remove + add %6 ms")
+               .arg(cities.size()).arg(loadMs).arg(lookupRate, 0, 'f', 0).arg(found)
+               .arg(favoritesMs, 0, 'f', 3).arg(editMs, 0, 'f', 3)
+        << Qt::endl;
+}
+
+void BenchmarkRunner::benchFuzzySearch(QTextStream &out)
+{
+    CityModel model;
+    model.setCities(m_cities);
+    CityFilterModel filter;
+    filter.setSourceModel(&model);
+    filter.sort(CityModel::ColName);
+    
+    // 逐键输入一个拼音，最后两次包含拼写错误
+    const QString target = PinyinUtil::fullPinyin(m_cities.first().name);
+    QStringList keystrokes;
+    for (int i = 1; i <= target.size(); ++i) {
+        keystrokes.append(target.left(i));
+    }
+    if (target.size() >= 4) {
+        QString typo = target;
+        std::swap(typo[1], typo[2]);
+        keystrokes.append(typo);
+        keystrokes.append(target.left(target.size() - 1) + 'x');
+    }
+    
+    QList<qint64> samples;
+    int lastCount = 0;
+    for (const QString &keyword : std::as_const(keystrokes)) {
+        QElapsedTimer timer;
+        timer.start();
+        filter.setSearchKeyword(keyword);
+        lastCount = filter.rowCount();
+        if (lastCount > 0) {
+            filter.data(filter.index(0, CityModel::ColName));
+        }
+        samples.append(timer.nsecsElapsed());
+    }
+    
+    out << QString("Fuzzy search keystroke (%1 cities, \"%2\"): %3, %4 results for the last keystroke")
+               .arg(m_cities.size()).arg(target).arg(formatLatency(latency(samples))).arg(lastCount)
+        << Qt::endl;
+}
+
+void BenchmarkRunner::benchChartRedraw(QTextStream &out)
+{
+    ChartWidget chart;
+    chart.resize(1200, 700);
+    chart.show();
+    QApplication::processEvents();
+    
+    // 替换数据并立即绘制，包含更新序列和场景重绘的时间
+    auto measure = [&chart](const std::function<void()> &update) {
+        QList<qint64> samples;
+        for (int i = 0; i < CHART_SAMPLES; ++i) {
+            QElapsedTimer timer;
+            timer.start();
+            update();
+            chart.grab();
+            samples.append(timer.nsecsElapsed());
+        }
+        return latency(samples);
+    };
+    
+    const QList<int> pointCounts = {24, 1000, 100000};
+    QDateTime start = QDateTime::currentDateTime();
+    for (int count : pointCounts) {
+        QList<HourlyForecast> forecast;
+        forecast.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            HourlyForecast h;
+            h.time = start.addSecs(qint64(i) * 3600);
+            h.temperature = 15 + 10 * std::sin(i / 12.0);
+            h.humidity = 50 + i % 40;
+            h.windSpeed = 5 + i % 20;
+            forecast.append(h);
+        }
+        
+        Latency redraw = measure([&]() { chart.updateHourlyData(forecast); });
+        out << QString("Hourly chart redraw (%1 points): %2").arg(count).arg(formatLatency(redraw)) << Qt::endl;
+    }
+    
+    // 最后一组数据保留在图表中，改变宽度时按新的绘图区宽度重新降采样
+    int width = chart.width();
+    Latency resample = measure([&]() {
+        width = width == 1200 ? 900 : 1200;
+        chart.resize(width, chart.height());
+        QApplication::processEvents();
+    });
+    out << QString("Hourly chart resize (%1 points): %2").arg(pointCounts.last()).arg(formatLatency(resample))
+        << Qt::endl;
+    
+    QList<DailyForecast> daily;
+    for (int i = 0; i < 15; ++i) {
+        DailyForecast d;
+        d.date = start.date().addDays(i);
+        d.highTemp = 20 + i % 7;
+        d.lowTemp = 10 + i % 5;
+        d.humidity = 40 + i * 3;
+        d.windSpeed = 3 + i % 4;
+        d.precipitationProb = i * 6;
+        daily.append(d);
+    }
+    Latency redraw = measure([&]() { chart.updateDailyData(daily); });
+    out << QString("Daily chart redraw (%1 days): %2").arg(daily.size()).arg(formatLatency(redraw)) << Qt::endl;
+}
+
+void BenchmarkRunner::benchReportRendering(const QString &workDir, QTextStream &out)
+{
+    // 前 REPORT_CITIES 个城市写入从当前小时起 24 小时的逐小时预报
+    QSqlDatabase &db = DatabaseManager::instance().database();
+    QSqlQuery insert(db);
+    insert.prepare("INSERT OR REPLACE INTO weather_forecast "
+                   "(city_id, forecast_date, forecast_hour, temperature, humidity, wind_speed) "
+                   "VALUES (?, ?, ?, ?, ?, ?)");
+    QStringList cityIds;
+    const QDateTime start = QDateTime::currentDateTime();
+    db.transaction();
+    for (int i = 0; i < qMin(REPORT_CITIES, int(m_cities.size())); ++i) {
+        cityIds.append(m_cities.at(i).cityId);
+        for (int hour = 0; hour < 24; ++hour) {
+            const QDateTime time = start.addSecs(hour * 3600);
+            insert.addBindValue(cityIds.last());
+            insert.addBindValue(time.date().toString("yyyy-MM-dd"));
+            insert.addBindValue(time.time().hour());
+            insert.addBindValue(15 + 10 * std::sin((i + hour) / 4.0));
+            insert.addBindValue(40 + (i + hour) % 50);
+            insert.addBindValue(3 + (i * hour) % 20);
+            insert.exec();
+        }
+    }
+    db.commit();
+    
+    // 同样的城市分别用单线程和全部核心渲染两种格式
+    QList<int> threadCounts = {1};
+    if (QThread::idealThreadCount() > 1) {
+        threadCounts.append(QThread::idealThreadCount());
+    }
+    const QStringList formats = {"png", "svg"};
+    for (const QString &format : formats) {
+        for (int threads : std::as_const(threadCounts)) {
+            ReportOptions options;
+            options.cityIds = cityIds;
+            options.outputDir = QString("%1/reports_%2_%3").arg(workDir, format).arg(threads);
+            options.format = format;
+            options.threads = threads;
+            
+            ReportRenderer renderer(options);
+            const ReportResult result = renderer.render();
+            out << QString("Report rendering (%1 cities, %2, %3 threads): %4 images in %5 ms (%6 images/s), "
+                           "%7 failed")
+                       .arg(result.cities).arg(format).arg(threads).arg(result.images).arg(result.elapsedMs)
+                       .arg(result.imagesPerSecond, 0, 'f', 1).arg(result.failed)
+                << Qt::endl;
+        }
+    }
+}
+
+bool BenchmarkRunner::benchCityImport(const QString &workDir, QTextStream &out)
+{
+    // 把合成城市写成 GeoNames 格式的文件，换一套编号后走完整的流式导入
+    const QString filePath = workDir + "/bench_geonames.txt";
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        out << "Failed to write " << filePath << Qt::endl;
+        return false;
+    }
+    QTextStream stream(&file);
+    for (int i = 0; i < m_cities.size(); ++i) {
+        const CityInfo &city = m_cities.at(i);
+        stream << (IMPORT_ID_BASE + i) << '\t' << city.name << "\t\t\t"
+               << city.latitude << '\t' << city.longitude
+               << "\tP\tPPL\tCN\t\t01\t\t\t\t0\t\t0\tAsia/Shanghai\t2026-01-01\n";
+    }
+    stream.flush();
+    file.close();
+    
+    CityImportResult result;
+    CityImportWorker worker;
+    QObject::connect(&worker, &CityImportWorker::finished, [&result](const CityImportResult &finished) {
+        result = finished;
+    });
+    worker.importFile(filePath);
+    if (!result.success) {
+        out << "City import failed: " << result.error << Qt::endl;
+        return false;
+    }
+    
+    out << QString("City import (GeoNames): %1 rows in %2 ms (%3 rows/s), %4 skipped")
+               .arg(result.rows).arg(result.elapsedMs).arg(result.rowsPerSecond, 0, 'f', 0).arg(result.skipped)
+        << Qt::endl;
+    return true;
+}
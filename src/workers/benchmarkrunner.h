@@ -0,0 +1,102 @@
+/**
+ * @file benchmarkrunner.h
+ * @brief 命令行性能基准测试
+ */
+
+#ifndef BENCHMARKRUNNER_H
+#define BENCHMARKRUNNER_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QTextStream>
+#include "../models/citymodel.h"
+
+/**
+ * @class BenchmarkRunner
+ * @brief 对数据库、城市搜索、模型和图表的关键路径计时
+ * 
+ * 在临时目录中新建数据库并生成合成的城市数据（默认 15 万个），不会修改用户数据：
+ * - 存储参数：默认的回滚日志 + FULL 同步与当前性能配置下的写入、查询吞吐
+ * - 城市读取：按 cityId 查询的每秒次数（预编译语句缓存）
+ * - 城市搜索：全文索引搜索的平均和 P95 延迟
+ * - 空间查询：最近城市和矩形范围查询的延迟
+ * - 城市模型：按 cityId 查找、收藏列表和增删的耗时
+ * - 模糊匹配：逐键输入到得到排序结果的延迟
+ * - 图表：替换逐小时和每日数据并重绘的耗时，长序列改变宽度后重新降采样的耗时
+ * - 报表：300 个城市的 PNG、SVG 图表在单线程和多线程下的每秒图片数
+ * - 城市导入：GeoNames 格式文件流式导入的每秒行数
+ * 
+ * 由 main 在命令行带 --bench 时调用，此时使用 offscreen 平台插件。
+ */
+class BenchmarkRunner
+{
+public:
+    explicit BenchmarkRunner(int cityCount);
+    
+    /**
+     * @brief 依次运行所有基准测试并输出结果
+     * @return 是否全部完成
+     */
+    bool runAll(const QString &workDir, QTextStream &out);
+    
+    /**
+     * @brief 命令行是否要求运行基准测试
+     */
+    static bool isRequested(int argc, char *argv[]);
+    
+    /**
+     * @brief 解析命令行并运行基准测试
+     * 
+     * 用法：--bench [--cities N]
+     * @return 进程退出码
+     */
+    static int run(const QStringList &arguments);
+
+private:
+    /**
+     * @struct Latency
+     * @brief 一组计时的统计
+     */
+    struct Latency {
+        double averageMs = 0;
+        double p95Ms = 0;
+    };
+    
+    static Latency latency(QList<qint64> nanoseconds);
+    static QString formatLatency(const Latency &latency);
+    
+    QList<CityInfo> makeCities(int count) const;
+    
+    bool benchStorageProfile(const QString &workDir, QTextStream &out);
+    
+    /**
+     * @brief 把合成城市写入基准数据库，供之后的查询类测试使用
+     */
+    bool writeCities(QTextStream &out);
+    
+    void benchCityLookup(QTextStream &out);
+    void benchCitySearch(QTextStream &out);
+    void benchSpatialQueries(QTextStream &out);
+    void benchCityModel(QTextStream &out);
+    void benchFuzzySearch(QTextStream &out);
+    void benchChartRedraw(QTextStream &out);
+    void benchReportRendering(const QString &workDir, QTextStream &out);
+    bool benchCityImport(const QString &workDir, QTextStream &out);
+    
+    int m_cityCount;
+    QList<CityInfo> m_cities;
+    
+    static const int STORAGE_AUTOCOMMIT_ROWS = 500;
+    static const int STORAGE_BATCH_ROWS = 50000;
+    static const int LOOKUP_COUNT = 20000;
+    static const int WRITE_CHUNK = 5000;
+    static const int QUERY_SAMPLES = 200;
+    static const int IMPORT_ID_BASE = 90000000;
+    static const int REPORT_CITIES = 300;
+    static const int CHART_SAMPLES = 5;
+    static const int MODEL_ROWS = 100000;
+    static const quint32 RANDOM_SEED = 20260115;
+};
+
+#endif // BENCHMARKRUNNER_H
@@ -0,0 +1,336 @@
+/**
+ * @file cityimporter.cpp
+ * @brief 城市数据批量导入实现
+ */
+
+#include "cityimporter.h"
+#include "../services/cityservice.h"
+#include "../database/databasemanager.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <QSqlError>
+
+namespace {
+// GeoNames 与城市数据一同发布的省级行政区编码表
+const char *ADMIN1_CODES_FILE = "admin1CodesASCII.txt";
+}
+
+CityImportWorker::CityImportWorker(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void CityImportWorker::cancel()
+{
+    m_cancelled = true;
+}
+
+void CityImportWorker::importFile(const QString &filePath)
+{
+    m_cancelled = false;
+    m_csvColumns.clear();
+    m_admin1Names.clear();
+    
+    CityImportResult result;
+    QElapsedTimer timer;
+    timer.start();
+    
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.error = file.errorString();
+        emit finished(result);
+        return;
+    }
+    
+    if (!DatabaseManager::instance().isConnected()) {
+        result.error = tr("数据库未连接");
+        emit finished(result);
+        return;
+    }
+    
+    // 本线程自己的读写连接，和界面线程互不阻塞
+    QSqlDatabase &db = DatabaseManager::instance().database();
+    CityService &service = CityService::instance();
+    
+    CityImportProgress progress;
+    progress.totalBytes = file.size();
+    
+    enum Format { Unknown, GeoNames, Csv } format = Unknown;
+    QList<CityInfo> chunk;
+    chunk.reserve(CHUNK_SIZE);
+    int rowsInTransaction = 0;
+    int insertedInTransaction = 0;
+    
+    // 每次提交后通知一次，CityDirectory 等缓存随之失效；
+    // 提交失败时整批回滚，这些行不计入结果，导入就此停止
+    auto commit = [&]() {
+        if (!db.commit()) {
+            result.error = tr("提交导入事务失败: %1").arg(db.lastError().text());
+            db.rollback();
+            result.rows -= insertedInTransaction;
+        } else {
+            service.notifyCitiesAdded(insertedInTransaction);
+        }
+        rowsInTransaction = 0;
+        insertedInTransaction = 0;
+        return result.error.isEmpty();
+    };
+    
+    auto flushChunk = [&]() {
+        if (chunk.isEmpty()) {
+            return;
+        }
+        if (rowsInTransaction == 0) {
+            db.transaction();
+        }
+        int inserted = service.insertCities(chunk);
+        result.rows += inserted;
+        result.skipped += chunk.size() - inserted;
+        rowsInTransaction += chunk.size();
+        insertedInTransaction += inserted;
+        chunk.clear();
+        
+        if (rowsInTransaction >= TRANSACTION_ROWS && !commit()) {
+            return;
+        }
+        
+        progress.bytesRead = file.pos();
+        progress.rows = result.rows;
+        progress.rowsPerSecond = result.rows * 1000.0 / qMax<qint64>(1, timer.elapsed());
+        emit progressChanged(progress);
+    };
+    
+    while (!file.atEnd() && !m_cancelled && result.error.isEmpty()) {
+        QString line = QString::fromUtf8(file.readLine());
+        while (line.endsWith('\n') || line.endsWith('\r')) {
+            line.chop(1);
+        }
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        
+        // GeoNames 导出没有表头，首行按字段数识别格式
+        if (format == Unknown) {
+            if (line.count('\t') >= 14) {
+                format = GeoNames;
+                int codes = loadAdmin1Names(QFileInfo(filePath).dir().filePath(ADMIN1_CODES_FILE));
+                qDebug() << "Loaded" << codes << "GeoNames admin1 names";
+            } else {
+                if (!readCsvHeader(line)) {
+                    result.error = tr("无法识别的文件格式，CSV 需包含 name、latitude、longitude 列");
+                    break;
+                }
+                format = Csv;
+                continue;
+            }
+        }
+        
+        CityInfo city;
+        bool ok = format == GeoNames ? parseGeoNamesLine(line, city) : parseCsvLine(line, city);
+        if (!ok) {
+            ++result.skipped;
+            continue;
+        }
+        
+        chunk.append(city);
+        if (chunk.size() >= CHUNK_SIZE) {
+            flushChunk();
+        }
+    }
+    
+    if (result.error.isEmpty()) {
+        flushChunk();
+    }
+    if (rowsInTransaction > 0) {
+        commit();
+    }
+    
+    result.cancelled = m_cancelled;
+    result.success = result.error.isEmpty();
+    result.elapsedMs = timer.elapsed();
+    result.rowsPerSecond = result.rows * 1000.0 / qMax<qint64>(1, result.elapsedMs);
+    
+    qDebug() << "City import finished:" << result.rows << "rows," << result.skipped << "skipped in"
+             << result.elapsedMs << "ms (" << int(result.rowsPerSecond) << "rows/s)";
+    emit finished(result);
+}
+
+bool CityImportWorker::parseGeoNamesLine(const QString &line, CityInfo &city) const
+{
+    // geonameid, name, asciiname, alternatenames, latitude, longitude, feature class,
+    // feature code, country code, cc2, admin1 code, ...
+    const QStringList fields = line.split('\t');
+    if (fields.size() < 15 || fields[6] != "P") {
+        return false;
+    }
+    
+    bool latOk = false;
+    bool lonOk = false;
+    city.cityId = fields[0];
+    city.name = fields[1];
+    city.latitude = fields[4].toDouble(&latOk);
+    city.longitude = fields[5].toDouble(&lonOk);
+    city.country = fields[8];
+    city.province = m_admin1Names.value(city.country + '.' + fields[10]);
+    
+    return latOk && lonOk && !city.cityId.isEmpty() && !city.name.isEmpty();
+}
+
+int CityImportWorker::loadAdmin1Names(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    
+    // code, name, asciiname, geonameid
+    while (!file.atEnd()) {
+        const QStringList fields = QString::fromUtf8(file.readLine()).trimmed().split('\t');
+        if (fields.size() >= 2 && !fields[0].isEmpty()) {
+            m_admin1Names.insert(fields[0], fields[1]);
+        }
+    }
+    return m_admin1Names.size();
+}
+
+bool CityImportWorker::readCsvHeader(const QString &line)
+{
+    // 常见列名别名
+    static const QHash<QString, QString> aliases = {
+        {"id", "city_id"}, {"geonameid", "city_id"}, {"cityid", "city_id"},
+        {"admin1", "province"}, {"state", "province"},
+        {"country_code", "country"},
+        {"lat", "latitude"}, {"lon", "longitude"}, {"lng", "longitude"}
+    };
+    
+    const QStringList headers = splitCsvLine(line);
+    for (int i = 0; i < headers.size(); ++i) {
+        QString name = headers[i].trimmed().toLower();
+        m_csvColumns.insert(aliases.value(name, name), i);
+    }
+    
+    return m_csvColumns.contains("name") && m_csvColumns.contains("latitude")
+           && m_csvColumns.contains("longitude");
+}
+
+bool CityImportWorker::parseCsvLine(const QString &line, CityInfo &city) const
+{
+    const QStringList fields = splitCsvLine(line);
+    auto field = [&](const QString &column) {
+        int index = m_csvColumns.value(column, -1);
+        return index >= 0 && index < fields.size() ? fields[index].trimmed() : QString();
+    };
+    
+    bool latOk = false;
+    bool lonOk = false;
+    city.name = field("name");
+    city.province = field("province");
+    city.country = field("country");
+    city.latitude = field("latitude").toDouble(&latOk);
+    city.longitude = field("longitude").toDouble(&lonOk);
+    
+    // 没有ID列时用坐标生成稳定的ID
+    city.cityId = field("city_id");
+    if (city.cityId.isEmpty()) {
+        city.cityId = QString("%1,%2").arg(city.latitude, 0, 'f', 4).arg(city.longitude, 0, 'f', 4);
+    }
+    
+    return latOk && lonOk && !city.name.isEmpty();
+}
+
+QStringList CityImportWorker::splitCsvLine(const QString &line)
+{
+    QStringList fields;
+    QString current;
+    bool quoted = false;
+    
+    for (int i = 0; i < line.size(); ++i) {
+        QChar ch = line[i];
+        if (quoted) {
+            if (ch == '"') {
+                // 连续两个引号表示字面引号
+                if (i + 1 < line.size() && line[i + 1] == '"') {
+                    current.append('"');
+                    ++i;
+                } else {
+                    quoted = false;
+                }
+            } else {
+                current.append(ch);
+            }
+        } else if (ch == '"') {
+            quoted = true;
+        } else if (ch == ',') {
+            fields.append(current);
+            current.clear();
+        } else {
+            current.append(ch);
+        }
+    }
+    fields.append(current);
+    return fields;
+}
+
+// ==================== CityImporter ====================
+
+CityImporter::CityImporter(QObject *parent)
+    : QObject(parent)
+    , m_workerThread(new QThread(this))
+    , m_worker(new CityImportWorker())
+{
+    m_worker->moveToThread(m_workerThread);
+    
+    connect(m_worker, &CityImportWorker::progressChanged,
+            this, &CityImporter::progressChanged);
+    
+    connect(m_worker, &CityImportWorker::finished,
+            this, [this](const CityImportResult &result) {
+        m_running = false;
+        emit finished(result);
+    });
+    
+    // 线程清理
+    connect(m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
+    
+    m_workerThread->start();
+}
+
+CityImporter::~CityImporter()
+{
+    m_worker->cancel();
+    m_workerThread->quit();
+    m_workerThread->wait();
+}
+
+CityImporter& CityImporter::instance()
+{
+    static CityImporter instance;
+    return instance;
+}
+
+bool CityImporter::start(const QString &filePath)
+{
+    if (m_running) {
+        return false;
+    }
+    
+    m_running = true;
+    QMetaObject::invokeMethod(m_worker, "importFile", Qt::QueuedConnection,
+                              Q_ARG(QString, filePath));
+    return true;
+}
+
+void CityImporter::cancel()
+{
+    if (m_running) {
+        m_worker->cancel();
+    }
+}
+
+bool CityImporter::isRunning() const
+{
+    return m_running;
+}
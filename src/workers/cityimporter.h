@@ -0,0 +1,144 @@
+/**
+ * @file cityimporter.h
+ * @brief 城市数据批量导入
+ */
+
+#ifndef CITYIMPORTER_H
+#define CITYIMPORTER_H
+
+#include <QObject>
+#include <QThread>
+#include <QHash>
+#include <atomic>
+#include "../models/citymodel.h"
+
+/**
+ * @struct CityImportProgress
+ * @brief 导入进度
+ */
+struct CityImportProgress {
+    qint64 bytesRead = 0;
+    qint64 totalBytes = 0;
+    int rows = 0;               // 已写入的行数
+    double rowsPerSecond = 0;
+    
+    int percent() const { return totalBytes > 0 ? int(bytesRead * 100 / totalBytes) : 0; }
+};
+
+/**
+ * @struct CityImportResult
+ * @brief 导入结果
+ */
+struct CityImportResult {
+    bool success = false;
+    bool cancelled = false;
+    int rows = 0;               // 写入的行数
+    int skipped = 0;            // 格式不符或非居民点而跳过的行数
+    qint64 elapsedMs = 0;
+    double rowsPerSecond = 0;
+    QString error;
+};
+
+/**
+ * @class CityImportWorker
+ * @brief 城市导入工作类
+ * 
+ * 在后台线程中逐行流式解析文件，支持两种格式：
+ * - GeoNames 导出的 TSV（cities500.txt、allCountries.txt 等，无表头），只导入居民点(P类)；
+ *   省份列只有 admin1 编码，按同目录下的 admin1CodesASCII.txt 解析为名称，
+ *   找不到该文件或编码时省份留空，避免把 "22" 这样的编码显示在界面和搜索索引中
+ * - 带表头的 CSV，按列名识别 city_id/name/province/country/latitude/longitude
+ * 
+ * 每解析 CHUNK_SIZE 行批量写入一次，每 TRANSACTION_ROWS 行提交一次事务
+ */
+class CityImportWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CityImportWorker(QObject *parent = nullptr);
+    
+    /**
+     * @brief 请求取消导入，当前批次写完后停止并提交已写入的数据
+     */
+    void cancel();
+
+public slots:
+    /**
+     * @brief 导入文件
+     * @param filePath 文件路径
+     */
+    void importFile(const QString &filePath);
+
+signals:
+    void progressChanged(const CityImportProgress &progress);
+    void finished(const CityImportResult &result);
+
+private:
+    bool parseGeoNamesLine(const QString &line, CityInfo &city) const;
+    bool parseCsvLine(const QString &line, CityInfo &city) const;
+    bool readCsvHeader(const QString &line);
+    
+    /**
+     * @brief 读取 GeoNames 的 admin1CodesASCII.txt（"CN.22\tBeijing\t..."）
+     * @return 读到的编码数量，文件不存在时为 0
+     */
+    int loadAdmin1Names(const QString &filePath);
+    static QStringList splitCsvLine(const QString &line);
+    
+    QHash<QString, int> m_csvColumns;   // 列名 → 列序号
+    QHash<QString, QString> m_admin1Names;  // "国家.admin1编码" → 省份名称
+    std::atomic<bool> m_cancelled{false};
+    
+    static const int CHUNK_SIZE = 5000;
+    static const int TRANSACTION_ROWS = 50000;
+};
+
+/**
+ * @class CityImporter
+ * @brief 城市导入控制器
+ * 
+ * 管理导入线程的生命周期，同一时间只允许一个导入任务。
+ * 导入期间不发出逐行的 cityAdded 信号，完成后通过 finished 统一通知
+ */
+class CityImporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    static CityImporter& instance();
+    
+    /**
+     * @brief 开始后台导入
+     * @param filePath 文件路径
+     * @return 已有导入任务在运行时返回 false
+     */
+    bool start(const QString &filePath);
+    
+    /**
+     * @brief 取消正在进行的导入
+     */
+    void cancel();
+    
+    /**
+     * @brief 是否有导入任务在运行
+     */
+    bool isRunning() const;
+
+signals:
+    void progressChanged(const CityImportProgress &progress);
+    void finished(const CityImportResult &result);
+
+private:
+    explicit CityImporter(QObject *parent = nullptr);
+    ~CityImporter();
+    
+    CityImporter(const CityImporter&) = delete;
+    CityImporter& operator=(const CityImporter&) = delete;
+    
+    QThread *m_workerThread;
+    CityImportWorker *m_worker;
+    bool m_running = false;
+};
+
+#endif // CITYIMPORTER_H
@@ -0,0 +1,204 @@
+/**
+ * @file cityprefetcher.cpp
+ * @brief 城市天气预测性预取实现
+ */
+
+#include "cityprefetcher.h"
+#include "weatherworker.h"
+#include "../config/configmanager.h"
+#include "../services/cityservice.h"
+#include "../services/asyncdataservice.h"
+#include "../services/weatherservice.h"
+#include <QDateTime>
+#include <QDebug>
+
+CityPrefetcher::CityPrefetcher(QObject *parent)
+    : QObject(parent)
+    , m_hoverTimer(new QTimer(this))
+{
+    m_hoverTimer->setSingleShot(true);
+    m_hoverTimer->setInterval(HOVER_DELAY_MS);
+    connect(m_hoverTimer, &QTimer::timeout, this, &CityPrefetcher::onHoverTimeout);
+    
+    m_recentCities = ConfigManager::instance().value("prefetch/recentCities").toStringList();
+    m_lastRefillMs = QDateTime::currentMSecsSinceEpoch();
+    
+    connect(&CityService::instance(), &CityService::cityDeleted,
+            this, [this](const QString &cityId) {
+        m_entries.remove(cityId);
+        if (m_recentCities.removeAll(cityId) > 0) {
+            saveRecentCities();
+        }
+    });
+}
+
+CityPrefetcher& CityPrefetcher::instance()
+{
+    static CityPrefetcher instance;
+    return instance;
+}
+
+void CityPrefetcher::hoverCity(const QString &cityId)
+{
+    if (cityId == m_hoverCityId && m_hoverTimer->isActive()) {
+        return;
+    }
+    
+    // 只在鼠标停留后才预取，快速划过列表不产生请求
+    m_hoverCityId = cityId;
+    if (cityId.isEmpty()) {
+        m_hoverTimer->stop();
+    } else {
+        m_hoverTimer->start();
+    }
+}
+
+bool CityPrefetcher::prefetchCity(const QString &cityId)
+{
+    if (cityId.isEmpty()) {
+        return false;
+    }
+    
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    expireEntries(now);
+    
+    // 缓存仍然有效时不重复预取
+    auto it = m_entries.constFind(cityId);
+    if (it != m_entries.constEnd() && isFresh(*it, now)) {
+        return false;
+    }
+    
+    if (!takeBudget(now)) {
+        m_stats.throttled++;
+        emit statsChanged(m_stats);
+        return false;
+    }
+    
+    WeatherThreadController &controller = WeatherThreadController::instance();
+    controller.requestPrefetch(cityId, WeatherTask::FetchCurrent);
+    controller.requestPrefetch(cityId, WeatherTask::FetchHourly);
+    controller.requestPrefetch(cityId, WeatherTask::FetchDaily);
+    
+    PrefetchEntry entry;
+    entry.issuedMs = now;
+    m_entries.insert(cityId, entry);
+    
+    m_stats.issued++;
+    emit statsChanged(m_stats);
+    return true;
+}
+
+void CityPrefetcher::warmUp(int topFavorites)
+{
+    // 收藏列表可能需要读数据库，在数据库线程取得后再回到主线程发起预取
+    AsyncDataService::instance().favorites().then(this, [this, topFavorites](const QList<CityInfo> &favorites) {
+        warmUp(favorites, topFavorites);
+    });
+}
+
+void CityPrefetcher::warmUp(const QList<CityInfo> &favorites, int topFavorites)
+{
+    QStringList targets;
+    for (int i = 0; i < favorites.size() && i < topFavorites; ++i) {
+        targets.append(favorites.at(i).cityId);
+    }
+    for (const QString &cityId : std::as_const(m_recentCities)) {
+        if (!targets.contains(cityId)) {
+            targets.append(cityId);
+        }
+    }
+    
+    int issued = 0;
+    for (const QString &cityId : std::as_const(targets)) {
+        if (prefetchCity(cityId)) {
+            issued++;
+        }
+    }
+    qDebug() << "Prefetch warm-up issued" << issued << "of" << targets.size() << "cities";
+}
+
+void CityPrefetcher::recordCityViewed(const QString &cityId)
+{
+    if (cityId.isEmpty()) {
+        return;
+    }
+    
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    expireEntries(now);
+    
+    auto it = m_entries.find(cityId);
+    if (it != m_entries.end() && isFresh(*it, now)) {
+        it->viewed = true;
+        m_stats.hits++;
+    } else {
+        m_stats.misses++;
+    }
+    emit statsChanged(m_stats);
+    
+    m_recentCities.removeAll(cityId);
+    m_recentCities.prepend(cityId);
+    while (m_recentCities.size() > MAX_RECENT_CITIES) {
+        m_recentCities.removeLast();
+    }
+    saveRecentCities();
+}
+
+QStringList CityPrefetcher::recentCities() const
+{
+    return m_recentCities;
+}
+
+PrefetchStats CityPrefetcher::stats()
+{
+    expireEntries(QDateTime::currentMSecsSinceEpoch());
+    return m_stats;
+}
+
+void CityPrefetcher::onHoverTimeout()
+{
+    prefetchCity(m_hoverCityId);
+}
+
+bool CityPrefetcher::isFresh(const PrefetchEntry &entry, qint64 now) const
+{
+    // 以最短的实时天气TTL为准，过期后切换城市至少有一项需要重新请求
+    return now - entry.issuedMs < qint64(WeatherService::CURRENT_WEATHER_TTL) * 1000;
+}
+
+void CityPrefetcher::expireEntries(qint64 now)
+{
+    bool changed = false;
+    for (auto it = m_entries.begin(); it != m_entries.end(); ) {
+        if (isFresh(*it, now)) {
+            ++it;
+            continue;
+        }
+        if (!it->viewed) {
+            m_stats.wasted++;
+            changed = true;
+        }
+        it = m_entries.erase(it);
+    }
+    
+    if (changed) {
+        emit statsChanged(m_stats);
+    }
+}
+
+bool CityPrefetcher::takeBudget(qint64 now)
+{
+    double perMs = double(MAX_CITIES_PER_MINUTE) / 60000.0;
+    m_tokens = qMin<double>(MAX_CITIES_PER_MINUTE, m_tokens + (now - m_lastRefillMs) * perMs);
+    m_lastRefillMs = now;
+    
+    if (m_tokens < 1.0) {
+        return false;
+    }
+    m_tokens -= 1.0;
+    return true;
+}
+
+void CityPrefetcher::saveRecentCities()
+{
+    ConfigManager::instance().setValue("prefetch/recentCities", m_recentCities);
+}
@@ -0,0 +1,133 @@
+/**
+ * @file cityprefetcher.h
+ * @brief 城市天气预测性预取
+ */
+
+#ifndef CITYPREFETCHER_H
+#define CITYPREFETCHER_H
+
+#include <QObject>
+#include <QHash>
+#include <QTimer>
+#include <QStringList>
+#include "../models/citymodel.h"
+
+/**
+ * @struct PrefetchStats
+ * @brief 预取统计
+ */
+struct PrefetchStats {
+    int issued = 0;     // 已预取的城市数
+    int hits = 0;       // 切换城市时缓存仍然有效的次数
+    int misses = 0;     // 切换城市时没有可用预取的次数
+    int wasted = 0;     // 预取后直到过期都未被查看的次数
+    int throttled = 0;  // 因预算不足被丢弃的预取次数
+    
+    double hitRate() const {
+        int total = hits + misses;
+        return total > 0 ? double(hits) / total : 0.0;
+    }
+};
+
+/**
+ * @class CityPrefetcher
+ * @brief 预测性预取器
+ * 
+ * 在用户真正切换城市之前预热天气缓存：
+ * - 鼠标悬停（短暂停留后）或单击列表中的城市
+ * - 启动时的前N个收藏城市
+ * - 最近查看过的城市
+ * 
+ * 预取使用低优先级任务，受每分钟预算限制；同一城市在缓存TTL内只预取一次。
+ */
+class CityPrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    static CityPrefetcher& instance();
+    
+    /**
+     * @brief 鼠标悬停在城市上，停留一段时间后才预取
+     * @param cityId 城市ID，为空表示离开列表
+     */
+    void hoverCity(const QString &cityId);
+    
+    /**
+     * @brief 立即预取城市（如单击选中）
+     * @param cityId 城市ID
+     * @return 是否实际发出了预取
+     */
+    bool prefetchCity(const QString &cityId);
+    
+    /**
+     * @brief 启动预热：前N个收藏城市和最近查看的城市
+     * 
+     * 收藏列表在数据库线程读取，读取完成后才发出预取
+     * @param topFavorites 收藏城市数量
+     */
+    void warmUp(int topFavorites = DEFAULT_TOP_FAVORITES);
+    
+    /**
+     * @brief 记录用户切换到某个城市，用于命中统计和最近查看列表
+     * @param cityId 城市ID
+     */
+    void recordCityViewed(const QString &cityId);
+    
+    /**
+     * @brief 获取最近查看的城市（最新的在前）
+     */
+    QStringList recentCities() const;
+    
+    /**
+     * @brief 获取预取统计
+     */
+    PrefetchStats stats();
+
+signals:
+    /**
+     * @brief 统计数据变化
+     */
+    void statsChanged(const PrefetchStats &stats);
+
+private slots:
+    void onHoverTimeout();
+
+private:
+    explicit CityPrefetcher(QObject *parent = nullptr);
+    ~CityPrefetcher() = default;
+    
+    CityPrefetcher(const CityPrefetcher&) = delete;
+    CityPrefetcher& operator=(const CityPrefetcher&) = delete;
+    
+    /**
+     * @struct PrefetchEntry
+     * @brief 单个城市的预取记录
+     */
+    struct PrefetchEntry {
+        qint64 issuedMs = 0;
+        bool viewed = false;
+    };
+    
+    void warmUp(const QList<CityInfo> &favorites, int topFavorites);
+    bool isFresh(const PrefetchEntry &entry, qint64 now) const;
+    void expireEntries(qint64 now);
+    bool takeBudget(qint64 now);
+    void saveRecentCities();
+
+private:
+    QTimer *m_hoverTimer;
+    QString m_hoverCityId;
+    QHash<QString, PrefetchEntry> m_entries;
+    QStringList m_recentCities;
+    PrefetchStats m_stats;
+    double m_tokens = MAX_CITIES_PER_MINUTE;
+    qint64 m_lastRefillMs = 0;
+    
+    static const int DEFAULT_TOP_FAVORITES = 3;
+    static const int MAX_RECENT_CITIES = 5;
+    static const int MAX_CITIES_PER_MINUTE = 8;   // 每个城市对应3个请求
+    static const int HOVER_DELAY_MS = 300;
+};
+
+#endif // CITYPREFETCHER_H
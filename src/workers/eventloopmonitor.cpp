@@ -0,0 +1,62 @@
+/**
+ * @file eventloopmonitor.cpp
+ * @brief 主线程事件循环阻塞监测实现
+ */
+
+#include "eventloopmonitor.h"
+#include <QDebug>
+
+EventLoopMonitor::EventLoopMonitor(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+{
+    m_timer->setTimerType(Qt::PreciseTimer);
+    m_timer->setInterval(TICK_INTERVAL_MS);
+    connect(m_timer, &QTimer::timeout, this, &EventLoopMonitor::onTick);
+}
+
+EventLoopMonitor& EventLoopMonitor::instance()
+{
+    static EventLoopMonitor instance;
+    return instance;
+}
+
+void EventLoopMonitor::start()
+{
+    if (m_timer->isActive()) {
+        return;
+    }
+    
+    m_stats = EventLoopStats();
+    m_clock.start();
+    m_lastTickMs = 0;
+    m_timer->start();
+}
+
+void EventLoopMonitor::stop()
+{
+    m_timer->stop();
+    qDebug() << "Event loop stalls:" << m_stats.stalls << "total" << m_stats.totalStallMs
+             << "ms, longest" << m_stats.maxStallMs << "ms";
+}
+
+EventLoopStats EventLoopMonitor::stats() const
+{
+    return m_stats;
+}
+
+void EventLoopMonitor::onTick()
+{
+    qint64 now = m_clock.elapsed();
+    qint64 stall = now - m_lastTickMs - TICK_INTERVAL_MS;
+    m_lastTickMs = now;
+    
+    if (stall < STALL_THRESHOLD_MS) {
+        return;
+    }
+    
+    m_stats.stalls++;
+    m_stats.totalStallMs += stall;
+    m_stats.maxStallMs = qMax(m_stats.maxStallMs, stall);
+    qDebug() << "GUI thread blocked for" << stall << "ms";
+}
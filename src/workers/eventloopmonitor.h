@@ -0,0 +1,64 @@
+/**
+ * @file eventloopmonitor.h
+ * @brief 主线程事件循环阻塞监测
+ */
+
+#ifndef EVENTLOOPMONITOR_H
+#define EVENTLOOPMONITOR_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+/**
+ * @struct EventLoopStats
+ * @brief 事件循环阻塞统计
+ */
+struct EventLoopStats {
+    int stalls = 0;             // 超过阈值的阻塞次数
+    qint64 totalStallMs = 0;    // 超过阈值的阻塞总时长
+    qint64 maxStallMs = 0;      // 最长一次阻塞
+};
+
+/**
+ * @class EventLoopMonitor
+ * @brief 测量主线程被阻塞的时间
+ * 
+ * 在主线程以固定间隔触发计时器，实际间隔超出预期的部分即事件循环无法处理事件的时间。
+ * 超过阈值的阻塞记入统计并输出日志，用于对比把数据库访问移出主线程前后的效果。
+ */
+class EventLoopMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    static EventLoopMonitor& instance();
+    
+    /**
+     * @brief 开始监测（须在主线程调用）
+     */
+    void start();
+    void stop();
+    
+    EventLoopStats stats() const;
+
+private slots:
+    void onTick();
+
+private:
+    explicit EventLoopMonitor(QObject *parent = nullptr);
+    ~EventLoopMonitor() = default;
+    
+    EventLoopMonitor(const EventLoopMonitor&) = delete;
+    EventLoopMonitor& operator=(const EventLoopMonitor&) = delete;
+    
+    QTimer *m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_lastTickMs = 0;
+    EventLoopStats m_stats;
+    
+    static const int TICK_INTERVAL_MS = 20;
+    static const int STALL_THRESHOLD_MS = 50;   // 超过该值用户可感知卡顿
+};
+
+#endif // EVENTLOOPMONITOR_H
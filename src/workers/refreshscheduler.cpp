@@ -0,0 +1,373 @@
+/**
+ * @file refreshscheduler.cpp
+ * @brief 收藏城市后台刷新调度器实现
+ */
+
+#include "refreshscheduler.h"
+#include "../config/configmanager.h"
+#include "../services/cityservice.h"
+#include "../services/asyncdataservice.h"
+#include "../services/weatherservice.h"
+#include <QGuiApplication>
+#include <QDateTime>
+#include <QRandomGenerator>
+#include <QEvent>
+#include <QDebug>
+#include <algorithm>
+#include <limits>
+
+RefreshScheduler::RefreshScheduler(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &RefreshScheduler::onTimeout);
+    
+    connect(&ConfigManager::instance(), &ConfigManager::configChanged,
+            this, &RefreshScheduler::onConfigChanged);
+    connect(&CityService::instance(), &CityService::favoriteChanged,
+            this, &RefreshScheduler::onFavoriteChanged);
+    connect(&CityService::instance(), &CityService::cityDeleted,
+            this, [this](const QString &cityId) {
+        m_schedules.remove(cityId);
+    });
+    
+    // 应用恢复到前台时，把被拉长的计划拉回正常间隔
+    connect(qGuiApp, &QGuiApplication::applicationStateChanged,
+            this, [this](Qt::ApplicationState state) {
+        if (state == Qt::ApplicationActive) {
+            pullInStretched();
+        }
+    });
+}
+
+RefreshScheduler& RefreshScheduler::instance()
+{
+    static RefreshScheduler instance;
+    return instance;
+}
+
+void RefreshScheduler::start()
+{
+    if (m_running) {
+        return;
+    }
+    
+    m_running = true;
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    m_lastInputMs = now;
+    m_lastRefillMs = now;
+    m_tokens = MAX_REQUESTS_PER_MINUTE;
+    
+    // 监听用户输入以判断是否空闲
+    qGuiApp->installEventFilter(this);
+    
+    reloadCities();
+}
+
+void RefreshScheduler::stop()
+{
+    m_running = false;
+    m_timer->stop();
+    qGuiApp->removeEventFilter(this);
+}
+
+bool RefreshScheduler::isRunning() const
+{
+    return m_running;
+}
+
+void RefreshScheduler::setCurrentCity(const QString &cityId)
+{
+    m_currentCityId = cityId;
+}
+
+void RefreshScheduler::setMinimized(bool minimized)
+{
+    if (m_minimized == minimized) {
+        return;
+    }
+    
+    m_minimized = minimized;
+    if (!minimized) {
+        pullInStretched();
+    }
+}
+
+void RefreshScheduler::reloadCities()
+{
+    // 收藏列表首次读取要访问数据库，放到数据库线程；只采用最后一次请求的结果
+    int request = ++m_reloadRequest;
+    AsyncDataService::instance().favorites().then(this, [this, request](const QList<CityInfo> &favorites) {
+        if (request == m_reloadRequest && m_running) {
+            applyFavorites(favorites);
+        }
+    });
+}
+
+void RefreshScheduler::applyFavorites(const QList<CityInfo> &favorites)
+{
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    
+    QHash<QString, CitySchedule> previous;
+    previous.swap(m_schedules);
+    
+    for (const CityInfo &city : favorites) {
+        if (previous.contains(city.cityId)) {
+            // 保留已有计划，避免重新加载时打乱相位
+            m_schedules.insert(city.cityId, previous.value(city.cityId));
+        } else {
+            addCity(city.cityId, now);
+        }
+    }
+    
+    qDebug() << "Refresh scheduler tracking" << m_schedules.size() << "favorite cities";
+    armTimer();
+}
+
+int RefreshScheduler::scheduledCityCount() const
+{
+    return m_schedules.size();
+}
+
+bool RefreshScheduler::eventFilter(QObject *watched, QEvent *event)
+{
+    switch (event->type()) {
+        case QEvent::KeyPress:
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseMove:
+        case QEvent::Wheel: {
+            qint64 now = QDateTime::currentMSecsSinceEpoch();
+            bool wasIdle = now - m_lastInputMs > IDLE_THRESHOLD_MS;
+            m_lastInputMs = now;
+            if (wasIdle) {
+                pullInStretched();
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void RefreshScheduler::onTimeout()
+{
+    if (!m_running) {
+        return;
+    }
+    
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    refillTokens(now);
+    
+    // 收集所有到期的刷新，按到期时间先后处理
+    struct DueItem {
+        qint64 due;
+        QString cityId;
+        int product;
+    };
+    QList<DueItem> dueItems;
+    for (auto it = m_schedules.cbegin(); it != m_schedules.cend(); ++it) {
+        for (int p = 0; p < PRODUCT_COUNT; ++p) {
+            if (it->nextDue[p] <= now) {
+                dueItems.append({it->nextDue[p], it.key(), p});
+            }
+        }
+    }
+    std::sort(dueItems.begin(), dueItems.end(), [](const DueItem &a, const DueItem &b) {
+        return a.due < b.due;
+    });
+    
+    // 令牌不足时剩余项保持到期状态，等待令牌补充
+    for (const DueItem &item : dueItems) {
+        if (m_tokens < 1.0) {
+            break;
+        }
+        m_tokens -= 1.0;
+        dispatch(item.cityId, item.product);
+        scheduleNext(m_schedules[item.cityId], item.product, now);
+    }
+    
+    armTimer();
+}
+
+void RefreshScheduler::onConfigChanged(const QString &key)
+{
+    if (key == "general/autoRefreshInterval") {
+        rescheduleAll();
+    }
+}
+
+void RefreshScheduler::onFavoriteChanged(const QString &cityId, bool isFavorite)
+{
+    if (isFavorite) {
+        if (!m_schedules.contains(cityId)) {
+            addCity(cityId, QDateTime::currentMSecsSinceEpoch());
+            armTimer();
+        }
+    } else {
+        m_schedules.remove(cityId);
+    }
+}
+
+WeatherTask::Type RefreshScheduler::productType(int product)
+{
+    switch (product) {
+        case 1: return WeatherTask::FetchHourly;
+        case 2: return WeatherTask::FetchDaily;
+        default: return WeatherTask::FetchCurrent;
+    }
+}
+
+int RefreshScheduler::productTtl(int product)
+{
+    switch (product) {
+        case 1: return WeatherService::HOURLY_FORECAST_TTL;
+        case 2: return WeatherService::DAILY_FORECAST_TTL;
+        default: return WeatherService::CURRENT_WEATHER_TTL;
+    }
+}
+
+qint64 RefreshScheduler::intervalMs(int product) const
+{
+    // 刷新间隔向上取整为TTL的整数倍，scheduleNext 再加上响应延迟的余量
+    qint64 base = qint64(ConfigManager::instance().autoRefreshInterval()) * 60;
+    qint64 ttl = productTtl(product);
+    qint64 periods = qMax<qint64>(1, (base + ttl - 1) / ttl);
+    return periods * ttl * 1000;
+}
+
+qint64 RefreshScheduler::phaseMs(const QString &cityId, qint64 interval) const
+{
+    // 基于城市ID的固定相位，分布在间隔的前10%内
+    qint64 window = qMax<qint64>(1, interval / 10);
+    return qint64(qHash(cityId) % quint64(window));
+}
+
+double RefreshScheduler::stretchFactor(qint64 now) const
+{
+    double factor = 1.0;
+    Qt::ApplicationState state = QGuiApplication::applicationState();
+    
+    if (m_minimized || state == Qt::ApplicationHidden || state == Qt::ApplicationSuspended) {
+        factor = 4.0;
+    } else if (state != Qt::ApplicationActive) {
+        factor = 2.0;
+    }
+    
+    if (now - m_lastInputMs > IDLE_THRESHOLD_MS) {
+        factor = qMax(factor, 2.0);
+    }
+    return factor;
+}
+
+void RefreshScheduler::addCity(const QString &cityId, qint64 now)
+{
+    CitySchedule schedule;
+    schedule.cityId = cityId;
+    
+    // 首次刷新按相位错开，避免启动时所有收藏城市同时请求
+    for (int p = 0; p < PRODUCT_COUNT; ++p) {
+        schedule.nextDue[p] = now + phaseMs(cityId, intervalMs(p));
+    }
+    m_schedules.insert(cityId, schedule);
+}
+
+void RefreshScheduler::scheduleNext(CitySchedule &schedule, int product, qint64 now)
+{
+    qint64 interval = qint64(intervalMs(product) * stretchFactor(now));
+    
+    // 每次追加 0~5% 的随机抖动，防止各城市逐渐同步。抖动只向后，
+    // 再加上余量：缓存条目在响应到达时才记时，按发出时间计算的下一次请求不能早于其过期
+    qint64 spread = qMax<qint64>(1, interval / 20);
+    qint64 jitter = QRandomGenerator::global()->bounded(spread);
+    
+    schedule.nextDue[product] = now + interval + jitter + CACHE_EXPIRY_MARGIN_MS;
+}
+
+void RefreshScheduler::rescheduleAll()
+{
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (auto it = m_schedules.begin(); it != m_schedules.end(); ++it) {
+        for (int p = 0; p < PRODUCT_COUNT; ++p) {
+            it->nextDue[p] = now + phaseMs(it.key(), intervalMs(p));
+        }
+    }
+    armTimer();
+}
+
+void RefreshScheduler::pullInStretched()
+{
+    // 恢复活跃后，超过正常间隔的计划收回到正常间隔内
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (auto it = m_schedules.begin(); it != m_schedules.end(); ++it) {
+        for (int p = 0; p < PRODUCT_COUNT; ++p) {
+            qint64 interval = intervalMs(p);
+            qint64 limit = now + interval + phaseMs(it.key(), interval);
+            if (it->nextDue[p] > limit) {
+                it->nextDue[p] = now + phaseMs(it.key(), interval);
+            }
+        }
+    }
+    armTimer();
+}
+
+void RefreshScheduler::refillTokens(qint64 now)
+{
+    double perMs = double(MAX_REQUESTS_PER_MINUTE) / 60000.0;
+    m_tokens = qMin<double>(MAX_REQUESTS_PER_MINUTE, m_tokens + (now - m_lastRefillMs) * perMs);
+    m_lastRefillMs = now;
+}
+
+void RefreshScheduler::dispatch(const QString &cityId, int product)
+{
+    WeatherThreadController &controller = WeatherThreadController::instance();
+    WeatherTask::Type type = productType(product);
+    
+    if (cityId == m_currentCityId) {
+        // 当前城市走正常请求，直接刷新界面
+        switch (type) {
+            case WeatherTask::FetchHourly:
+                controller.requestHourlyForecast(cityId);
+                break;
+            case WeatherTask::FetchDaily:
+                controller.requestDailyForecast(cityId);
+                break;
+            default:
+                controller.requestCurrentWeather(cityId);
+                break;
+        }
+    } else {
+        controller.requestPrefetch(cityId, type);
+    }
+    
+    emit refreshDispatched(cityId, static_cast<int>(type));
+}
+
+void RefreshScheduler::armTimer()
+{
+    if (!m_running || m_schedules.isEmpty()
+        || ConfigManager::instance().autoRefreshInterval() <= 0) {
+        m_timer->stop();
+        return;
+    }
+    
+    qint64 earliest = std::numeric_limits<qint64>::max();
+    for (const CitySchedule &schedule : std::as_const(m_schedules)) {
+        for (int p = 0; p < PRODUCT_COUNT; ++p) {
+            earliest = qMin(earliest, schedule.nextDue[p]);
+        }
+    }
+    
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    qint64 delay = earliest - now;
+    
+    // 令牌耗尽时等待下一个令牌
+    if (m_tokens < 1.0) {
+        double perMs = double(MAX_REQUESTS_PER_MINUTE) / 60000.0;
+        delay = qMax(delay, qint64((1.0 - m_tokens) / perMs));
+    }
+    
+    delay = qBound<qint64>(MIN_TIMER_MS, delay, std::numeric_limits<int>::max());
+    m_timer->start(int(delay));
+}
@@ -0,0 +1,140 @@
+/**
+ * @file refreshscheduler.h
+ * @brief 收藏城市后台刷新调度器
+ */
+
+#ifndef REFRESHSCHEDULER_H
+#define REFRESHSCHEDULER_H
+
+#include <QObject>
+#include <QHash>
+#include <QTimer>
+#include "weatherworker.h"
+#include "../models/citymodel.h"
+
+/**
+ * @class RefreshScheduler
+ * @brief 后台自动刷新调度器
+ * 
+ * 按 autoRefreshInterval 定期刷新所有收藏城市：
+ * - 刷新间隔向上取整到各类数据的缓存TTL并留出余量，保证每次刷新都发生在缓存过期之后
+ * - 每个城市带固定相位偏移和随机抖动，避免请求集中触发
+ * - 窗口最小化、失去焦点或长时间无操作时拉长间隔
+ * - 令牌桶限制每分钟请求数，保证上游流量平滑有界
+ */
+class RefreshScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static RefreshScheduler& instance();
+    
+    /**
+     * @brief 启动调度（加载收藏城市并开始计时）
+     */
+    void start();
+    
+    /**
+     * @brief 停止调度
+     */
+    void stop();
+    
+    /**
+     * @brief 调度是否正在运行
+     */
+    bool isRunning() const;
+    
+    /**
+     * @brief 设置当前显示的城市
+     * 
+     * 当前城市使用正常请求以更新界面，其余城市只做后台预取
+     * @param cityId 城市ID
+     */
+    void setCurrentCity(const QString &cityId);
+    
+    /**
+     * @brief 设置主窗口是否最小化
+     * @param minimized 是否最小化
+     */
+    void setMinimized(bool minimized);
+    
+    /**
+     * @brief 重新加载收藏城市列表
+     * 
+     * 在数据库线程读取，结果返回主线程后更新计划
+     */
+    void reloadCities();
+    
+    /**
+     * @brief 获取参与调度的城市数量
+     */
+    int scheduledCityCount() const;
+
+signals:
+    /**
+     * @brief 已发出一次后台刷新
+     * @param cityId 城市ID
+     * @param type 数据类型(WeatherTask::Type)
+     */
+    void refreshDispatched(const QString &cityId, int type);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void onTimeout();
+    void onConfigChanged(const QString &key);
+    void onFavoriteChanged(const QString &cityId, bool isFavorite);
+
+private:
+    explicit RefreshScheduler(QObject *parent = nullptr);
+    ~RefreshScheduler() = default;
+    
+    RefreshScheduler(const RefreshScheduler&) = delete;
+    RefreshScheduler& operator=(const RefreshScheduler&) = delete;
+    
+    // 参与调度的数据类型：实时天气、逐小时预报、每日预报
+    static const int PRODUCT_COUNT = 3;
+    
+    /**
+     * @struct CitySchedule
+     * @brief 单个城市的刷新计划
+     */
+    struct CitySchedule {
+        QString cityId;
+        qint64 nextDue[PRODUCT_COUNT] = {0, 0, 0};  // 下次刷新时间(毫秒时间戳)
+    };
+    
+    static WeatherTask::Type productType(int product);
+    static int productTtl(int product);
+    
+    qint64 intervalMs(int product) const;
+    qint64 phaseMs(const QString &cityId, qint64 interval) const;
+    double stretchFactor(qint64 now) const;
+    void applyFavorites(const QList<CityInfo> &favorites);
+    void addCity(const QString &cityId, qint64 now);
+    void scheduleNext(CitySchedule &schedule, int product, qint64 now);
+    void rescheduleAll();
+    void pullInStretched();
+    void refillTokens(qint64 now);
+    void dispatch(const QString &cityId, int product);
+    void armTimer();
+
+private:
+    QTimer *m_timer;
+    QHash<QString, CitySchedule> m_schedules;
+    QString m_currentCityId;
+    bool m_running = false;
+    bool m_minimized = false;
+    qint64 m_lastInputMs = 0;
+    double m_tokens = 0;
+    qint64 m_lastRefillMs = 0;
+    int m_reloadRequest = 0;
+    
+    static const int MAX_REQUESTS_PER_MINUTE = 12;
+    static const int IDLE_THRESHOLD_MS = 600000;  // 10分钟无操作视为空闲
+    static const int MIN_TIMER_MS = 1000;
+    static const int CACHE_EXPIRY_MARGIN_MS = 5000;  // 超过TTL的余量，覆盖请求往返时间
+};
+
+#endif // REFRESHSCHEDULER_H
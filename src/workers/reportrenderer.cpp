@@ -0,0 +1,314 @@
+/**
+ * @file reportrenderer.cpp
+ * @brief 无界面批量渲染天气报表图表实现
+ */
+
+#include "reportrenderer.h"
+#include "../database/databasemanager.h"
+#include "../services/cityservice.h"
+#include "../services/citydirectory.h"
+#include "../services/weatherstore.h"
+#include <QtCharts/QChart>
+#include <QtCharts/QLineSeries>
+#include <QtCharts/QValueAxis>
+#include <QtCharts/QDateTimeAxis>
+#include <QGraphicsScene>
+#include <QGraphicsLayout>
+#include <QSvgGenerator>
+#include <QPainter>
+#include <QImage>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QCommandLineParser>
+#include <QtConcurrent>
+#include <QDebug>
+#include <cstring>
+
+ReportRenderer::ReportRenderer(const ReportOptions &options)
+    : m_options(options)
+{
+    if (m_options.threads > 0) {
+        m_pool.setMaxThreadCount(m_options.threads);
+    }
+}
+
+ReportResult ReportRenderer::render()
+{
+    ReportResult result;
+    QElapsedTimer timer;
+    timer.start();
+    
+    QStringList cityIds = m_options.cityIds;
+    if (cityIds.isEmpty()) {
+        for (const CityInfo &city : CityDirectory::instance().favorites()) {
+            cityIds.append(city.cityId);
+        }
+    }
+    result.cities = cityIds.size();
+    
+    if (!QDir().mkpath(m_options.outputDir)) {
+        qWarning() << "Failed to create report directory:" << m_options.outputDir;
+        result.failed = cityIds.size();
+        return result;
+    }
+    const bool svg = m_options.format == "svg";
+    
+    // 排队的任务数有上限，超过时先等最早的完成
+    const int maxQueued = qMax(1, m_pool.maxThreadCount()) * QUEUED_TASKS_PER_THREAD;
+    QList<QFuture<ReportResult>> queued;
+    auto collect = [&result](QFuture<ReportResult> &future) {
+        const ReportResult done = future.result();
+        result.images += done.images;
+        result.failed += done.failed;
+    };
+    
+    QList<CityReport> task;
+    auto submit = [&]() {
+        if (task.isEmpty()) {
+            return;
+        }
+        queued.append(QtConcurrent::run(&m_pool, &ReportRenderer::renderCities,
+                                        task, m_options.outputDir, svg, m_options.size));
+        task.clear();
+        if (queued.size() >= maxQueued) {
+            collect(queued.first());
+            queued.removeFirst();
+        }
+    };
+    
+    for (int start = 0; start < cityIds.size(); start += SNAPSHOT_BATCH) {
+        const QStringList batch = cityIds.mid(start, SNAPSHOT_BATCH);
+        // 不经过快照缓存，内存只与批大小有关
+        const QHash<QString, WeatherSnapshot> snapshots = WeatherStore::instance().readSnapshots(batch);
+        
+        for (const QString &cityId : batch) {
+            const QList<HourlyForecast> hourly = snapshots.value(cityId).hourly;
+            if (hourly.isEmpty()) {
+                ++result.skipped;
+                continue;
+            }
+            // 城市名在主线程查好，工作线程只接触自己的图表
+            task.append({cityId, CityDirectory::instance().cityName(cityId), hourly});
+            if (task.size() >= CITIES_PER_TASK) {
+                submit();
+            }
+        }
+    }
+    submit();
+    
+    for (QFuture<ReportResult> &future : queued) {
+        collect(future);
+    }
+    
+    result.elapsedMs = timer.elapsed();
+    result.imagesPerSecond = result.images * 1000.0 / qMax<qint64>(1, result.elapsedMs);
+    return result;
+}
+
+ReportResult ReportRenderer::renderCities(const QList<CityReport> &reports, const QString &outputDir,
+                                          bool svg, const QSize &size)
+{
+    ReportResult result;
+    const QDir dir(outputDir);
+    
+    // 场景和图表属于本任务，在工作线程中创建和销毁，线程之间不共享；
+    // 每个指标一个图表，组内的城市之间只替换数据
+    const QList<Metric> metrics = {Temperature, Humidity, WindSpeed};
+    QGraphicsScene scene;
+    QList<QChart*> charts;
+    QList<QLineSeries*> series;
+    QList<QDateTimeAxis*> axesX;
+    QList<QValueAxis*> axesY;
+    for (int i = 0; i < metrics.size(); ++i) {
+        const Metric metric = metrics[i];
+        
+        // 各图表在场景中纵向排开，绘制时按各自的区域截取
+        QChart *chart = new QChart();
+        chart->setAnimationOptions(QChart::NoAnimation);
+        chart->legend()->setAlignment(Qt::AlignBottom);
+        chart->resize(size);
+        chart->setPos(0, i * size.height());
+        scene.addItem(chart);
+        
+        QLineSeries *line = new QLineSeries();
+        line->setName(metricTitle(metric));
+        chart->addSeries(line);
+        
+        QDateTimeAxis *axisX = new QDateTimeAxis();
+        axisX->setFormat("HH:mm");
+        axisX->setTitleText(QObject::tr("时间"));
+        chart->addAxis(axisX, Qt::AlignBottom);
+        line->attachAxis(axisX);
+        
+        QValueAxis *axisY = new QValueAxis();
+        axisY->setTitleText(axisTitle(metric));
+        chart->addAxis(axisY, Qt::AlignLeft);
+        line->attachAxis(axisY);
+        
+        charts.append(chart);
+        series.append(line);
+        axesX.append(axisX);
+        axesY.append(axisY);
+    }
+    
+    for (const CityReport &report : reports) {
+        const QList<HourlyForecast> &hourly = report.hourly;
+        
+        for (int i = 0; i < metrics.size(); ++i) {
+            const Metric metric = metrics[i];
+            QList<QPointF> points;
+            points.reserve(hourly.size());
+            qreal minValue = value(hourly.first(), metric);
+            qreal maxValue = minValue;
+            for (const HourlyForecast &h : hourly) {
+                qreal v = value(h, metric);
+                points.append(QPointF(h.time.toMSecsSinceEpoch(), v));
+                minValue = qMin(minValue, v);
+                maxValue = qMax(maxValue, v);
+            }
+            
+            series[i]->replace(points);
+            axesX[i]->setRange(hourly.first().time, hourly.last().time);
+            switch (metric) {
+                case Temperature:
+                    axesY[i]->setRange(minValue - 2, maxValue + 2);
+                    break;
+                case Humidity:
+                    axesY[i]->setRange(0, 100);
+                    break;
+                case WindSpeed:
+                    axesY[i]->setRange(0, maxValue + 5);
+                    break;
+            }
+            charts[i]->setTitle(QObject::tr("%1 24小时%2").arg(report.cityName, metricTitle(metric)));
+            charts[i]->layout()->activate();
+            
+            const QString path = dir.filePath(
+                QString("%1_%2.%3").arg(report.cityId, metricKey(metric), svg ? "svg" : "png"));
+            const QRectF source = charts[i]->sceneBoundingRect();
+            
+            bool ok = false;
+            if (svg) {
+                QSvgGenerator generator;
+                generator.setFileName(path);
+                generator.setSize(size);
+                generator.setViewBox(QRect(QPoint(0, 0), size));
+                generator.setTitle(charts[i]->title());
+                QPainter painter;
+                if (painter.begin(&generator)) {
+                    scene.render(&painter, QRectF(QPointF(0, 0), size), source);
+                    ok = painter.end();
+                }
+            } else {
+                QImage image(size, QImage::Format_ARGB32_Premultiplied);
+                image.fill(Qt::white);
+                QPainter painter(&image);
+                painter.setRenderHint(QPainter::Antialiasing);
+                scene.render(&painter, QRectF(QPointF(0, 0), size), source);
+                painter.end();
+                ok = image.save(path, "PNG");
+            }
+            
+            if (ok) {
+                ++result.images;
+            } else {
+                ++result.failed;
+            }
+        }
+    }
+    return result;
+}
+
+bool ReportRenderer::isRequested(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--render-reports") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int ReportRenderer::run(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QObject::tr("批量生成城市天气报表图表"));
+    parser.addHelpOption();
+    parser.addOption({"render-reports", QObject::tr("不显示界面，渲染报表后退出")});
+    parser.addOption({"cities", QObject::tr("逗号分隔的城市ID，默认为所有收藏城市"), "ids"});
+    parser.addOption({"output", QObject::tr("输出目录"), "dir", "reports"});
+    parser.addOption({"format", QObject::tr("图片格式：png 或 svg"), "format", "png"});
+    parser.addOption({"size", QObject::tr("图片尺寸，如 1200x600"), "size", "1200x600"});
+    parser.addOption({"threads", QObject::tr("渲染线程数，默认按 CPU 核数"), "count", "0"});
+    parser.process(arguments);
+    
+    ReportOptions options;
+    if (parser.isSet("cities")) {
+        options.cityIds = parser.value("cities").split(',', Qt::SkipEmptyParts);
+    }
+    options.outputDir = parser.value("output");
+    options.format = parser.value("format").toLower();
+    options.threads = parser.value("threads").toInt();
+    
+    QStringList size = parser.value("size").split('x');
+    if (size.size() == 2 && size[0].toInt() > 0 && size[1].toInt() > 0) {
+        options.size = QSize(size[0].toInt(), size[1].toInt());
+    }
+    
+    QTextStream out(stdout);
+    if (options.format != "png" && options.format != "svg") {
+        out << "Unsupported format: " << options.format << Qt::endl;
+        return 1;
+    }
+    
+    if (!DatabaseManager::instance().initialize()) {
+        out << "Failed to open database" << Qt::endl;
+        return 1;
+    }
+    
+    ReportRenderer renderer(options);
+    ReportResult result = renderer.render();
+    
+    out << QString("Rendered %1 images for %2 cities in %3 ms (%4 images/s), %5 failed, %6 cities without data")
+               .arg(result.images).arg(result.cities).arg(result.elapsedMs)
+               .arg(result.imagesPerSecond, 0, 'f', 1).arg(result.failed).arg(result.skipped)
+        << Qt::endl;
+    return result.failed > 0 ? 1 : 0;
+}
+
+QString ReportRenderer::metricKey(Metric metric)
+{
+    switch (metric) {
+        case Temperature: return "temperature";
+        case Humidity: return "humidity";
+        default: return "wind_speed";
+    }
+}
+
+QString ReportRenderer::metricTitle(Metric metric)
+{
+    switch (metric) {
+        case Temperature: return QObject::tr("温度");
+        case Humidity: return QObject::tr("湿度");
+        default: return QObject::tr("风速");
+    }
+}
+
+QString ReportRenderer::axisTitle(Metric metric)
+{
+    switch (metric) {
+        case Temperature: return QObject::tr("温度 (°C)");
+        case Humidity: return QObject::tr("湿度 (%)");
+        default: return QObject::tr("风速 (km/h)");
+    }
+}
+
+qreal ReportRenderer::value(const HourlyForecast &h, Metric metric)
+{
+    switch (metric) {
+        case Temperature: return h.temperature;
+        case Humidity: return h.humidity;
+        default: return h.windSpeed;
+    }
+}
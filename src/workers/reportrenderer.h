@@ -0,0 +1,114 @@
+/**
+ * @file reportrenderer.h
+ * @brief 无界面批量渲染天气报表图表
+ */
+
+#ifndef REPORTRENDERER_H
+#define REPORTRENDERER_H
+
+#include <QString>
+#include <QStringList>
+#include <QSize>
+#include <QThreadPool>
+#include "../models/weatherdata.h"
+
+/**
+ * @struct ReportOptions
+ * @brief 报表渲染参数
+ */
+struct ReportOptions {
+    QStringList cityIds;            // 为空时渲染所有收藏城市
+    QString outputDir = "reports";
+    QString format = "png";         // png 或 svg
+    QSize size = QSize(1200, 600);
+    int threads = 0;                // 渲染线程数，0 表示按 CPU 核数
+};
+
+/**
+ * @struct ReportResult
+ * @brief 报表渲染结果
+ */
+struct ReportResult {
+    int cities = 0;
+    int images = 0;                 // 成功写入的图片数
+    int failed = 0;
+    int skipped = 0;                // 没有预报数据而跳过的城市数
+    qint64 elapsedMs = 0;
+    double imagesPerSecond = 0;
+};
+
+/**
+ * @class ReportRenderer
+ * @brief 离屏生成每个城市的温度、湿度、风速图表
+ * 
+ * 与 ChartWidget 的24小时图表相同的样式，不创建任何窗口：
+ * - 主线程按 SNAPSHOT_BATCH 个城市一批读取天气快照（不放入 WeatherStore 的缓存），
+ *   每 CITIES_PER_TASK 个城市打包成一个任务交给线程池
+ * - 每个任务在工作线程中创建自己的 QGraphicsScene 和各指标的 QChart，
+ *   逐个城市用 replace 更新数据后绘制到 QImage 或 QSvgGenerator 并写入文件，
+ *   绘制、编码和写文件都在工作线程并行执行
+ * - 排队的任务数有上限，内存占用不随城市数增长
+ * 
+ * 由 main 在命令行带 --render-reports 时调用，此时使用 offscreen 平台插件。
+ */
+class ReportRenderer
+{
+public:
+    explicit ReportRenderer(const ReportOptions &options);
+    
+    /**
+     * @brief 渲染所有城市，阻塞直到全部图片写完
+     */
+    ReportResult render();
+    
+    /**
+     * @brief 命令行是否要求渲染报表
+     */
+    static bool isRequested(int argc, char *argv[]);
+    
+    /**
+     * @brief 解析命令行、初始化数据库并渲染报表
+     * 
+     * 用法：--render-reports [--cities id1,id2,...] [--output 目录] [--format png|svg] [--size 1200x600] [--threads N]
+     * @return 进程退出码
+     */
+    static int run(const QStringList &arguments);
+
+private:
+    enum Metric {
+        Temperature,
+        Humidity,
+        WindSpeed
+    };
+    
+    /**
+     * @struct CityReport
+     * @brief 一个城市的渲染输入，在主线程准备好后交给工作线程
+     */
+    struct CityReport {
+        QString cityId;
+        QString cityName;
+        QList<HourlyForecast> hourly;
+    };
+    
+    /**
+     * @brief 在当前线程中创建图表并渲染一组城市
+     * @return 该组的图片数和失败数
+     */
+    static ReportResult renderCities(const QList<CityReport> &reports, const QString &outputDir,
+                                     bool svg, const QSize &size);
+    
+    static QString metricKey(Metric metric);
+    static QString metricTitle(Metric metric);
+    static QString axisTitle(Metric metric);
+    static qreal value(const HourlyForecast &h, Metric metric);
+    
+    ReportOptions m_options;
+    QThreadPool m_pool;
+    
+    static const int SNAPSHOT_BATCH = 100;
+    static const int CITIES_PER_TASK = 10;
+    static const int QUEUED_TASKS_PER_THREAD = 2;
+};
+
+#endif // REPORTRENDERER_H
@@ -23,7 +23,11 @@ WeatherWorker::~WeatherWorker()
 void WeatherWorker::addTask(const WeatherTask &task)
 {
     QMutexLocker locker(&m_mutex);
-    m_taskQueue.enqueue(task);
+    if (task.prefetch) {
+        m_prefetchQueue.enqueue(task);
+    } else {
+        m_taskQueue.enqueue(task);
+    }
     
     if (!m_processing) {
         QMetaObject::invokeMethod(this, "processQueue", Qt::QueuedConnection);
@@ -34,6 +38,7 @@ void WeatherWorker::clearTasks()
 {
     QMutexLocker locker(&m_mutex);
     m_taskQueue.clear();
+    m_prefetchQueue.clear();
 }
 
 int WeatherWorker::pendingTaskCount() const
@@ -42,18 +47,25 @@ int WeatherWorker::pendingTaskCount() const
     return m_taskQueue.size();
 }
 
+int WeatherWorker::pendingPrefetchCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_prefetchQueue.size();
+}
+
 void WeatherWorker::processQueue()
 {
     WeatherTask task;
     
     {
         QMutexLocker locker(&m_mutex);
-        if (m_taskQueue.isEmpty()) {
+        if (m_taskQueue.isEmpty() && m_prefetchQueue.isEmpty()) {
             m_processing = false;
             return;
         }
         m_processing = true;
-        task = m_taskQueue.dequeue();
+        // 用户请求优先，预取任务只在普通队列为空时处理
+        task = !m_taskQueue.isEmpty() ? m_taskQueue.dequeue() : m_prefetchQueue.dequeue();
     }
     
     processTask(task);
@@ -64,6 +76,11 @@ void WeatherWorker::processQueue()
 
 void WeatherWorker::processTask(const WeatherTask &task)
 {
+    if (task.prefetch) {
+        processPrefetchTask(task);
+        return;
+    }
+    
     emit taskStarted(task.cityId, task.type);
     
     WeatherService &service = WeatherService::instance();
@@ -132,6 +149,26 @@ void WeatherWorker::processTask(const WeatherTask &task)
     }
 }
 
+void WeatherWorker::processPrefetchTask(const WeatherTask &task)
+{
+    // 预取任务不发出 taskStarted/taskFinished，避免干扰批量请求计数
+    WeatherService &service = WeatherService::instance();
+    
+    switch (task.type) {
+        case WeatherTask::FetchCurrent:
+            service.prefetchCurrentWeather(task.cityId);
+            break;
+        case WeatherTask::FetchHourly:
+            service.prefetchHourlyForecast(task.cityId, task.param > 0 ? task.param : 24);
+            break;
+        case WeatherTask::FetchDaily:
+            service.prefetchDailyForecast(task.cityId, task.param > 0 ? task.param : 7);
+            break;
+        default:
+            break;
+    }
+}
+
 void WeatherWorker::cleanExpiredCache()
 {
     int removed = NetworkManager::instance().cleanExpiredCache();
@@ -251,6 +288,15 @@ void WeatherThreadController::requestAllWeatherData(const QString &cityId)
     requestWeatherAlert(cityId);
 }
 
+void WeatherThreadController::requestPrefetch(const QString &cityId, WeatherTask::Type type)
+{
+    WeatherTask task;
+    task.type = type;
+    task.cityId = cityId;
+    task.prefetch = true;
+    m_worker->addTask(task);
+}
+
 void WeatherThreadController::startCacheCleanTimer(int intervalMs)
 {
     m_cacheCleanTimer->start(intervalMs);
@@ -31,6 +31,7 @@ struct WeatherTask {
     Type type;
     QString cityId;
     int param = 0;  // hours/days
+    bool prefetch = false;  // 后台预取，只预热缓存不更新界面
 };
 
 /**
@@ -49,6 +50,8 @@ public:
     
     /**
      * @brief 添加任务到队列
+     * 
+     * 预取任务进入低优先级队列，只在普通队列为空时处理
      */
     void addTask(const WeatherTask &task);
     
@@ -61,6 +64,11 @@ public:
      * @brief 获取队列中的任务数量
      */
     int pendingTaskCount() const;
+    
+    /**
+     * @brief 获取低优先级队列中的预取任务数量
+     */
+    int pendingPrefetchCount() const;
 
 public slots:
     /**
@@ -86,8 +94,10 @@ signals:
 
 private:
     void processTask(const WeatherTask &task);
+    void processPrefetchTask(const WeatherTask &task);
     
     QQueue<WeatherTask> m_taskQueue;
+    QQueue<WeatherTask> m_prefetchQueue;
     mutable QMutex m_mutex;
     bool m_processing = false;
 };
@@ -135,6 +145,13 @@ public:
      */
     void requestAllWeatherData(const QString &cityId);
     
+    /**
+     * @brief 后台预取指定类型的数据（只预热缓存）
+     * @param cityId 城市ID
+     * @param type 数据类型，仅支持 FetchCurrent/FetchHourly/FetchDaily
+     */
+    void requestPrefetch(const QString &cityId, WeatherTask::Type type);
+    
     /**
      * @brief 启动定时缓存清理
      */